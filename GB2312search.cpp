@@ -145,18 +145,22 @@ void test3() {
 void test4() {
     printf("*********** Test4: word match test : input mixed pinyin string (no space) *****************\n");
     printf("===================    enter \"exit()\" to exit  ====================================\n");
-    /* this is a simple code for declare the storge structure of __word_block_t */
+    /* the candidates are stored in a flat list : each record refers to a piece of list.text */
+    static __zh_cand_list_t list;
     while (1) {
         string input_str;
         std::getline(std::cin, input_str);
         if (input_str == "exit()") break;
 
         __split_method_t sp;
-        uint16_t idx = 0;
         
         uint32_t start_time = clock();
-        __word_block_t* blk = zh_match_word(input_str.c_str(), &sp);
+        uint8_t res = zh_match_cand(input_str.c_str(), &sp, &list);
         uint32_t end_time = clock();
+        if (res) {
+            printf("no match found\n");
+            continue;
+        }
 
         uint8_t loc = 0;
         for (int i = 0; i < strlen(input_str.c_str()); i++) {
@@ -168,28 +172,13 @@ void test4() {
         }
         cout << endl;
         char code_str[3 * MAX_WORD_LENGTH + 1];
-        for (__word_block_t* w = blk; w != NULL; w = w->next) {
-            if (w->type == WORD_BLK_TYPE_CODES) {
-                for (int i = 0; i < w->num.code_nbr; i++) {
-                    idx++;
-                    strncpy(code_str, w->buf + 3 * i, 3);
-                    code_str[3] = '\0';
-                    printf("%d : %s ", idx, Utf8ToGbk(code_str).c_str());
-                }
-            }
-            else { /* WORD_BLK_TYPE_WORDS */
-                uint16_t buf_idx = 0;
-                for (int i = 0; w->num.word_nbr[i] != 0; i++) {
-                    idx++;
-                    strncpy(code_str, w->buf + buf_idx, 3 * w->num.word_nbr[i]);
-                    buf_idx += 3 * w->num.word_nbr[i];
-                    code_str[3 * w->num.word_nbr[i]] = '\0';
-                    printf("%d : %s ", idx, Utf8ToGbk(code_str).c_str());
-                }
-            }
+        for (int i = 0; i < list.num; i++) {
+            const __zh_cand_t* c = &list.cand[i];
+            memcpy(code_str, list.text + c->utf8_offset, c->utf8_len);
+            code_str[c->utf8_len] = '\0';
+            printf("%d : %s ", i + 1, Utf8ToGbk(code_str).c_str());
         }
         printf("\n");
-        zh_word_free_match(blk);
         printf("match word take time : %d ms\n", end_time - start_time);
     }
 }
@@ -211,6 +200,42 @@ void zh_code_table_test()
 }
 
 int main() {
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+    zh_code_table_load();     /* (optional) keep code table in RAM, avoid file reading for each match */
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+    zh_word_trie_load();      /* (optional) keep key trie in RAM, only matched records are read */
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+    zh_word_abbr_load();      /* (optional) keep initials index in RAM, allow abbreviated input like "nhsj" */
+#endif
+#if (USE_ZH_VAGUE_TABLE == 1)
+    zh_vague_table_load();    /* (optional) keep precomputed vague match results in RAM */
+#endif
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+    zh_char_id_load();        /* (optional) keep 16-bit character id code table in RAM (smaller than zh_code_table_load) */
+#endif
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+    zh_word_json_index_load();  /* (optional) keep sparse key index of json dictionary in RAM, otherwise json file is binary searched */
+#endif
     zh_code_table_test();
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+    zh_code_table_unload();
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+    zh_word_trie_unload();
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+    zh_word_abbr_unload();
+#endif
+#if (USE_ZH_VAGUE_TABLE == 1)
+    zh_vague_table_unload();
+#endif
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+    zh_char_id_unload();
+#endif
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+    zh_word_json_index_unload();
+#endif
     return 0;
 }
@@ -0,0 +1,558 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_bench.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : latency benchmark of the public decoder functions
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_bench [-n rounds] [-w warmup] [-f json|csv] [-o output] [-i inputs] [-l] [-c] [-s storage] [-k lru|clock] [-b budget] [-r]
+ *   -n  measured rounds over the input set (default 20)
+ *   -w  warmup rounds, not measured (default 2)
+ *   -f  output format, json (default) or csv
+ *   -o  output file (default stdout)
+ *   -i  input file for split and word match (one pinyin string per line),
+ *       the built-in input set is used by default
+ *   -l  load resident tables (zh_code_table_load, zh_word_trie_load,
+ *       zh_word_abbr_load, zh_word_bound_load, zh_vague_table_load,
+ *       zh_char_id_load, zh_word_json_index_load) first
+ *   -c  keep the result cache between calls (USE_ZH_RESULT_CACHE), by default
+ *       it's cleared before every call so that the uncached path is measured
+ *   -s  storage backend of files : stdio (default), mmap, ram (files are read
+ *       into RAM blobs first), flash (simulated slow flash over stdio) or
+ *       embed (files linked into binary, default when USE_ZH_EMBED_TABLES)
+ *   -k  read the storage through block cache (USE_ZH_STORAGE_CACHE) with
+ *       eviction policy lru or clock
+ *   -b  RAM budget of block cache in bytes (default 16384)
+ *   -r  run the regression checks of word match instead of benchmark (words
+ *       that must or must not be found for an input, also with a word boosted by
+ *       user dictionary), exit code is 1 if any check fails
+ *
+ * every call is timed by a monotonic nanosecond timer, and p50/p90/p99/max
+ * latency and throughput are reported for each function, with the block hit
+ * ratio of storage cache and the bytes fetched from storage per call (bytes
+ * from the backend under the cache when -k is given, reads of mapped files
+ * are not counted). code match uses
+ * all the syllables in code table as input. run it in the project root
+ * directory (or the build directory the bin folder is copied to).
+ *****************************************************************************
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L     /* clock_gettime */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../zh_pinyin_decoder/zh_pinyin_decoder.h"
+#include "../zh_pinyin_decoder/zh_code_table.h"
+#include "../zh_pinyin_decoder/zh_storage_cache.h"
+#include "../zh_pinyin_decoder/zh_user_dict.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_MAX_INPUTS        4096
+#define BENCH_MAX_INPUT_LEN     (ZH_MAX_STRING_LENGTH + 1)
+
+/* built-in input set for split and word match (words, abbreviations, partial input) */
+static const char* bench_default_inputs[] = {
+    "nihao", "zhongguo", "women", "shijie", "xianzai", "jintian", "mingtian", "dianhua",
+    "diannao", "shouji", "xuexiao", "laoshi", "pengyou", "gongzuo", "shenghuo", "wenti",
+    "zhongguoren", "beijingshi", "shanghai", "changjiang", "xian", "xiang", "xianggang",
+    "zhuangzhuang", "chuangxin", "shuangfang", "jiangsusheng", "guangzhou", "baojialiya",
+    "nh", "nhsj", "zg", "wmd", "jt", "xs", "bjdx", "gljy", "sfw", "jgx",
+    "n", "zh", "zhon", "zhongg", "zhonggu", "shij", "xianz", "jint", "diann", "gongz",
+    "woaini", "wohenhao", "tianqi", "kaixin", "yinyue", "dianying", "chachu", "lichen",
+    "shexia", "jianhuan", "yufuf", "qiwu", "dikangl", "guoduq", "putonggu", "haiw",
+};
+
+/* regression check of word match : all the words (utf-8) must be found (or not found) for input */
+typedef struct {
+    const char* input;
+    uint8_t     found;              /* 1: words must be found, 0: words must not be found */
+    const char* words[4];           /* NULL terminated when less than 4 */
+}bench_check_t;
+
+static const bench_check_t bench_checks[] = {
+    /* a piece like "xi" is also a precise syllable, the vague split must not be filtered by the precise one */
+    { "xichen",  1, { "\xe4\xb8\x8b\xe6\xb2\x89", "\xe7\x9b\xb8\xe7\xa7\xb0", "\xe5\xb0\x8f\xe9\x99\x88", "\xe6\x98\x9f\xe8\xbe\xb0" } },  /* 下沉 相称 小陈 星辰 */
+    { "zhash",   1, { "\xe6\x89\x8e\xe5\xae\x9e", "\xe6\x88\x98\xe8\x83\x9c", "\xe5\xb1\x95\xe7\xa4\xba", "\xe6\x8e\x8c\xe5\xa3\xb0" } },  /* 扎实 战胜 展示 掌声 */
+    { "bizh",    1, { "\xe6\xaf\x94\xe7\x85\xa7", "\xe7\xbc\x96\xe8\x80\x85", "\xe8\xbe\xa9\xe8\xaf\x81", "\xe8\xb4\xac\xe5\x80\xbc" } },  /* 比照 编者 辩证 贬值 */
+    { "qicheng", 1, { "\xe5\x90\xaf\xe7\xa8\x8b", "\xe8\x84\x90\xe6\xa9\x99", "\xe5\x89\x8d\xe7\xa8\x8b", NULL } },                        /* 启程 脐橙 前程 */
+    /* input splits fully into syllables is not abbreviated, "a" or "n" is not taken as initial (with -l) */
+    { "cha",     0, { "\xe9\x95\xbf\xe5\xae\x89", "\xe5\xb0\x98\xe5\x9f\x83", "\xe5\xae\xa0\xe7\x88\xb1", NULL } },                        /* 长安 尘埃 宠爱 */
+    { "ben",     0, { "\xe6\x9c\xac\xe8\x83\xbd", NULL } },                                                                                /* 本能 */
+    { "bin",     0, { "\xe9\x81\xbf\xe9\x9a\xbe", "\xe6\xaf\x94\xe6\x8b\x9f", NULL } },                                                    /* 避难 比拟 */
+    { "xian",    0, { "\xe5\x90\x93\xe4\xbd\xa0", NULL } },                                                                                /* 吓你 */
+};
+
+#if (USE_ZH_USER_DICT == 1)
+/* checks run after "shi jie" 师姐 is boosted by user dictionary, the bound of scan must count the boost */
+static const bench_check_t bench_boost_checks[] = {
+    { "shij",    1, { "\xe5\xb8\x88\xe5\xa7\x90", NULL } },                                                                                /* 师姐 */
+    { "shijie",  1, { "\xe5\xb8\x88\xe5\xa7\x90", NULL } },                                                                                /* 师姐 */
+};
+#endif
+
+typedef void (*bench_fn_t)(const char* str);
+
+typedef struct {
+    const char* name;               /* name of function benched */
+    bench_fn_t  fn;
+    uint8_t     code_input;         /* 1: syllable input set, 0: pinyin string input set */
+}bench_case_t;
+
+typedef struct {
+    uint32_t calls;
+    double   total_ns;
+    uint64_t p50, p90, p99, max;
+    uint32_t cache_hit, cache_miss; /* result cache queries of measured rounds */
+    uint32_t block_hit, block_miss; /* storage cache block lookups of measured rounds */
+    uint32_t fetched;               /* bytes fetched from storage in measured rounds */
+}bench_result_t;
+
+static char     input_buf[BENCH_MAX_INPUTS][BENCH_MAX_INPUT_LEN];
+static uint32_t input_num = 0;
+static char     syl_buf[BENCH_MAX_INPUTS][MAX_WORD_CODE_LENGTH + 1];
+static uint32_t syl_num = 0;
+static char     code_res[MAX_CODE_BUFF_SZ];
+static uint8_t  keep_cache = 0;
+static uint8_t  block_cache = 0;    /* storage is read through block cache */
+
+/* files registered to RAM storage backend by -s ram */
+static const char* bench_files[] = {
+    ZH_CODE_TABLE_FILE_NAME, ZH_WORD_DICTIONARY_FILE_NAME, ZH_WORD_DICT_BIN_FILE_NAME,
+    ZH_VAGUE_TABLE_FILE_NAME, ZH_CHAR_ID_FILE_NAME,
+};
+static uint8_t* bench_blobs[sizeof(bench_files) / sizeof(bench_files[0])];
+
+/************************   timer   *********************************/
+
+/* monotonic time in nanoseconds */
+static uint64_t bench_now_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER cnt;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (uint64_t)((double)cnt.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/************************   bench cases   *********************************/
+
+static void bench_code_prec(const char* str) {
+    uint8_t br;
+    zh_match_code_prec(str, code_res, MAX_CODE_SEARCH_TYPES, &br);
+}
+
+static void bench_code_vague(const char* str) {
+    uint8_t br;
+    zh_match_code_vague(str, code_res, MAX_CODE_SEARCH_TYPES, &br);
+}
+
+static void bench_split(const char* str) {
+    __split_method_list_t* m_list = zh_pinyin_get_split(str);
+    zh_pinyin_filter_split(m_list);
+    zh_pinyin_free_split(m_list);
+}
+
+#if (USE_ZH_WORD_MATCH == 1)
+static void bench_word(const char* str) {
+    zh_word_free_match(zh_match_word(str, NULL));
+}
+
+static void bench_cand(const char* str) {
+    static __zh_cand_list_t list;
+    zh_match_cand(str, NULL, &list);
+}
+#endif
+
+static const bench_case_t bench_cases[] = {
+    { "zh_match_code_prec",  bench_code_prec,  1 },
+    { "zh_match_code_vague", bench_code_vague, 1 },
+    { "zh_pinyin_get_split+zh_pinyin_filter_split", bench_split, 0 },
+#if (USE_ZH_WORD_MATCH == 1)
+    { "zh_match_word", bench_word, 0 },
+    { "zh_match_cand", bench_cand, 0 },
+#endif
+};
+
+/* clear the result cache before a call unless it's kept (-c) */
+static void bench_cache_prepare(void) {
+#if (USE_ZH_RESULT_CACHE == 1)
+    if (!keep_cache) zh_result_cache_clear();
+#endif
+}
+
+/* result cache counters of default context */
+static void bench_cache_stat(uint32_t* hit, uint32_t* miss) {
+    *hit = *miss = 0;
+#if (USE_ZH_RESULT_CACHE == 1)
+    zh_result_cache_stat(hit, miss, NULL);
+#endif
+}
+
+/************************   regression checks   *********************************/
+
+#if (USE_ZH_WORD_MATCH == 1)
+/* 1 if word is one of the words in word blocks */
+static uint8_t check_word_found(const __word_block_t* b, const char* word) {
+    size_t len = strlen(word);
+    for (; b != NULL; b = b->next) {
+        if (b->type != WORD_BLK_TYPE_WORDS) continue;
+        const char* p = b->buf;
+        for (const uint8_t* n = b->num.word_nbr; *n != 0; n++) {
+            if ((size_t)3 * (*n) == len && memcmp(p, word, len) == 0) return 1;
+            p += 3 * (*n);
+        }
+    }
+    return 0;
+}
+#endif
+
+#if (USE_ZH_WORD_MATCH == 1)
+/* run the checks of list, return the number of words failed */
+static uint32_t run_check_list(const bench_check_t* list, size_t num) {
+    uint32_t fail = 0;
+    for (size_t i = 0; i < num; i++) {
+        const bench_check_t* c = &list[i];
+        __word_block_t* b = zh_match_word(c->input, NULL);
+        for (uint8_t j = 0; j < 4 && c->words[j] != NULL; j++) {
+            if (check_word_found(b, c->words[j]) != c->found) {
+                fprintf(stderr, "check failed : %s %s for \"%s\"\n", c->words[j], c->found ? "not found" : "found", c->input);
+                fail++;
+            }
+        }
+        zh_word_free_match(b);
+    }
+    return fail;
+}
+#endif
+
+/* run all the regression checks, return the number of words failed */
+static uint32_t run_checks(void) {
+    uint32_t fail = 0;
+#if (USE_ZH_WORD_MATCH == 1)
+    fail += run_check_list(bench_checks, sizeof(bench_checks) / sizeof(bench_checks[0]));
+#if (USE_ZH_USER_DICT == 1)
+    if (zh_user_dict_boost("shi jie", "\xe5\xb8\x88\xe5\xa7\x90", 200) == 0) {   /* kept in RAM only, no log is opened */
+        fail += run_check_list(bench_boost_checks, sizeof(bench_boost_checks) / sizeof(bench_boost_checks[0]));
+    }
+    else {
+        fprintf(stderr, "check failed : boost user word\n");
+        fail++;
+    }
+    zh_user_dict_close();    /* clear overlay */
+#endif
+#endif
+    return fail;
+}
+
+/************************   inputs   *********************************/
+
+/* all the syllables of code table */
+static void load_syllables(void) {
+    for (int i = 0; i < 26; i++) {
+        for (int j = 0; j < code_index[i].table_length && syl_num < BENCH_MAX_INPUTS; j++) {
+            strncpy(syl_buf[syl_num], code_index[i].code_table[j], MAX_WORD_CODE_LENGTH);
+            syl_buf[syl_num++][MAX_WORD_CODE_LENGTH] = '\0';
+        }
+    }
+}
+
+/* read input set from file, or use the built-in one. return 0: success, 1: file error */
+static uint8_t load_inputs(const char* file) {
+    if (file == NULL) {
+        for (size_t i = 0; i < sizeof(bench_default_inputs) / sizeof(bench_default_inputs[0]); i++) {
+            strcpy(input_buf[input_num++], bench_default_inputs[i]);
+        }
+        return 0;
+    }
+    FILE* fp = fopen(file, "r");
+    if (fp == NULL) return 1;
+    char line[256];
+    while (input_num < BENCH_MAX_INPUTS && fgets(line, sizeof(line), fp)) {
+        size_t len = strcspn(line, "\r\n");
+        if (len == 0 || len > ZH_MAX_STRING_LENGTH) continue;
+        memcpy(input_buf[input_num], line, len);
+        input_buf[input_num++][len] = '\0';
+    }
+    fclose(fp);
+    return input_num == 0;
+}
+
+/* select storage backend by name, files are read into RAM blobs for "ram". return 0: success, 1: invalid name */
+static uint8_t set_storage(const char* name) {
+    if (strcmp(name, "stdio") == 0) zh_storage_set_backend(&zh_storage_stdio);
+    else if (strcmp(name, "mmap") == 0) zh_storage_set_backend(&zh_storage_mmap);
+    else if (strcmp(name, "flash") == 0) zh_storage_set_backend(&zh_storage_flash);
+#if (USE_ZH_EMBED_TABLES == 1)
+    else if (strcmp(name, "embed") == 0) zh_storage_set_backend(&zh_storage_embed);
+#endif
+    else if (strcmp(name, "ram") == 0) {
+        for (size_t i = 0; i < sizeof(bench_files) / sizeof(bench_files[0]); i++) {
+            uint32_t sz;
+            if (zh_storage_load(bench_files[i], &bench_blobs[i], &sz) == 0) {
+                zh_storage_ram_add(bench_files[i], bench_blobs[i], sz);
+            }
+        }
+        zh_storage_set_backend(&zh_storage_ram);
+    }
+    else return 1;
+    return 0;
+}
+
+/* block lookups and bytes fetched from storage (by block cache, or all reads passed to backend) */
+static void bench_storage_stat(uint32_t* hit, uint32_t* miss, uint32_t* fetched) {
+    *hit = *miss = 0;
+#if (USE_ZH_STORAGE_CACHE == 1)
+    if (block_cache) {
+        zh_storage_cache_stat(hit, miss, fetched);
+        return;
+    }
+#endif
+    zh_storage_stat(NULL, fetched);
+}
+
+/************************   statistics   *********************************/
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* nearest rank percentile of sorted samples */
+static uint64_t percentile(const uint64_t* s, uint32_t n, uint32_t p) {
+    uint32_t rank = (uint32_t)(((uint64_t)p * n + 99) / 100);
+    return s[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * @brief run a bench case : warmup rounds, then time every call of the measured rounds
+ * @return 0: success, 1: malloc failed
+ */
+static uint8_t bench_run(const bench_case_t* bc, uint32_t rounds, uint32_t warmup, bench_result_t* res) {
+    char (*inputs)[BENCH_MAX_INPUT_LEN] = input_buf;
+    char (*syls)[MAX_WORD_CODE_LENGTH + 1] = syl_buf;
+    uint32_t n = bc->code_input ? syl_num : input_num;
+    uint64_t* samples = malloc(sizeof(uint64_t) * (size_t)n * rounds);
+    if (samples == NULL || n == 0) {
+        free(samples);
+        return 1;
+    }
+    for (uint32_t r = 0; r < warmup; r++) {
+        for (uint32_t i = 0; i < n; i++) {
+            bench_cache_prepare();
+            bc->fn(bc->code_input ? syls[i] : inputs[i]);
+        }
+    }
+    uint32_t k = 0, hit0, miss0, bhit0, bmiss0, fetched0;
+    res->total_ns = 0;
+    bench_cache_stat(&hit0, &miss0);
+    bench_storage_stat(&bhit0, &bmiss0, &fetched0);
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < n; i++) {
+            const char* str = bc->code_input ? syls[i] : inputs[i];
+            bench_cache_prepare();
+            uint64_t t0 = bench_now_ns();
+            bc->fn(str);
+            samples[k] = bench_now_ns() - t0;
+            res->total_ns += (double)samples[k++];
+        }
+    }
+    bench_cache_stat(&res->cache_hit, &res->cache_miss);
+    res->cache_hit -= hit0;
+    res->cache_miss -= miss0;
+    bench_storage_stat(&res->block_hit, &res->block_miss, &res->fetched);
+    res->block_hit -= bhit0;
+    res->block_miss -= bmiss0;
+    res->fetched -= fetched0;
+    qsort(samples, k, sizeof(uint64_t), cmp_u64);
+    res->calls = k;
+    res->p50 = percentile(samples, k, 50);
+    res->p90 = percentile(samples, k, 90);
+    res->p99 = percentile(samples, k, 99);
+    res->max = samples[k - 1];
+    free(samples);
+    return 0;
+}
+
+/* unload resident tables and release storage */
+static void bench_release(void) {
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+    zh_word_json_index_unload();
+#endif
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+    zh_char_id_unload();
+#endif
+#if (USE_ZH_VAGUE_TABLE == 1)
+    zh_vague_table_unload();
+#endif
+#if (USE_ZH_WORD_BOUND == 1)
+    zh_word_bound_unload();
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+    zh_word_abbr_unload();
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+    zh_word_trie_unload();
+#endif
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+    zh_code_table_unload();
+#endif
+    zh_storage_set_backend(NULL);
+#if (USE_ZH_STORAGE_CACHE == 1)
+    zh_storage_cache_deinit();
+#endif
+    zh_storage_ram_clear();
+    for (size_t i = 0; i < sizeof(bench_files) / sizeof(bench_files[0]); i++) {
+        if (bench_blobs[i]) zh_buffer_free(bench_blobs[i]);
+    }
+}
+
+/************************   main   *********************************/
+
+int main(int argc, char** argv) {
+    uint32_t rounds = 20, warmup = 2;
+    const char* format = "json";
+    const char* out_file = NULL;
+    const char* in_file = NULL;
+    const char* storage = zh_storage_get_backend()->name;
+    const char* policy = NULL;
+    uint32_t budget = 16 * 1024;
+    uint8_t resident = 0;
+    uint8_t check = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) rounds = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) warmup = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) format = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_file = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) in_file = argv[++i];
+        else if (strcmp(argv[i], "-l") == 0) resident = 1;
+        else if (strcmp(argv[i], "-c") == 0) keep_cache = 1;
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) storage = argv[++i];
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) policy = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) budget = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0) check = 1;
+        else {
+            fprintf(stderr, "usage : zh_bench [-n rounds] [-w warmup] [-f json|csv] [-o output] [-i inputs] [-l] [-c] [-s storage] [-k lru|clock] [-b budget] [-r]\n");
+            return 1;
+        }
+    }
+    if (rounds == 0 || (strcmp(format, "json") != 0 && strcmp(format, "csv") != 0)) {
+        fprintf(stderr, "invalid rounds or format\n");
+        return 1;
+    }
+    if (set_storage(storage)) {
+        fprintf(stderr, "invalid storage %s\n", storage);
+        return 1;
+    }
+    if (policy != NULL) {
+#if (USE_ZH_STORAGE_CACHE == 1)
+        uint8_t pol = strcmp(policy, "clock") == 0 ? ZH_STORAGE_CACHE_CLOCK : ZH_STORAGE_CACHE_LRU;
+        if ((strcmp(policy, "lru") != 0 && strcmp(policy, "clock") != 0) ||
+            zh_storage_cache_init(zh_storage_get_backend(), budget, pol)) {
+            fprintf(stderr, "invalid block cache policy %s or budget %u\n", policy, budget);
+            return 1;
+        }
+        zh_storage_set_backend(&zh_storage_cache);
+        block_cache = 1;
+#else
+        fprintf(stderr, "block cache is not enabled (USE_ZH_STORAGE_CACHE)\n");
+        return 1;
+#endif
+    }
+    load_syllables();
+    if (load_inputs(in_file)) {
+        fprintf(stderr, "read input file %s failed\n", in_file);
+        return 1;
+    }
+    if (resident) {
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+        if (zh_code_table_load()) return 1;
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+        if (zh_word_trie_load()) return 1;
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+        if (zh_word_abbr_load()) return 1;
+#endif
+#if (USE_ZH_WORD_BOUND == 1)
+        if (zh_word_bound_load()) return 1;
+#endif
+#if (USE_ZH_VAGUE_TABLE == 1)
+        if (zh_vague_table_load()) return 1;
+#endif
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+        if (zh_char_id_load()) return 1;
+#endif
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+        if (zh_word_json_index_load()) return 1;
+#endif
+    }
+    if (check) {
+        uint32_t fail = run_checks();
+        printf("regression checks %s (%u words failed)\n", fail ? "failed" : "passed", fail);
+        bench_release();
+        return fail != 0;
+    }
+
+    FILE* out = out_file ? fopen(out_file, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "open output file %s failed\n", out_file);
+        return 1;
+    }
+    uint8_t json = strcmp(format, "json") == 0;
+    if (json) {
+        fprintf(out, "{\n  \"bench\": \"zh_bench\",\n  \"rounds\": %u,\n  \"warmup\": %u,\n  \"resident\": %u,\n  \"keep_cache\": %u,\n  \"storage\": \"%s\",\n  \"block_cache\": \"%s\",\n  \"block_cache_budget\": %u,\n", 
+                rounds, warmup, resident, keep_cache, storage, policy ? policy : "none", policy ? budget : 0);
+        fprintf(out, "  \"syllable_inputs\": %u,\n  \"string_inputs\": %u,\n  \"results\": [\n", syl_num, input_num);
+    }
+    else {
+        fprintf(out, "api,calls,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,throughput_qps,cache_hit_ratio,block_hit_ratio,bytes_fetched\n");
+    }
+    size_t case_num = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    for (size_t c = 0; c < case_num; c++) {
+        bench_result_t res;
+        if (bench_run(&bench_cases[c], rounds, warmup, &res)) {
+            fprintf(stderr, "bench %s failed\n", bench_cases[c].name);
+            return 1;
+        }
+        double mean = res.total_ns / res.calls;
+        double qps = res.total_ns > 0 ? res.calls * 1e9 / res.total_ns : 0;
+        uint32_t cache_q = res.cache_hit + res.cache_miss;
+        double hit_ratio = cache_q > 0 ? (double)res.cache_hit / cache_q : 0;
+        uint32_t block_q = res.block_hit + res.block_miss;
+        double block_ratio = block_q > 0 ? (double)res.block_hit / block_q : 0;
+        double fetched = (double)res.fetched / res.calls;
+        if (json) {
+            fprintf(out, "    { \"api\": \"%s\", \"calls\": %u, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p90_ns\": %llu, "
+                         "\"p99_ns\": %llu, \"max_ns\": %llu, \"throughput_qps\": %.1f, \"cache_hit_ratio\": %.3f, "
+                         "\"block_hit_ratio\": %.3f, \"bytes_fetched\": %.1f }%s\n",
+                    bench_cases[c].name, res.calls, mean, (unsigned long long)res.p50, (unsigned long long)res.p90,
+                    (unsigned long long)res.p99, (unsigned long long)res.max, qps, hit_ratio, block_ratio, fetched,
+                    c + 1 < case_num ? "," : "");
+        }
+        else {
+            fprintf(out, "%s,%u,%.1f,%llu,%llu,%llu,%llu,%.1f,%.3f,%.3f,%.1f\n", bench_cases[c].name, res.calls, mean,
+                    (unsigned long long)res.p50, (unsigned long long)res.p90, (unsigned long long)res.p99,
+                    (unsigned long long)res.max, qps, hit_ratio, block_ratio, fetched);
+        }
+    }
+    if (json) fprintf(out, "  ]\n}\n");
+    if (out != stdout) fclose(out);
+    bench_release();
+    return 0;
+}
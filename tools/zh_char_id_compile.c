@@ -0,0 +1,106 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_char_id_compile.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-05  (last modified)
+ * @brief          : offline converter from utf-8 code table to 16-bit character id table
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_char_id_compile [zh_pinyin.bin] [output.bin]
+ * default input is zh_pinyin_decoder/bin/zh_pinyin.bin and default output is
+ * zh_pinyin_decoder/bin/zh_pinyin_id.bin, run it in project root directory.
+ * characters of each syllable in code_index are converted to their unicode
+ * code point and written in the format of zh_char_id.h.
+ * this program runs on host (PC), not on the device.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../zh_pinyin_decoder/zh_code_table.h"
+#include "../zh_pinyin_decoder/zh_char_id.h"
+
+static void wr_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+}
+
+static void wr_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+int main(int argc, char** argv) {
+    const char* in_file = argc > 1 ? argv[1] : "zh_pinyin_decoder/bin/zh_pinyin.bin";
+    const char* out_file = argc > 2 ? argv[2] : "zh_pinyin_decoder/bin/zh_pinyin_id.bin";
+
+    FILE* fp = fopen(in_file, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s failed\n", in_file);
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long sz = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t* code = malloc(sz > 0 ? (size_t)sz : 1);
+    if (code == NULL || fread(code, 1, (size_t)sz, fp) != (size_t)sz) {
+        fprintf(stderr, "read %s failed\n", in_file);
+        fclose(fp);
+        free(code);
+        return 1;
+    }
+    fclose(fp);
+
+    uint32_t char_num = 0;
+    uint16_t syl_num = 0;
+    for (int i = 0; i < 26; i++) {
+        syl_num += code_index[i].table_length;
+        for (int j = 0; j < code_index[i].table_length; j++) char_num += code_index[i].code_table_num[j];
+    }
+    uint8_t* out = malloc(ZH_CHAR_ID_HEADER_SZ + 2 * (size_t)char_num);
+    if (out == NULL) {
+        free(code);
+        return 1;
+    }
+    memset(out, 0, ZH_CHAR_ID_HEADER_SZ);
+    memcpy(out + ZH_CHAR_ID_HDR_MAGIC, ZH_CHAR_ID_MAGIC, 4);
+    wr_u16(out + ZH_CHAR_ID_HDR_VERSION, ZH_CHAR_ID_VERSION);
+    wr_u16(out + ZH_CHAR_ID_HDR_SYL_NUM, syl_num);
+    wr_u32(out + ZH_CHAR_ID_HDR_CHAR_NUM, char_num);
+
+    uint8_t* p = out + ZH_CHAR_ID_HEADER_SZ;
+    for (int i = 0; i < 26; i++) {
+        const __code_index_t* codex = &code_index[i];
+        for (int j = 0; j < codex->table_length; j++) {
+            uint32_t loc = codex->char_start + codex->code_offset[j];
+            if (loc + 3 * (uint32_t)codex->code_table_num[j] > (uint32_t)sz) {
+                fprintf(stderr, "syllable \"%s\" out of code table file\n", codex->code_table[j]);
+                free(code); free(out);
+                return 1;
+            }
+            for (int k = 0; k < codex->code_table_num[j]; k++, p += 2) {
+                uint16_t id = zh_char_id_from_utf8((const char*)code + loc + 3 * k);
+                if (id == 0) {
+                    fprintf(stderr, "character %d of \"%s\" is not 3 bytes utf-8\n", k, codex->code_table[j]);
+                    free(code); free(out);
+                    return 1;
+                }
+                wr_u16(p, id);
+            }
+        }
+    }
+    free(code);
+
+    fp = fopen(out_file, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s failed\n", out_file);
+        free(out);
+        return 1;
+    }
+    fwrite(out, 1, ZH_CHAR_ID_HEADER_SZ + 2 * (size_t)char_num, fp);
+    fclose(fp);
+    free(out);
+    printf("converted %u syllables, %u characters (%ld -> %u bytes)\n", syl_num, char_num, sz,
+           (unsigned)(ZH_CHAR_ID_HEADER_SZ + 2 * char_num));
+    return 0;
+}
@@ -0,0 +1,434 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_dict_compile.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-09-28  (last modified)
+ * @brief          : offline compiler from json word dictionary to binary dictionary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_dict_compile [input.json] [output.bin]
+ * default input is zh_pinyin_decoder/bin/zh_word_dict.json and default output
+ * is zh_pinyin_decoder/bin/zh_word_dict.bin. the format is described in
+ * zh_word_dict.h. a number after a word in json array is the frequency of
+ * the word (e.g. from webdict source), it's stored as weight of the word.
+ * this program runs on host (PC), not on the device.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../CJSON/cJSON.h"
+#include "../zh_pinyin_decoder/zh_word_dict.h"
+
+#define DEFAULT_INPUT_FILE   "zh_pinyin_decoder/bin/zh_word_dict.json"
+#define DEFAULT_OUTPUT_FILE  "zh_pinyin_decoder/bin/zh_word_dict.bin"
+
+/* dictionary entry (points to the json item) */
+typedef struct {
+    const char* key;
+    cJSON* item;
+}dict_entry_t;
+
+/* key index with the code of its initial letters */
+typedef struct {
+    uint32_t code;
+    uint32_t key;
+}abbr_entry_t;
+
+/* trie node used for building double-array trie (children are in increasing code order) */
+typedef struct {
+    uint32_t child;       /* first child node (0: no child) */
+    uint32_t sibling;     /* next sibling node (0: no sibling) */
+    uint16_t code;        /* syllable id of edge to this node (0: key end) */
+    int32_t  value;       /* -(key index + 1) for end node */
+}trie_node_t;
+
+static char (*syl_table)[ZH_WORD_DICT_SYL_SZ] = NULL;    /* sorted syllable table */
+static uint32_t syl_num = 0;
+
+static trie_node_t* nodes = NULL;
+static uint32_t node_num = 0, node_cap = 0;
+
+static int32_t* da_base = NULL;
+static int32_t* da_check = NULL;
+static uint32_t da_cap = 0, da_size = 0;
+
+static abbr_entry_t* abbr = NULL;
+static uint32_t abbr_key_num = 0, abbr_num = 0;
+
+static int entry_cmp(const void* a, const void* b) {
+    return strcmp(((const dict_entry_t*)a)->key, ((const dict_entry_t*)b)->key);
+}
+
+static int syl_cmp(const void* a, const void* b) {
+    return strncmp((const char*)a, (const char*)b, ZH_WORD_DICT_SYL_SZ);
+}
+
+/* get syllable id (index in sorted syllable table + 1) */
+static uint16_t syl_id(const char* syl, size_t len) {
+    char tmp[ZH_WORD_DICT_SYL_SZ] = { 0 };
+    memcpy(tmp, syl, len);
+    char* res = bsearch(tmp, syl_table, syl_num, ZH_WORD_DICT_SYL_SZ, syl_cmp);
+    return (uint16_t)((res - (char*)syl_table) / ZH_WORD_DICT_SYL_SZ + 1);
+}
+
+/* collect all syllables used in keys into sorted syllable table */
+static int build_syllables(dict_entry_t* entries, uint32_t key_num) {
+    uint32_t cap = 64;
+    syl_table = malloc(cap * ZH_WORD_DICT_SYL_SZ);
+    for (uint32_t i = 0; i < key_num; i++) {
+        const char* p = entries[i].key;
+        while (*p) {
+            size_t len = strcspn(p, " ");
+            if (len >= ZH_WORD_DICT_SYL_SZ) {
+                printf("syllable too long in \"%s\"\n", entries[i].key);
+                return 1;
+            }
+            if (syl_num == cap) {
+                cap *= 2;
+                syl_table = realloc(syl_table, cap * ZH_WORD_DICT_SYL_SZ);
+            }
+            memset(syl_table[syl_num], 0, ZH_WORD_DICT_SYL_SZ);
+            memcpy(syl_table[syl_num++], p, len);
+            p += len;
+            if (*p == ' ') p++;
+        }
+    }
+    qsort(syl_table, syl_num, ZH_WORD_DICT_SYL_SZ, syl_cmp);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < syl_num; i++) {
+        if (n == 0 || syl_cmp(syl_table[n - 1], syl_table[i]) != 0) {
+            memcpy(syl_table[n++], syl_table[i], ZH_WORD_DICT_SYL_SZ);
+        }
+    }
+    syl_num = n;
+    return 0;
+}
+
+static uint32_t node_new(uint16_t code) {
+    if (node_num == node_cap) {
+        node_cap = node_cap ? node_cap * 2 : 1024;
+        nodes = realloc(nodes, node_cap * sizeof(trie_node_t));
+    }
+    trie_node_t* t = &nodes[node_num];
+    t->child = t->sibling = 0;
+    t->code = code;
+    t->value = 0;
+    return node_num++;
+}
+
+/* get child of node with code, append it if not exist (keys are inserted in order) */
+static uint32_t node_child(uint32_t parent, uint16_t code) {
+    uint32_t c = nodes[parent].child, last = 0;
+    for (; c != 0; last = c, c = nodes[c].sibling) {
+        if (nodes[c].code == code) return c;
+    }
+    uint32_t n = node_new(code);
+    if (last == 0) nodes[parent].child = n;
+    else nodes[last].sibling = n;
+    return n;
+}
+
+static void da_reserve(uint32_t sz) {
+    if (sz <= da_cap) return;
+    uint32_t cap = da_cap ? da_cap : 1024;
+    while (cap < sz) cap *= 2;
+    da_base  = realloc(da_base, cap * sizeof(int32_t));
+    da_check = realloc(da_check, cap * sizeof(int32_t));
+    for (uint32_t i = da_cap; i < cap; i++) {
+        da_base[i] = 0;
+        da_check[i] = -1;
+    }
+    da_cap = cap;
+}
+
+/* place the children of trie node (at da state s) into double array, first-fit */
+static void da_place(uint32_t node, uint32_t s) {
+    static uint32_t free_start = 1;     /* all units before it are used */
+    if (nodes[node].child == 0) return;
+    uint16_t first = nodes[nodes[node].child].code;
+    while (free_start < da_cap && da_check[free_start] >= 0) free_start++;
+
+    uint32_t b = free_start > first ? free_start - first : 1;
+    for (;; b++) {
+        int ok = 1;
+        for (uint32_t c = nodes[node].child; c != 0 && ok; c = nodes[c].sibling) {
+            da_reserve(b + nodes[c].code + 1);
+            if (da_check[b + nodes[c].code] >= 0) ok = 0;
+        }
+        if (ok) break;
+    }
+    da_base[s] = (int32_t)b;
+    for (uint32_t c = nodes[node].child; c != 0; c = nodes[c].sibling) {
+        uint32_t t = b + nodes[c].code;
+        da_check[t] = (int32_t)s;
+        da_base[t] = nodes[c].value;    /* end node keeps value, others are set when placed */
+        if (t + 1 > da_size) da_size = t + 1;
+    }
+    for (uint32_t c = nodes[node].child; c != 0; c = nodes[c].sibling) {
+        da_place(c, b + nodes[c].code);
+    }
+}
+
+/* build double-array trie of keys (as syllable id sequences) */
+static int build_trie(dict_entry_t* entries, uint32_t key_num) {
+    if (build_syllables(entries, key_num)) return 1;
+    node_new(0);   /* root */
+    for (uint32_t i = 0; i < key_num; i++) {
+        uint32_t n = 0;
+        const char* p = entries[i].key;
+        while (*p) {
+            size_t len = strcspn(p, " ");
+            n = node_child(n, syl_id(p, len));
+            p += len;
+            if (*p == ' ') p++;
+        }
+        n = node_child(n, 0);
+        nodes[n].value = -(int32_t)(i + 1);
+    }
+    da_reserve(1);
+    da_check[0] = 0;    /* root */
+    da_size = 1;
+    da_place(0, 0);
+    return 0;
+}
+
+static int abbr_cmp(const void* a, const void* b) {
+    const abbr_entry_t* x = a, * y = b;
+    if (x->code != y->code) return x->code < y->code ? -1 : 1;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/* build abbreviation index : keys sorted by (code of initials, key index) */
+static int build_abbr(dict_entry_t* entries, uint32_t key_num) {
+    abbr = malloc(sizeof(abbr_entry_t) * (key_num + 1));
+    if (abbr == NULL) return 1;
+    for (uint32_t i = 0; i < key_num; i++) {
+        char initials[ZH_WORD_DICT_ABBR_MAX_LEN];
+        uint8_t n = 0;
+        const char* p = entries[i].key;
+        for (; *p; p++) {
+            if (p != entries[i].key && p[-1] != ' ') continue;
+            if (n == ZH_WORD_DICT_ABBR_MAX_LEN) break;
+            initials[n++] = *p;
+        }
+        if (*p) continue;   /* too many syllables */
+        abbr[abbr_key_num].code = zh_word_abbr_code(initials, n);
+        abbr[abbr_key_num].key = i;
+        abbr_key_num++;
+    }
+    qsort(abbr, abbr_key_num, sizeof(abbr_entry_t), abbr_cmp);
+    for (uint32_t i = 0; i < abbr_key_num; i++) {
+        if (i == 0 || abbr[i].code != abbr[i - 1].code) abbr_num++;
+    }
+    return 0;
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF; p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24;
+}
+
+static char* read_file(const char* name, long* size) {
+    FILE* fp = fopen(name, "rb");
+    if (fp == NULL) return NULL;
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* buf = malloc(*size + 1);
+    if (buf == NULL || fread(buf, 1, *size, fp) != (size_t)*size) {
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+    buf[*size] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+/* number of words in json array (frequencies are not counted) */
+static int word_count(const cJSON* arr) {
+    int n = 0;
+    for (const cJSON* w = arr->child; w != NULL; w = w->next) n += !cJSON_IsNumber(w);
+    return n;
+}
+
+/* check the key is "xx xx xx" with lower case letters */
+static int key_valid(const char* key) {
+    size_t len = strlen(key);
+    if (len == 0 || len > ZH_WORD_DICT_KEY_MAX_LEN || key[0] < 'a' || key[0] > 'z') return 0;
+    for (size_t i = 0; i < len; i++) {
+        if ((key[i] < 'a' || key[i] > 'z') && key[i] != ' ') return 0;
+        if (key[i] == ' ' && (i == len - 1 || key[i + 1] == ' ')) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    const char* in_name  = argc > 1 ? argv[1] : DEFAULT_INPUT_FILE;
+    const char* out_name = argc > 2 ? argv[2] : DEFAULT_OUTPUT_FILE;
+
+    long json_size = 0;
+    char* json_str = read_file(in_name, &json_size);
+    if (json_str == NULL) {
+        printf("can't read dictionary file %s\n", in_name);
+        return 1;
+    }
+    cJSON* root = cJSON_Parse(json_str);
+    free(json_str);
+    if (root == NULL) {
+        printf("parse json file failed near : %.40s\n", cJSON_GetErrorPtr());
+        return 1;
+    }
+
+    /* collect and sort entries */
+    uint32_t key_num = (uint32_t)cJSON_GetArraySize(root);
+    dict_entry_t* entries = malloc(sizeof(dict_entry_t) * (key_num + 1));
+    uint32_t n = 0;
+    for (cJSON* js = root->child; js != NULL; js = js->next) {
+        if (!key_valid(js->string) || !cJSON_IsArray(js) || word_count(js) > 255) {
+            printf("skip invalid entry \"%s\"\n", js->string);
+            continue;
+        }
+        entries[n].key = js->string;
+        entries[n].item = js;
+        n++;
+    }
+    key_num = n;
+    qsort(entries, key_num, sizeof(dict_entry_t), entry_cmp);
+    for (uint32_t i = 1; i < key_num; i++) {
+        if (strcmp(entries[i - 1].key, entries[i].key) == 0) {
+            printf("duplicate key \"%s\"\n", entries[i].key);
+            return 1;
+        }
+    }
+    if (build_trie(entries, key_num)) return 1;
+    if (build_abbr(entries, key_num)) return 1;
+
+    /* build index and records */
+    uint32_t index_off = ZH_WORD_DICT_HEADER_SZ;
+    uint32_t record_off = index_off + 4 * key_num;
+    uint8_t* index = malloc(4 * key_num + 1);
+    uint8_t* records = malloc((size_t)json_size + 1);   /* records are always smaller than json */
+    uint8_t* bound = malloc(key_num + 1);
+    uint32_t rec_len = 0, max_weight = 0, weighted = 0;
+    uint8_t  hdr[ZH_WORD_DICT_HEADER_SZ];
+    memset(hdr, 0, sizeof(hdr));
+
+    uint8_t letter = 0;
+    for (uint32_t i = 0; i < key_num; i++) {
+        const char* key = entries[i].key;
+        while (letter <= key[0] - 'a') {
+            put_u32(hdr + ZH_WORD_DICT_HDR_LETTER + 4 * letter, i);
+            letter++;
+        }
+        put_u32(index + 4 * i, rec_len);
+        uint8_t kl = (uint8_t)strlen(key);
+        records[rec_len++] = kl;
+        memcpy(records + rec_len, key, kl);
+        rec_len += kl;
+        uint32_t word_num_loc = rec_len++;
+        uint8_t word_num = 0;
+        bound[i] = 0;
+        for (cJSON* w = entries[i].item->child; w != NULL; w = w->next) {
+            if (cJSON_IsNumber(w) && w->prev != NULL && cJSON_IsString(w->prev)) continue;  /* frequency, read with its word */
+            if (!cJSON_IsString(w) || strlen(w->valuestring) == 0 || strlen(w->valuestring) > 255) {
+                printf("skip invalid word in \"%s\"\n", key);
+                continue;
+            }
+            uint8_t wl = (uint8_t)strlen(w->valuestring);
+            uint8_t wt = ZH_WORD_WEIGHT_DEFAULT;
+            if (w->next != NULL && cJSON_IsNumber(w->next)) {
+                double f = w->next->valuedouble;
+                wt = zh_word_weight(f <= 0 ? 0 : f >= 4294967295.0 ? UINT32_MAX : (uint32_t)f);
+                weighted++;
+            }
+            records[rec_len++] = wl;
+            records[rec_len++] = wt;
+            memcpy(records + rec_len, w->valuestring, wl);   /* cJSON has decoded \uXXXX to utf-8 */
+            rec_len += wl;
+            word_num++;
+            if (wt > bound[i]) bound[i] = wt;
+        }
+        records[word_num_loc] = word_num;
+        if (bound[i] > max_weight) max_weight = bound[i];
+    }
+    while (letter <= 26) {
+        put_u32(hdr + ZH_WORD_DICT_HDR_LETTER + 4 * letter, key_num);
+        letter++;
+    }
+
+    memcpy(hdr + ZH_WORD_DICT_HDR_MAGIC, ZH_WORD_DICT_MAGIC, 4);
+    put_u16(hdr + ZH_WORD_DICT_HDR_VERSION, ZH_WORD_DICT_VERSION);
+    put_u16(hdr + ZH_WORD_DICT_HDR_FLAGS, 0);
+    put_u32(hdr + ZH_WORD_DICT_HDR_KEY_NUM, key_num);
+    put_u32(hdr + ZH_WORD_DICT_HDR_INDEX, index_off);
+    put_u32(hdr + ZH_WORD_DICT_HDR_RECORD, record_off);
+    uint32_t syl_off = record_off + rec_len;
+    uint32_t trie_off = syl_off + syl_num * ZH_WORD_DICT_SYL_SZ;
+    uint32_t abbr_off = trie_off + 8 * da_size;
+    uint32_t bound_off = abbr_off + 8 * abbr_num + 4 * abbr_key_num;
+    uint32_t file_size = bound_off + key_num;
+    put_u32(hdr + ZH_WORD_DICT_HDR_SIZE, file_size);
+    put_u32(hdr + ZH_WORD_DICT_HDR_SYL, syl_off);
+    put_u32(hdr + ZH_WORD_DICT_HDR_SYL_NUM, syl_num);
+    put_u32(hdr + ZH_WORD_DICT_HDR_TRIE, trie_off);
+    put_u32(hdr + ZH_WORD_DICT_HDR_TRIE_SIZE, da_size);
+    put_u32(hdr + ZH_WORD_DICT_HDR_ABBR, abbr_off);
+    put_u32(hdr + ZH_WORD_DICT_HDR_ABBR_NUM, abbr_num);
+    put_u32(hdr + ZH_WORD_DICT_HDR_ABBR_KEYS, abbr_key_num);
+    put_u32(hdr + ZH_WORD_DICT_HDR_BOUND, bound_off);
+    put_u32(hdr + ZH_WORD_DICT_HDR_MAX_WEIGHT, max_weight);
+
+    FILE* fp = fopen(out_name, "wb");
+    if (fp == NULL) {
+        printf("can't create output file %s\n", out_name);
+        return 1;
+    }
+    fwrite(hdr, 1, sizeof(hdr), fp);
+    fwrite(index, 1, 4 * key_num, fp);
+    fwrite(records, 1, rec_len, fp);
+    fwrite(syl_table, ZH_WORD_DICT_SYL_SZ, syl_num, fp);
+    for (int k = 0; k < 2; k++) {
+        int32_t* arr = k == 0 ? da_base : da_check;
+        uint8_t tmp[4];
+        for (uint32_t i = 0; i < da_size; i++) {
+            put_u32(tmp, (uint32_t)arr[i]);
+            fwrite(tmp, 1, 4, fp);
+        }
+    }
+    for (uint32_t i = 0; i < abbr_key_num; i++) {
+        if (i > 0 && abbr[i].code == abbr[i - 1].code) continue;
+        uint8_t tmp[8];
+        put_u32(tmp, abbr[i].code);
+        put_u32(tmp + 4, i);
+        fwrite(tmp, 1, 8, fp);
+    }
+    for (uint32_t i = 0; i < abbr_key_num; i++) {
+        uint8_t tmp[4];
+        put_u32(tmp, abbr[i].key);
+        fwrite(tmp, 1, 4, fp);
+    }
+    fwrite(bound, 1, key_num, fp);
+    fclose(fp);
+    printf("compiled %u keys, %u syllables, %u trie units (%u nodes), %u abbreviations, %u bytes -> %s\n",
+           key_num, syl_num, da_size, node_num, abbr_num, file_size, out_name);
+    printf("%u words with frequency, max weight %u\n", weighted, max_weight);
+
+    free(index);
+    free(records);
+    free(bound);
+    free(syl_table);
+    free(nodes);
+    free(da_base);
+    free(da_check);
+    free(abbr);
+    free(entries);
+    cJSON_Delete(root);
+    return 0;
+}
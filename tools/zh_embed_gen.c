@@ -0,0 +1,78 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_embed_gen.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-15  (last modified)
+ * @brief          : offline generator of the table files linked into binary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_embed_gen output.c file1 [file2 ...]
+ * run it in project root directory, the files are given by the same paths the
+ * decoder opens them (e.g. zh_pinyin_decoder/bin/zh_pinyin.bin). each file is
+ * written as an aligned const array and listed in zh_storage_embed_files, which
+ * the embed storage backend (option USE_ZH_EMBED_TABLES) opens by path.
+ * CMake runs it when the build option ZH_EMBED_TABLES is ON.
+ * this program runs on host (PC), not on the device.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BYTES_PER_LINE  20
+
+/* write file content as array embed_<idx>, return size of file, -1 if failed */
+static long write_array(FILE* out, const char* path, int idx) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return -1;
+    fprintf(out, "/* %s */\nstatic const uint8_t ZH_EMBED_ALIGN embed_%d[] = {", path, idx);
+    long n = 0;
+    int c;
+    while ((c = fgetc(fp)) != EOF) {
+        fprintf(out, "%s0x%02x,", (n % BYTES_PER_LINE == 0) ? "\n    " : "", c);
+        n++;
+    }
+    if (n == 0) fprintf(out, "\n    0x00,");   /* empty array is not allowed */
+    fprintf(out, "\n};\n\n");
+    fclose(fp);
+    return n;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage : zh_embed_gen output.c file1 [file2 ...]\n");
+        return 1;
+    }
+    int num = argc - 2;
+    long* size = (long*)malloc(sizeof(long) * num);
+    FILE* out = fopen(argv[1], "w");
+    if (size == NULL || out == NULL) {
+        fprintf(stderr, "open output file %s failed\n", argv[1]);
+        return 1;
+    }
+    fprintf(out, "/* generated by tools/zh_embed_gen.c, do not edit */\n");
+    fprintf(out, "#include \"zh_storage.h\"\n\n");
+    fprintf(out, "#if defined(_MSC_VER)\n#define ZH_EMBED_ALIGN  __declspec(align(8))\n");
+    fprintf(out, "#elif defined(__GNUC__)\n#define ZH_EMBED_ALIGN  __attribute__((aligned(8)))\n");
+    fprintf(out, "#else\n#define ZH_EMBED_ALIGN\n#endif\n\n");
+    for (int i = 0; i < num; i++) {
+        size[i] = write_array(out, argv[i + 2], i);
+        if (size[i] < 0) {
+            fprintf(stderr, "read file %s failed\n", argv[i + 2]);
+            fclose(out);
+            remove(argv[1]);
+            return 1;
+        }
+    }
+    fprintf(out, "const zh_storage_embed_file_t zh_storage_embed_files[] = {\n");
+    for (int i = 0; i < num; i++) {
+        fprintf(out, "    { \"%s\", embed_%d, %ld },\n", argv[i + 2], i, size[i]);
+    }
+    fprintf(out, "};\n\nconst uint16_t zh_storage_embed_file_num = %d;\n", num);
+    fclose(out);
+    free(size);
+    printf("%d files embedded into %s\n", num, argv[1]);
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_hash_gen.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-06  (last modified)
+ * @brief          : offline generator of syllable prefix minimal perfect hash
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_hash_gen [output.c]
+ * default output is zh_pinyin_decoder/zh_hash_table.c, run it in project root.
+ * all prefixes of the syllables in code_index are collected, the hash tables
+ * (see zh_hash_boost.h) are built by hash and displace method so that each
+ * key has its own slot (entry number = key number).
+ *
+ * vague search sequence of a key :
+ *   1 letter key  : syllables in code table order
+ *   longer key    : longer syllables first, then in alphabet order
+ *
+ * the keys are also nodes of the syllable prefix automaton (trie), children of
+ * each node are listed in alphabet order in zh_syl_child.
+ * this program runs on host (PC), not on the device.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../zh_pinyin_decoder/zh_code_table.h"
+#include "../zh_pinyin_decoder/zh_hash_boost.h"
+
+#define MAX_KEY_NUM     2048
+#define MAX_VAGUE_NUM   8192
+#define MAX_DISP        0xFFFF
+
+typedef struct {
+    char     key[ZH_HASH_KEY_MAX_LEN + 1];
+    uint8_t  letter;
+    uint8_t  syl;
+    uint8_t  len;
+    int8_t   prec;
+    uint8_t  vague_num;
+    uint16_t vague_start;
+    uint32_t h;
+}key_t_;
+
+static key_t_   keys[MAX_KEY_NUM];
+static uint16_t key_num = 0;
+static uint8_t  vague_idx[MAX_VAGUE_NUM];
+static uint16_t vague_num = 0;
+
+static const char* syl_str(uint8_t letter, uint8_t syl) {
+    return code_index[letter].code_table[syl];
+}
+
+static uint8_t sort_letter;     /* letter of syllables sorted by syl_cmp */
+static int syl_cmp(const void* a, const void* b) {
+    const char* s1 = syl_str(sort_letter, *(const uint8_t*)a);
+    const char* s2 = syl_str(sort_letter, *(const uint8_t*)b);
+    size_t l1 = strlen(s1), l2 = strlen(s2);
+    if (l1 != l2) return l1 > l2 ? -1 : 1;
+    return strcmp(s1, s2);
+}
+
+/* collect all prefixes with their precise index and vague sequence */
+static uint8_t collect_keys(void) {
+    for (uint8_t i = 0; i < 26; i++) {
+        const __code_index_t* codex = &code_index[i];
+        for (uint8_t j = 0; j < codex->table_length; j++) {
+            size_t slen = strlen(codex->code_table[j]);
+            if (slen > ZH_HASH_KEY_MAX_LEN) return 1;
+            for (uint8_t len = 1; len <= slen; len++) {
+                uint16_t k = 0;
+                while (k < key_num && !(keys[k].letter == i && keys[k].len == len &&
+                                        strncmp(keys[k].key, codex->code_table[j], len) == 0)) k++;
+                if (k < key_num) continue;   /* already collected */
+                if (key_num >= MAX_KEY_NUM) return 1;
+                key_t_* key = &keys[key_num++];
+                memcpy(key->key, codex->code_table[j], len);
+                key->key[len] = '\0';
+                key->letter = i;
+                key->syl = j;
+                key->len = len;
+            }
+        }
+    }
+    for (uint16_t k = 0; k < key_num; k++) {
+        key_t_* key = &keys[k];
+        const __code_index_t* codex = &code_index[key->letter];
+        uint8_t seq[256];
+        uint8_t n = 0;
+        key->prec = -1;
+        for (uint8_t j = 0; j < codex->table_length; j++) {
+            if (strcmp(codex->code_table[j], key->key) == 0) key->prec = (int8_t)j;
+            else if (strncmp(codex->code_table[j], key->key, key->len) == 0) seq[n++] = j;
+        }
+        if (key->len > 1) {
+            sort_letter = key->letter;
+            qsort(seq, n, sizeof(uint8_t), syl_cmp);
+        }
+        if (vague_num + n > MAX_VAGUE_NUM) return 1;
+        key->vague_start = vague_num;
+        key->vague_num = n;
+        memcpy(vague_idx + vague_num, seq, n);
+        vague_num += n;
+        key->h = zh_hash_key(key->key, key->len);
+    }
+    return 0;
+}
+
+static uint16_t slot_of[MAX_KEY_NUM];    /* slot (entry index) of each key */
+static uint16_t child_list[MAX_KEY_NUM];
+static uint16_t child_num = 0;
+
+/* children of key k (k = key_num for root) in alphabet order, return child mask */
+static uint32_t list_children(uint16_t k, uint16_t* base) {
+    uint32_t mask = 0;
+    *base = child_num;
+    for (uint8_t c = 0; c < 26; c++) {
+        for (uint16_t i = 0; i < key_num; i++) {
+            const key_t_* key = &keys[i];
+            if (k == key_num) {
+                if (key->len != 1 || key->letter != c) continue;
+            }
+            else if (key->letter != keys[k].letter || key->len != keys[k].len + 1 || key->key[key->len - 1] != 'a' + c ||
+                     strncmp(key->key, keys[k].key, keys[k].len) != 0) continue;
+            mask |= (uint32_t)1 << c;
+            child_list[child_num++] = slot_of[i];
+            break;
+        }
+    }
+    return mask;
+}
+
+static uint16_t disp_num;
+static uint16_t* disp;
+static int16_t* slot_key;      /* key index of each slot, -1 : empty */
+static uint16_t* bucket_order;
+static uint16_t* bucket_size;
+
+static int bucket_cmp(const void* a, const void* b) {
+    uint16_t s1 = bucket_size[*(const uint16_t*)a], s2 = bucket_size[*(const uint16_t*)b];
+    if (s1 != s2) return s1 > s2 ? -1 : 1;
+    return (int)*(const uint16_t*)a - (int)*(const uint16_t*)b;
+}
+
+/* hash and displace : place buckets in size order, find a displacement that puts all keys in empty slots */
+static uint8_t build_hash(void) {
+    disp_num = (uint16_t)((key_num + 3) / 4);
+    disp = calloc(disp_num, sizeof(uint16_t));
+    bucket_order = calloc(disp_num, sizeof(uint16_t));
+    bucket_size = calloc(disp_num, sizeof(uint16_t));
+    slot_key = malloc(key_num * sizeof(int16_t));
+    if (!disp || !bucket_order || !bucket_size || !slot_key) return 1;
+    for (uint16_t s = 0; s < key_num; s++) slot_key[s] = -1;
+    for (uint16_t k = 0; k < key_num; k++) bucket_size[keys[k].h % disp_num]++;
+    for (uint16_t b = 0; b < disp_num; b++) bucket_order[b] = b;
+    qsort(bucket_order, disp_num, sizeof(uint16_t), bucket_cmp);
+
+    for (uint16_t i = 0; i < disp_num; i++) {
+        uint16_t b = bucket_order[i];
+        if (bucket_size[b] == 0) break;
+        uint16_t members[64], slots[64], m = 0;
+        for (uint16_t k = 0; k < key_num && m < 64; k++) {
+            if (keys[k].h % disp_num == b) members[m++] = k;
+        }
+        uint32_t d;
+        for (d = 0; d <= MAX_DISP; d++) {
+            uint16_t j;
+            for (j = 0; j < m; j++) {
+                slots[j] = zh_hash_slot(keys[members[j]].h, (uint16_t)d, key_num);
+                if (slot_key[slots[j]] >= 0) break;
+                uint16_t t;
+                for (t = 0; t < j && slots[t] != slots[j]; t++);
+                if (t < j) break;
+            }
+            if (j == m) break;
+        }
+        if (d > MAX_DISP) return 1;
+        disp[b] = (uint16_t)d;
+        for (uint16_t j = 0; j < m; j++) slot_key[slots[j]] = (int16_t)members[j];
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* out_file = argc > 1 ? argv[1] : "zh_pinyin_decoder/zh_hash_table.c";
+    if (collect_keys()) {
+        fprintf(stderr, "too many keys or syllable too long\n");
+        return 1;
+    }
+    if (build_hash()) {
+        fprintf(stderr, "build hash failed\n");
+        return 1;
+    }
+
+    for (uint16_t s = 0; s < key_num; s++) slot_of[slot_key[s]] = s;
+
+    FILE* fp = fopen(out_file, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s failed\n", out_file);
+        return 1;
+    }
+    fprintf(fp,
+        "/**\n"
+        " ***************************** Declaration ********************************\n"
+        " * @file           : zh_hash_table.c\n"
+        " * @author         : FriedParrot (https://github.com/FriedParrot)\n"
+        " * @version        : v1.0\n"
+        " * @brief          : syllable prefix hash tables (generated by tools/zh_hash_gen.c)\n"
+        " * @license        : MIT license (https://opensource.org/license/mit)\n"
+        " *****************************************************************************\n"
+        " * @attention\n"
+        " * this file is need when option USE_ZH_HASH_BOOST is set to 1\n"
+        " * %u keys, %u displacements, %u vague sequence indexes, %u trie edges\n"
+        " *\n"
+        " * @warning generated file, don't modify it. run zh_hash_gen after modifying code table\n"
+        " *****************************************************************************\n"
+        " */\n"
+        "#include  \"zh_hash_boost.h\"\n\n", key_num, disp_num, vague_num, key_num);
+
+    fprintf(fp, "const uint16_t zh_hash_disp_num = %u;\n", disp_num);
+    fprintf(fp, "const uint16_t zh_hash_entry_num = %u;\n\n", key_num);
+
+    fprintf(fp, "const uint16_t zh_hash_disp[%u] = {", disp_num);
+    for (uint16_t b = 0; b < disp_num; b++) {
+        fprintf(fp, "%s%u%s", b % 16 == 0 ? "\n    " : "", disp[b], b + 1 < disp_num ? "," : "");
+    }
+    fprintf(fp, "\n};\n\n");
+
+    fprintf(fp, "/* { syl, len, prec, vague_num, vague_start }  key */\n");
+    fprintf(fp, "const __zh_hash_entry_t zh_hash_entry[%u] = {\n", key_num);
+    for (uint16_t s = 0; s < key_num; s++) {
+        const key_t_* key = &keys[slot_key[s]];
+        fprintf(fp, "    { %2u, %u, %2d, %2u, %4u }, /* %s */\n", key->syl, key->len, key->prec, key->vague_num,
+                key->vague_start, key->key);
+    }
+    fprintf(fp, "};\n\n");
+
+    fprintf(fp, "/* vague search sequence of each key (syllable index in code_index) */\n");
+    fprintf(fp, "const uint8_t zh_hash_vague_idx[%u] = {", vague_num ? vague_num : 1);
+    for (uint16_t i = 0; i < vague_num; i++) {
+        fprintf(fp, "%s%u%s", i % 24 == 0 ? "\n    " : "", vague_idx[i], i + 1 < vague_num ? "," : "");
+    }
+    if (vague_num == 0) fprintf(fp, "\n    0");
+    fprintf(fp, "\n};\n\n");
+
+    /* automaton : node of each entry, then the root */
+    static uint32_t mask[MAX_KEY_NUM + 1];
+    static uint16_t base[MAX_KEY_NUM + 1];
+    for (uint16_t s = 0; s < key_num; s++) mask[s] = list_children(slot_key[s], &base[s]);
+    mask[key_num] = list_children(key_num, &base[key_num]);
+    fprintf(fp, "/* { child_mask, child_base } of each entry, the last one is root */\n");
+    fprintf(fp, "const __zh_syl_node_t zh_syl_node[%u] = {\n", key_num + 1);
+    for (uint16_t s = 0; s <= key_num; s++) {
+        fprintf(fp, "    { 0x%07lx, %4u }, /* %s */\n", (unsigned long)mask[s], base[s], s < key_num ? keys[slot_key[s]].key : "root");
+    }
+    fprintf(fp, "};\n\n");
+    fprintf(fp, "/* children (entry index) of each node in alphabet order */\n");
+    fprintf(fp, "const uint16_t zh_syl_child[%u] = {", child_num);
+    for (uint16_t i = 0; i < child_num; i++) {
+        fprintf(fp, "%s%u%s", i % 16 == 0 ? "\n    " : "", child_list[i], i + 1 < child_num ? "," : "");
+    }
+    fprintf(fp, "\n};\n");
+    fclose(fp);
+    printf("generated %u keys, %u displacements, %u vague indexes\n", key_num, disp_num, vague_num);
+    return 0;
+}
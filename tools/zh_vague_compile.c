@@ -0,0 +1,140 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_vague_compile.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-03  (last modified)
+ * @brief          : offline generator of precomputed vague match table
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * usage : zh_vague_compile [output.bin]
+ * default output is zh_pinyin_decoder/bin/zh_vague.bin, run it in project root
+ * directory (the code table file is read by the decoder). every prefix of the
+ * syllables in code table is matched by zh_match_code_vague with the maximum
+ * number, and the results are written in the format of zh_vague_table.h.
+ * this program runs on host (PC), not on the device.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../zh_pinyin_decoder/zh_pinyin_decoder.h"
+#include "../zh_pinyin_decoder/zh_code_table.h"
+#include "../zh_pinyin_decoder/zh_vague_table.h"
+
+#define MAX_PREFIX_NUM      2048
+#define MAX_RESULT_NUM      255         /* maximum num of zh_match_code_vague */
+
+typedef struct {
+    char     key[ZH_VAGUE_KEY_SZ + 1];
+    uint8_t  count;
+    uint32_t offset;
+}prefix_t;
+
+static prefix_t prefix[MAX_PREFIX_NUM];
+static uint16_t prefix_num = 0;
+static uint8_t  data[MAX_PREFIX_NUM * 3 * MAX_RESULT_NUM];
+static uint32_t data_sz = 0;
+
+static void wr_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+}
+
+static void wr_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static int prefix_cmp(const void* a, const void* b) {
+    return strcmp(((const prefix_t*)a)->key, ((const prefix_t*)b)->key);
+}
+
+/* collect all prefixes of syllables in code table (sorted, no repeat) */
+static uint8_t collect_prefix(void) {
+    for (int i = 0; i < 26; i++) {
+        for (int j = 0; j < code_index[i].table_length; j++) {
+            const char* syl = code_index[i].code_table[j];
+            for (size_t len = 1; len <= strlen(syl) && len <= ZH_VAGUE_KEY_SZ; len++) {
+                if (prefix_num >= MAX_PREFIX_NUM) return 1;
+                memcpy(prefix[prefix_num].key, syl, len);
+                prefix[prefix_num].key[len] = '\0';
+                prefix_num++;
+            }
+        }
+    }
+    qsort(prefix, prefix_num, sizeof(prefix_t), prefix_cmp);
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < prefix_num; i++) {
+        if (n == 0 || strcmp(prefix[n - 1].key, prefix[i].key) != 0) prefix[n++] = prefix[i];
+    }
+    prefix_num = n;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* out_file = argc > 1 ? argv[1] : "zh_pinyin_decoder/bin/zh_vague.bin";
+    if (collect_prefix()) {
+        fprintf(stderr, "too many prefixes\n");
+        return 1;
+    }
+
+    /* full vague match result of each prefix */
+    static char res_str[3 * MAX_RESULT_NUM + 1];
+    for (uint16_t i = 0; i < prefix_num; i++) {
+        uint8_t br = 0;
+        if (zh_match_code_vague(prefix[i].key, res_str, MAX_RESULT_NUM, &br)) {
+            fprintf(stderr, "vague match of \"%s\" failed (is code table file found?)\n", prefix[i].key);
+            return 1;
+        }
+        if (br >= MAX_RESULT_NUM) {
+            fprintf(stderr, "result of \"%s\" is truncated\n", prefix[i].key);
+            return 1;
+        }
+        prefix[i].count = br;
+        prefix[i].offset = data_sz;
+        memcpy(data + data_sz, res_str, 3 * (size_t)br);
+        data_sz += 3 * br;
+    }
+
+    /* open addressing slots, at least 2 times of prefix number */
+    uint16_t slot_num = 1;
+    while (slot_num < 2 * prefix_num) slot_num <<= 1;
+    uint16_t* slots = calloc(slot_num, sizeof(uint16_t));
+    if (slots == NULL) return 1;
+    for (uint16_t i = 0; i < prefix_num; i++) {
+        uint16_t s = zh_vague_hash(prefix[i].key, (uint8_t)strlen(prefix[i].key)) & (slot_num - 1);
+        while (slots[s] != 0) s = (s + 1) & (slot_num - 1);
+        slots[s] = i + 1;
+    }
+
+    FILE* fp = fopen(out_file, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s failed\n", out_file);
+        free(slots);
+        return 1;
+    }
+    uint8_t hdr[ZH_VAGUE_HEADER_SZ] = { 0 };
+    memcpy(hdr + ZH_VAGUE_HDR_MAGIC, ZH_VAGUE_MAGIC, 4);
+    wr_u16(hdr + ZH_VAGUE_HDR_VERSION, ZH_VAGUE_VERSION);
+    wr_u16(hdr + ZH_VAGUE_HDR_SLOT_NUM, slot_num);
+    wr_u16(hdr + ZH_VAGUE_HDR_PREFIX_NUM, prefix_num);
+    wr_u32(hdr + ZH_VAGUE_HDR_DATA_SZ, data_sz);
+    fwrite(hdr, 1, sizeof(hdr), fp);
+    for (uint16_t i = 0; i < slot_num; i++) {
+        uint8_t tmp[2];
+        wr_u16(tmp, slots[i]);
+        fwrite(tmp, 1, 2, fp);
+    }
+    for (uint16_t i = 0; i < prefix_num; i++) {
+        uint8_t e[ZH_VAGUE_ENTRY_SZ] = { 0 };
+        memcpy(e, prefix[i].key, strlen(prefix[i].key));
+        e[ZH_VAGUE_KEY_SZ] = prefix[i].count;
+        wr_u32(e + ZH_VAGUE_KEY_SZ + 2, prefix[i].offset);
+        fwrite(e, 1, sizeof(e), fp);
+    }
+    fwrite(data, 1, data_sz, fp);
+    fclose(fp);
+    free(slots);
+    printf("generated %u prefixes, %u slots, %u bytes of characters\n", prefix_num, slot_num, data_sz);
+    return 0;
+}
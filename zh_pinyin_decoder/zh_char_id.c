@@ -0,0 +1,111 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_char_id.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-05  (last modified)
+ * @brief          : 16-bit character id code table
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the id table (about 15kb for default code table, 2/3 of "zh_pinyin.bin") is
+ * kept in RAM after zh_char_id_load() in zh_pinyin_decoder.c.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_code_table.h"
+#include "zh_char_id.h"
+
+/************************   private functions   *********************************/
+
+static uint16_t rd_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief get the id of a 3 bytes utf-8 character
+ * @return id, 0 if str is not a 3 bytes utf-8 character
+ */
+uint16_t zh_char_id_from_utf8(const char* str) {
+    const uint8_t* p = (const uint8_t*)str;
+    if ((p[0] & 0xF0) != 0xE0 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) return 0;
+    return (uint16_t)(((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F));
+}
+
+/**
+ * @brief write utf-8 of n ids into out (3 * n bytes, not terminated)
+ */
+void zh_char_id_emit(const uint16_t* ids, uint16_t n, char* out) {
+    for (uint16_t i = 0; i < n; i++, out += 3) {
+        zh_char_id_to_utf8(ids[i], out);
+    }
+}
+
+/**
+ * @brief parse the id table file content into t (ids are copied), the file must match code_index
+ * @param file  content of "zh_pinyin_id.bin"
+ * @param size  size of file
+ * @return 0: success, 1: invalid file or malloc failed
+ */
+uint8_t zh_char_id_read(const uint8_t* file, uint32_t size, __char_id_table_t* t) {
+    memset(t, 0, sizeof(__char_id_table_t));
+    if (size < ZH_CHAR_ID_HEADER_SZ || memcmp(file + ZH_CHAR_ID_HDR_MAGIC, ZH_CHAR_ID_MAGIC, 4) != 0 ||
+        rd_u16(file + ZH_CHAR_ID_HDR_VERSION) != ZH_CHAR_ID_VERSION) return 1;
+    uint16_t syl_num = rd_u16(file + ZH_CHAR_ID_HDR_SYL_NUM);
+    uint32_t char_num = rd_u32(file + ZH_CHAR_ID_HDR_CHAR_NUM);
+    if (char_num > UINT16_MAX || ZH_CHAR_ID_HEADER_SZ + 2 * char_num != size) return 1;
+
+    /* syllable start is the sum of character numbers before it */
+    uint16_t syl_cnt = 0;
+    uint32_t char_cnt = 0;
+    for (int i = 0; i < 26; i++) {
+        t->letter_base[i] = syl_cnt;
+        syl_cnt += code_index[i].table_length;
+        for (int j = 0; j < code_index[i].table_length; j++) char_cnt += code_index[i].code_table_num[j];
+    }
+    if (syl_cnt != syl_num || char_cnt != char_num) return 1;
+
+    t->ids = zh_buffer_malloc(sizeof(uint16_t) * (char_num ? char_num : 1));
+    t->syl_start = zh_buffer_malloc(sizeof(uint16_t) * (syl_num ? syl_num : 1));
+    if (t->ids == NULL || t->syl_start == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_char_id_free(t);
+        return 1;
+    }
+    uint16_t start = 0;
+    for (int i = 0; i < 26; i++) {
+        for (int j = 0; j < code_index[i].table_length; j++) {
+            t->syl_start[t->letter_base[i] + j] = start;
+            start += code_index[i].code_table_num[j];
+        }
+    }
+    for (uint32_t i = 0; i < char_num; i++) {
+        t->ids[i] = rd_u16(file + ZH_CHAR_ID_HEADER_SZ + 2 * i);
+    }
+    t->syl_num = syl_num;
+    t->char_num = (uint16_t)char_num;
+    return 0;
+}
+
+/* free the table read by zh_char_id_read */
+void zh_char_id_free(__char_id_table_t* t) {
+    if (t->ids)       zh_buffer_free(t->ids);
+    if (t->syl_start) zh_buffer_free(t->syl_start);
+    memset(t, 0, sizeof(__char_id_table_t));
+}
+
+/**
+ * @brief get the ids of a syllable (code_table_num[syl] ids, same order as code table file)
+ * @param idx  first letter index of syllable (str[0] - 'a')
+ * @param syl  index of syllable in code_index[idx].code_table
+ */
+const uint16_t* zh_char_id_syllable(const __char_id_table_t* t, uint8_t idx, uint8_t syl) {
+    return t->ids + t->syl_start[t->letter_base[idx] + syl];
+}
@@ -0,0 +1,74 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_char_id.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-05  (last modified)
+ * @brief          : 16-bit character id code table definition header file
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_CHAR_ID_TABLE is set to 1. the table
+ * "zh_pinyin_id.bin" is generated from "zh_pinyin.bin" by tools/zh_char_id_compile.c.
+ * the character id is the unicode code point of the character, all characters
+ * in code table are in BMP (U+0800 ~ U+FFFF), so the id is 16-bit and utf-8
+ * of an id is always 3 bytes, computed without any lookup table. all numbers
+ * are stored in little endian.
+ *
+ *   header  : ZH_CHAR_ID_HEADER_SZ bytes (see below)
+ *   ids     : char_num * uint16, characters of each syllable in the order of
+ *             code_index (letter 'a' ~ 'z', then syllable order in code_table_x),
+ *             characters of a syllable are in the same order as "zh_pinyin.bin"
+ *
+ * the start of each syllable is not stored, it's the sum of code_table_num
+ * before it and is computed when the table is read.
+ *
+ * @warning regenerate the .bin file after modifying the code table
+ *****************************************************************************
+ */
+#ifndef __ZH_CHAR_ID_H
+#define __ZH_CHAR_ID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+
+#define ZH_CHAR_ID_MAGIC        "ZHCI"
+#define ZH_CHAR_ID_VERSION      1
+
+/** header layout (offset in bytes) */
+#define ZH_CHAR_ID_HDR_MAGIC    0       /* char[4]  magic "ZHCI"            */
+#define ZH_CHAR_ID_HDR_VERSION  4       /* uint16   format version          */
+#define ZH_CHAR_ID_HDR_SYL_NUM  6       /* uint16   number of syllables     */
+#define ZH_CHAR_ID_HDR_CHAR_NUM 8       /* uint32   number of ids           */
+#define ZH_CHAR_ID_HDR_RESERVED 12      /* uint32   reserved (0)            */
+#define ZH_CHAR_ID_HEADER_SZ    16
+
+typedef struct {
+    uint16_t* ids;              /* all character ids */
+    uint16_t* syl_start;        /* start of each syllable in ids (index : letter_base + syllable index) */
+    uint16_t  letter_base[26];  /* index of the first syllable of each letter in syl_start */
+    uint16_t  syl_num;
+    uint16_t  char_num;
+}__char_id_table_t;
+
+/* utf-8 (3 bytes) of character id */
+static inline void zh_char_id_to_utf8(uint16_t id, char* out) {
+    out[0] = (char)(0xE0 | (id >> 12));
+    out[1] = (char)(0x80 | ((id >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (id & 0x3F));
+}
+
+uint16_t zh_char_id_from_utf8(const char* str);
+void zh_char_id_emit(const uint16_t* ids, uint16_t n, char* out);
+uint8_t zh_char_id_read(const uint8_t* file, uint32_t size, __char_id_table_t* t);
+void zh_char_id_free(__char_id_table_t* t);
+const uint16_t* zh_char_id_syllable(const __char_id_table_t* t, uint8_t idx, uint8_t syl);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
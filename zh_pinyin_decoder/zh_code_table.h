@@ -23,6 +23,7 @@ extern "C" {
 #endif // __cplusplus
 
 #include <stdint.h>
+#include <stddef.h>
 
 typedef struct {
     const uint8_t   table_length;       // length of code table 
@@ -2,16 +2,26 @@
  ***************************** Declaration ********************************
  * @file           : zh_hash_boost.h
  * @author         : FriedParrot (https://github.com/FriedParrot)
- * @version        : v1.2
- * @date           : 2024-08-24  (last modified)
- * @brief          : hash code table file for pinyins match
+ * @version        : v1.3
+ * @date           : 2024-10-06  (last modified)
+ * @brief          : minimal perfect hash of pinyin syllable prefixes
  * @license        : MIT license (https://opensource.org/license/mit)
  *****************************************************************************
  * @attention
  * this file is need when option USE_ZH_HASH_BOOST is set to 1
- * using this option would cost 2kb more ROM space but can search much faster
+ * using this option would cost about 8kb more ROM space but can search much faster
  *
- * @warning don't modify this file, or decoding would not work correctly
+ * every prefix of the syllables in code_index ("z", "zh", "zho", "zhong" ...) is 
+ * a key of the hash. one probe gives the index of the syllable equal to the key 
+ * and the sequence of other syllables starting with the key (vague match range).
+ * the tables are in zh_hash_table.c, generated from code_index by tools/zh_hash_gen.c
+ * (hash and displace : bucket = h % disp_num, slot = zh_hash_slot(h, disp[bucket]))
+ *
+ * the entries are also the nodes of a syllable prefix automaton : zh_syl_step()
+ * moves from a node to the entry of key + c, so one forward walk from a position
+ * of input gives all the syllable prefixes it starts with, without comparing strings.
+ *
+ * @warning regenerate zh_hash_table.c after modifying the code table
  *****************************************************************************
  */
 #ifndef __ZH_HASH_BOOST_H
@@ -24,16 +34,53 @@
 #include <stdint.h>
 #include  <stdlib.h>
 
-#define ZH_HASH_TABLE_DIV     11
+#define ZH_HASH_KEY_MAX_LEN     6       /* zhuang, chuang */
+
+typedef struct zh_hash_entry_t{
+    uint8_t  syl;           /* index of a syllable starting with the key (to verify the key) */
+    uint8_t  len;           /* key length */
+    int8_t   prec;          /* index of the syllable equal to key, -1 if not exist */
+    uint8_t  vague_num;     /* number of other syllables starting with the key */
+    uint16_t vague_start;   /* start of these syllables in zh_hash_vague_idx */
+}__zh_hash_entry_t;
+
+extern const uint16_t zh_hash_disp_num;
+extern const uint16_t zh_hash_entry_num;
+extern const uint16_t zh_hash_disp[];
+extern const __zh_hash_entry_t zh_hash_entry[];
+extern const uint8_t  zh_hash_vague_idx[];
 
-typedef struct zh_hash_node_t{
-    uint8_t num;
-    uint8_t* idx_list;
-}__zh_hash_node_t;
+#define ZH_SYL_ROOT     ((int16_t)zh_hash_entry_num)   /* root node of automaton (empty key) */
+
+typedef struct zh_syl_node_t{
+    uint32_t child_mask;    /* bit c : key + ('a' + c) is a key */
+    uint16_t child_base;    /* start of children in zh_syl_child */
+}__zh_syl_node_t;
+
+extern const __zh_syl_node_t zh_syl_node[];
+extern const uint16_t zh_syl_child[];
+
+/* FNV-1a hash of key (also used by tools/zh_hash_gen.c, regenerate the tables if it's changed) */
+static inline uint32_t zh_hash_key(const char* str, uint8_t len) {
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < len; i++) {
+        h ^= (uint8_t)str[i];
+        h *= 16777619u;
+    }
+    return h;
+}
 
-extern const __zh_hash_node_t** hash_list[];
+/* slot of key hash h with displacement disp, in [0, num) */
+static inline uint16_t zh_hash_slot(uint32_t h, uint16_t disp, uint16_t num) {
+    h ^= disp * 0x9E3779B9u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return (uint16_t)(h % num);
+}
 
-uint8_t zh_hash_inlist(const char* str);
+const __zh_hash_entry_t* zh_hash_find(const char* str, uint8_t len);
+int16_t zh_syl_step(int16_t node, char c);
 
 #ifdef __cplusplus
     }
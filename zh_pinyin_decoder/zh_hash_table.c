@@ -0,0 +1,1098 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_hash_table.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @brief          : syllable prefix hash tables (generated by tools/zh_hash_gen.c)
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_HASH_BOOST is set to 1
+ * 491 keys, 123 displacements, 905 vague sequence indexes, 491 trie edges
+ *
+ * @warning generated file, don't modify it. run zh_hash_gen after modifying code table
+ *****************************************************************************
+ */
+#include  "zh_hash_boost.h"
+
+const uint16_t zh_hash_disp_num = 123;
+const uint16_t zh_hash_entry_num = 491;
+
+const uint16_t zh_hash_disp[123] = {
+    9,71,2,39,8,8,461,28,16,50,81,104,0,12,11,77,
+    0,93,22,0,270,2,25,47,13,107,65,144,237,429,67,8,
+    481,4,0,11,0,6,35,1,8,60,54,341,3,1,133,171,
+    4,6,69,0,2,1,27,5,0,33,41,51,7,6,425,0,
+    113,17,2,24,1,160,502,56,192,66,7,16,11,316,369,483,
+    190,1568,220,48,1,34,72,242,0,463,1009,938,1961,197,4,12,
+    16,430,0,343,8373,48,58,4945,27,650,8621,122,135,11,1909,2,
+    0,0,1200,12,93,79,342,110,2,89,424
+};
+
+/* { syl, len, prec, vague_num, vague_start }  key */
+const __zh_hash_entry_t zh_hash_entry[491] = {
+    {  3, 3,  3,  1,  430 }, /* man */
+    { 18, 3, 18,  0,  280 }, /* huo */
+    { 16, 4, 16,  0,  280 }, /* hong */
+    {  4, 4,  4,  0,  341 }, /* kuai */
+    {  0, 4,  0,  0,  296 }, /* juan */
+    {  2, 2, -1,  3,  587 }, /* ra */
+    { 19, 3, 19,  0,  116 }, /* cun */
+    { 17, 2, -1, 20,  862 }, /* zh */
+    { 13, 2, 13,  7,  483 }, /* ni */
+    { 10, 4, 10,  0,  777 }, /* xing */
+    {  8, 4,  8,  0,  162 }, /* deng */
+    { 12, 3, 12,  0,  108 }, /* chi */
+    {  2, 3,  2,  0,  430 }, /* mai */
+    { 14, 2, 14,  0,   38 }, /* bo */
+    {  0, 2, 14,  3,  794 }, /* yu */
+    { 16, 2, 16,  0,  534 }, /* pu */
+    { 11, 4, 11,  0,  483 }, /* neng */
+    {  7, 3,  7,  0,  194 }, /* fou */
+    {  4, 3,  4,  1,  158 }, /* dan */
+    {  3, 2, -1,  3,  189 }, /* fe */
+    {  1, 3,  1,  3,  264 }, /* hua */
+    { 21, 3, 21,  0,  678 }, /* sai */
+    {  8, 2,  8,  0,  745 }, /* wu */
+    {  1, 2,  1,  0,  177 }, /* en */
+    {  6, 3,  6,  1,  593 }, /* ren */
+    { 10, 2, 10,  4,  718 }, /* ti */
+    {  0, 1,  0,  4,    0 }, /* a */
+    {  5, 4,  5,  1,  564 }, /* qian */
+    { 14, 4, 14,  0,  725 }, /* ting */
+    {  5, 3,  5,  1,   29 }, /* ben */
+    { 14, 3, 14,  1,  443 }, /* min */
+    { 11, 3, 11,  1,  348 }, /* ken */
+    { 10, 2, 10,  6,  162 }, /* di */
+    {  0, 4,  0,  0,  763 }, /* xuan */
+    {  0, 1, -1, 15,  779 }, /* y */
+    {  1, 3,  1,  1,  188 }, /* fan */
+    {  0, 2, 11,  4,  582 }, /* ru */
+    {  6, 4,  6,  1,  104 }, /* chan */
+    {  8, 3,  8,  1,  272 }, /* han */
+    { 23, 4, 23,  0,  121 }, /* cang */
+    {  4, 3,  4,  0,  521 }, /* pao */
+    {  6, 3,  6,  0,  345 }, /* kai */
+    {  1, 4,  1,  1,  223 }, /* guan */
+    {  3, 3,  3,  0,  854 }, /* zai */
+    {  1, 3,  1,  0,  710 }, /* tun */
+    { 20, 3, 20,  0,  174 }, /* duo */
+    {  9, 3,  9,  0,  596 }, /* rou */
+    {  7, 3,  7,  0,  272 }, /* hai */
+    { 21, 5, 21,  0,  893 }, /* zhuai */
+    {  0, 1, -1, 22,  127 }, /* d */
+    {  1, 4,  1,  0,  474 }, /* nuan */
+    { 18, 2, 31,  4,  111 }, /* cu */
+    { 15, 2, -1,  2,  277 }, /* ho */
+    {  0, 1, -1, 18,  312 }, /* k */
+    {  1, 2, 24,  3,  470 }, /* nu */
+    {  7, 2,  7,  0,  802 }, /* ye */
+    {  2, 5,  2,  0,  341 }, /* kuang */
+    {  0, 2, 19,  4,  149 }, /* du */
+    { 12, 3, 12,  0,  483 }, /* nei */
+    { 33, 4, -1,  1,  904 }, /* zhon */
+    { 13, 3, 13,  0,  233 }, /* gei */
+    {  4, 3,  4,  0,  268 }, /* hun */
+    { 13, 3, 13,  0,  724 }, /* tie */
+    { 14, 2, -1,  2,  233 }, /* go */
+    {  5, 4,  5,  0,  159 }, /* dang */
+    { 17, 4, 17,  3,  889 }, /* zhua */
+    {  0, 2, 16,  7,  213 }, /* gu */
+    { 32, 4, 32,  0,  904 }, /* zhou */
+    {  0, 4,  0,  0,  798 }, /* yuan */
+    {  0, 2, -1, 18,   72 }, /* ch */
+    {  0, 4,  0,  0,  710 }, /* tuan */
+    { 12, 5, 12,  0,  668 }, /* sheng */
+    {  6, 2,  6,  4,  268 }, /* ha */
+    { 11, 3, 11,  0,   37 }, /* bie */
+    {  3, 3,  3,  1,  192 }, /* fen */
+    {  2, 5,  2,  0,  224 }, /* guang */
+    {  3, 2,  3,  9,  763 }, /* xi */
+    { 29, 2, -1,  2,  124 }, /* co */
+    { 13, 3, 13,  0,  443 }, /* mie */
+    {  4, 2,  4,  4,  383 }, /* la */
+    { 28, 4, 28,  1,  901 }, /* zhen */
+    { 14, 2, 14,  1,  533 }, /* po */
+    {  9, 4,  9,  0,  665 }, /* shao */
+    { 16, 3, -1,  1,  727 }, /* ton */
+    { 23, 4, 23,  0,  897 }, /* zhai */
+    { 30, 4, 30,  0,  685 }, /* song */
+    {  3, 3,  3,  3,  305 }, /* jia */
+    {  0, 5,  0,  1,   99 }, /* chuan */
+    {  6, 2,  6,  3,  431 }, /* me */
+    {  2, 3,  2,  1,  520 }, /* pan */
+    {  7, 3,  7,  0,   30 }, /* bei */
+    { 10, 3, 10,  2,  665 }, /* she */
+    { 12, 3, 12,  0,  568 }, /* qiu */
+    {  2, 3,  2,  1,  740 }, /* wan */
+    {  5, 4,  5,  0,  104 }, /* chai */
+    {  3, 5,  3,  0,  268 }, /* huang */
+    { 11, 3, 11,  0,  312 }, /* jiu */
+    {  1, 3,  1,  0,  798 }, /* yue */
+    { 15, 2, 15,  0,   38 }, /* bu */
+    {  8, 3,  8,  0,  479 }, /* nao */
+    {  5, 2,  5,  2,  591 }, /* re */
+    { 16, 5, 16,  0,  494 }, /* niang */
+    { 13, 3, -1,  1,  807 }, /* yon */
+    {  3, 4,  3,  0,   26 }, /* bang */
+    { 17, 3, 34,  7,  882 }, /* zhu */
+    {  5, 4,  5,  0,  745 }, /* weng */
+    { 25, 2, 25,  2,  679 }, /* se */
+    {  8, 2,  8,  5,   30 }, /* bi */
+    {  5, 3,  5,  0,  193 }, /* fei */
+    { 17, 3, 17,  0,  494 }, /* nie */
+    { 14, 3, -1,  3,  490 }, /* nia */
+    {  7, 3,  7,  1,  345 }, /* kan */
+    {  2, 3,  2,  0,  474 }, /* nue */
+    { 23, 3, -1,  1,  497 }, /* non */
+    {  0, 1, -1, 14,  568 }, /* r */
+    {  8, 5,  8,  0,  665 }, /* shang */
+    {  0, 2,  0,  4,  516 }, /* pa */
+    { 11, 3, -1,  1,  566 }, /* qio */
+    {  0, 3, -1,  1,  797 }, /* yua */
+    { 12, 4, 12,  0,  349 }, /* keng */
+    {  8, 2,  8,  0,  594 }, /* ri */
+    {  7, 3,  7,  1,  228 }, /* gan */
+    {  5, 4,  5,  0,  715 }, /* tang */
+    { 14, 3, 14,  0,  235 }, /* gou */
+    {  7, 2,  7,  2,  159 }, /* de */
+    {  9, 3,  9,  1,  776 }, /* xin */
+    { 23, 4, 23,  0,  407 }, /* long */
+    { 15, 4, 15,  0,  171 }, /* ding */
+    {  7, 3,  7,  0,  525 }, /* pei */
+    {  2, 3,  2,  0,  763 }, /* xun */
+    { 11, 4, -1,  1,  778 }, /* xion */
+    {  3, 3,  3,  0,  714 }, /* tai */
+    {  4, 3,  4,  3,  772 }, /* xia */
+    {  4, 3,  4,  1,  801 }, /* yan */
+    {  3, 2,  3,  0,  177 }, /* er */
+    {  9, 3,  9,  0,  435 }, /* mei */
+    { 10, 5, 10,  0,  312 }, /* jiong */
+    {  5, 3,  5,  4,  660 }, /* sha */
+    { 29, 2, -1,  2,  682 }, /* so */
+    { 15, 2, -1,  2,  725 }, /* to */
+    { 10, 3, 10,  1,  482 }, /* nen */
+    {  8, 3, -1,  1,  717 }, /* ten */
+    {  3, 2,  3,  9,  552 }, /* qi */
+    { 30, 3, -1,  1,  126 }, /* con */
+    { 11, 4, -1,  1,  567 }, /* qion */
+    { 27, 4, 27,  0,  124 }, /* ceng */
+    { 13, 3, 13,  0,  597 }, /* rui */
+    { 13, 3, 13,  3,  399 }, /* lia */
+    { 11, 3, 11,  2,  168 }, /* dia */
+    {  0, 1, -1,  9,  728 }, /* w */
+    {  7, 3,  7,  0,  309 }, /* jie */
+    {  7, 2,  7,  2,  715 }, /* te */
+    { 10, 3, 10,  0,  273 }, /* hao */
+    { 14, 3, -1,  1,  351 }, /* kon */
+    { 12, 4, 12,  0,  233 }, /* geng */
+    {  3, 4,  3,  0,  660 }, /* shun */
+    {  7, 4,  7,  0,  388 }, /* lang */
+    { 18, 2, 31,  4,  669 }, /* su */
+    { 12, 3, 12,  1,  532 }, /* pin */
+    {  8, 3,  8,  1,  309 }, /* jin */
+    { 18, 3, 18,  0,  236 }, /* gui */
+    {  2, 3,  2,  1,   25 }, /* ban */
+    {  9, 3,  9,  0,  229 }, /* gao */
+    { 20, 3, 20,  0,  404 }, /* liu */
+    { 11, 3, 11,  0,  391 }, /* lei */
+    {  3, 2,  3,  0,  383 }, /* lv */
+    {  5, 2,  5,  4,  341 }, /* ka */
+    {  6, 5,  6,  0,  309 }, /* jiang */
+    { 13, 2, -1,  2,  349 }, /* ko */
+    { 27, 3, 27,  3,  898 }, /* zhe */
+    { 10, 4, -1,  1,  311 }, /* jion */
+    { 18, 3, 18,  1,  494 }, /* nin */
+    {  1, 3,  1,  0,  520 }, /* pai */
+    {  5, 4,  5,  0,  309 }, /* jiao */
+    { 25, 3, 25,  0,  407 }, /* luo */
+    {  1, 3,  1,  0,   25 }, /* bai */
+    {  5, 3,  5,  0,  387 }, /* lai */
+    { 21, 2, 21,  2,  404 }, /* lo */
+    { 31, 3, 31,  0,  902 }, /* zhi */
+    {  2, 3,  2,  0,  383 }, /* lun */
+    { 15, 4, 15,  0,  236 }, /* gong */
+    { 10, 4, 10,  1,  107 }, /* chen */
+    { 13, 4, 13,  0,   38 }, /* bing */
+    { 10, 4, 10,  0,  566 }, /* qing */
+    { 13, 4, 13,  0,  170 }, /* diao */
+    { 13, 3, -1,  1,  861 }, /* zon */
+    { 14, 3, -1,  1,  724 }, /* tin */
+    { 16, 3, 16,  0,  352 }, /* kuo */
+    {  2, 6,  2,  0,  660 }, /* shuang */
+    { 22, 3, 22,  1,  678 }, /* san */
+    {  4, 4,  4,  0,  224 }, /* guai */
+    {  0, 1, -1, 26,  352 }, /* l */
+    {  6, 3,  6,  0,  745 }, /* wei */
+    {  1, 3,  1,  0,  850 }, /* zun */
+    {  1, 2, 17,  7,  257 }, /* hu */
+    { 18, 3, -1,  1,  673 }, /* sua */
+    {  0, 1, -1, 20,  236 }, /* h */
+    { 15, 3, -1,  1,  235 }, /* gon */
+    { 18, 3, -1,  1,  173 }, /* don */
+    { 10, 2, 10,  2,  346 }, /* ke */
+    {  3, 3,  3,  0,    5 }, /* ang */
+    { 35, 4, 35,  0,  905 }, /* zhuo */
+    { 32, 3, -1,  2,  902 }, /* zho */
+    { 20, 3, 20,  0,  495 }, /* niu */
+    { 13, 4, 13,  0,  862 }, /* zong */
+    { 27, 4, 27,  0,  682 }, /* seng */
+    {  0, 1, -1, 13,  280 }, /* j */
+    {  1, 3,  1,  0,  763 }, /* xue */
+    {  8, 4,  8,  0,  105 }, /* chao */
+    {  6, 3,  6,  1,  387 }, /* lan */
+    { 10, 3, 10,  0,  859 }, /* zei */
+    { 12, 2, -1,  2,  859 }, /* zo */
+    {  0, 4,  0,  0,  383 }, /* luan */
+    {  7, 4,  7,  0,  594 }, /* reng */
+    { 11, 4, 11,  1,  667 }, /* shen */
+    {  1, 3,  1,  0,  154 }, /* dun */
+    {  2, 4,  2,  0,  189 }, /* fang */
+    {  6, 3,  6,  0,  802 }, /* yao */
+    {  3, 2,  3,  0,  474 }, /* nv */
+    {  8, 2,  8,  5,  525 }, /* pi */
+    { 15, 3, 15,  0,  862 }, /* zuo */
+    {  0, 3, -1,  1,  153 }, /* dua */
+    { 12, 4, 12,  0,  170 }, /* dian */
+    { 22, 2, -1,  2,  495 }, /* no */
+    {  9, 4,  9,  0,   37 }, /* bian */
+    { 13, 4, 13,  0,  533 }, /* ping */
+    { 13, 4, 13,  0,  277 }, /* heng */
+    { 11, 5, 11,  0,  108 }, /* cheng */
+    {  0, 3, -1,  1,  762 }, /* xua */
+    {  2, 2,  2,  4,  710 }, /* ta */
+    {  1, 2,  1,  0,    4 }, /* ai */
+    { 16, 5, 16,  0,  403 }, /* liang */
+    {  9, 4,  9,  0,  532 }, /* pian */
+    {  8, 2,  8,  0,  194 }, /* fu */
+    { 28, 2, 28,  0,  682 }, /* si */
+    { 11, 4, 11,  0,  443 }, /* mian */
+    { 15, 3, 15,  0,  279 }, /* hou */
+    { 24, 3, 24,  0,  121 }, /* cao */
+    {  2, 4,  2,  1,  267 }, /* huan */
+    { 22, 3, 22,  1,  120 }, /* can */
+    {  0, 2, 12,  2,  293 }, /* ju */
+    { 36, 4, 36,  0,  905 }, /* zhui */
+    {  1, 3,  1,  0,  587 }, /* run */
+    { 14, 3, 14,  0,  277 }, /* hei */
+    { 10, 4, 10,  0,  391 }, /* leng */
+    {  0, 2, 13,  3,  759 }, /* xu */
+    {  5, 3,  5,  0,  431 }, /* mao */
+    { 18, 5, 18,  1,  892 }, /* zhuan */
+    {  2, 2,  2,  9,  296 }, /* ji */
+    { 18, 3, 18,  0,  445 }, /* mou */
+    {  0, 4,  0,  0,  552 }, /* quan */
+    { 15, 4, 15,  0,  444 }, /* ming */
+    {  0, 3, -1,  1,  382 }, /* lua */
+    { 14, 5, 14,  0,  111 }, /* chong */
+    { 18, 4, 18,  0,  674 }, /* suan */
+    { 18, 3, 18,  0,  728 }, /* tuo */
+    {  3, 4,  3,  0,  521 }, /* pang */
+    {  0, 1, -1, 19,  194 }, /* g */
+    { 26, 3, 26,  1,  123 }, /* cen */
+    { 12, 4, 12,  0,  724 }, /* tiao */
+    { 21, 3, 21,  0,  120 }, /* cai */
+    {  3, 3,  3,  0,  224 }, /* gun */
+    { 18, 4, 18,  0,  174 }, /* dong */
+    {  7, 5,  7,  0,  105 }, /* chang */
+    { 11, 2, 11,  0,  859 }, /* zi */
+    { 25, 3, 25,  0,  498 }, /* nuo */
+    { 18, 3, 18,  1,  403 }, /* lin */
+    {  3, 3,  3,  0,  341 }, /* kun */
+    {  0, 1,  0, 19,  407 }, /* m */
+    {  5, 4,  5,  0,  268 }, /* huai */
+    { 21, 2, 21,  0,  495 }, /* ng */
+    {  0, 3, -1,  1,  586 }, /* rua */
+    {  6, 3,  6,  1,  478 }, /* nan */
+    { 15, 3, 15,  0,  727 }, /* tou */
+    { 23, 4, 23,  0,  498 }, /* nong */
+    {  8, 3,  8,  0,  388 }, /* lao */
+    {  5, 4,  5,  0,  802 }, /* yang */
+    { 26, 4, 26,  0,  898 }, /* zhao */
+    {  8, 3,  8,  1,  858 }, /* zen */
+    { 10, 4, 10,  0,   37 }, /* biao */
+    { 13, 3, 13,  0,  668 }, /* shi */
+    {  0, 1, -1,  9,  177 }, /* f */
+    { 11, 3, -1,  2,  441 }, /* mia */
+    { 30, 3, -1,  1,  684 }, /* son */
+    {  4, 3,  4,  3,  561 }, /* qia */
+    {  2, 4,  2,  0,  100 }, /* chun */
+    { 19, 3, 19,  0,  280 }, /* hui */
+    { 13, 3, -1,  2,  108 }, /* cho */
+    {  2, 2,  2,  0,  177 }, /* ei */
+    { 16, 4, 16,  0,  669 }, /* shuo */
+    {  3, 4,  3,  0,  591 }, /* rang */
+    { 10, 3, -1,  1,  596 }, /* ron */
+    {  9, 3,  9,  1,  565 }, /* qin */
+    {  1, 6,  1,  0,  100 }, /* chuang */
+    { 11, 3, -1,  2,  722 }, /* tia */
+    { 22, 3, 22,  4,  893 }, /* zha */
+    {  0, 1,  0,  3,  174 }, /* e */
+    { 29, 3, 29,  0,  126 }, /* cou */
+    { 15, 3, -1,  1,  170 }, /* din */
+    {  6, 3,  6,  0,  159 }, /* dao */
+    {  1, 5,  1,  1,  659 }, /* shuan */
+    { 11, 4, 11,  0,  724 }, /* tian */
+    { 16, 3, 16,  0,  444 }, /* miu */
+    { 14, 4, 14,  1,  402 }, /* lian */
+    { 25, 5, 25,  0,  898 }, /* zhang */
+    {  9, 3,  9,  2,  105 }, /* che */
+    {  8, 4,  8,  0,  435 }, /* meng */
+    { 12, 3, 12,  1,  276 }, /* hen */
+    {  5, 3,  5,  1,  524 }, /* pen */
+    {  9, 3,  9,  1,  804 }, /* yin */
+    {  3, 5,  3,  0,  100 }, /* chuai */
+    { 11, 2, 11,  3,  273 }, /* he */
+    { 12, 3, 12,  0,  861 }, /* zou */
+    { 16, 3, 16,  0,  862 }, /* zui */
+    { 10, 2, 10,  6,  435 }, /* mi */
+    {  9, 3,  9,  0,  346 }, /* kao */
+    {  5, 4,  5,  1,  775 }, /* xian */
+    {  4, 4,  4,  0,  193 }, /* feng */
+    {  9, 2,  9,  2,  388 }, /* le */
+    {  0, 1, -1, 34,  597 }, /* s */
+    {  4, 4,  4,  0,  431 }, /* mang */
+    { 15, 3, 15,  0,  534 }, /* pou */
+    {  0, 3, -1,  1,  709 }, /* tua */
+    {  4, 2, -1,  3,  741 }, /* we */
+    { 16, 4, 16,  0,  111 }, /* chuo */
+    { 22, 3, 22,  0,  406 }, /* lou */
+    {  0, 3, -1,  1,  295 }, /* jua */
+    { 13, 4, 13,  0,  110 }, /* chou */
+    { 10, 4, 10,  0,  597 }, /* rong */
+    {  6, 4,  6,  0,  525 }, /* peng */
+    {  0, 2, 24,  4,  378 }, /* lu */
+    {  1, 2,  1,  0,  499 }, /* ou */
+    {  1, 3, -1,  1,  473 }, /* nua */
+    { 17, 4, 17,  0,  111 }, /* chui */
+    { 17, 3, 17,  0,  236 }, /* guo */
+    { 11, 5, 11,  0,  779 }, /* xiong */
+    {  4, 2,  4,  4,  474 }, /* na */
+    {  0, 2, 17,  4,  705 }, /* tu */
+    {  0, 4, -1,  3,   96 }, /* chua */
+    {  3, 3,  3,  0,  158 }, /* dai */
+    { 19, 6, 19,  0,  893 }, /* zhuang */
+    {  8, 4,  8,  0,  346 }, /* kang */
+    { 12, 3, 12,  1,   37 }, /* bin */
+    {  0, 1, -1, 37,  808 }, /* z */
+    {  5, 2, -1,  3,  521 }, /* pe */
+    {  1, 3,  1,  0,  740 }, /* wai */
+    {  0, 1, -1, 34,   38 }, /* c */
+    {  3, 2,  3,  3,  798 }, /* ya */
+    { 23, 4, 23,  0,  679 }, /* sang */
+    {  6, 2,  6,  1,  193 }, /* fo */
+    { 26, 3, 26,  1,  681 }, /* sen */
+    { 21, 3, 21,  0,  174 }, /* dui */
+    {  0, 4,  0,  0,  850 }, /* zuan */
+    {  0, 2, -1,  1,  256 }, /* hn */
+    {  1, 3,  1,  0,  552 }, /* que */
+    { 18, 3, -1,  1,  115 }, /* cua */
+    {  8, 3, -1,  1,  161 }, /* den */
+    {  8, 3,  8,  0,  776 }, /* xie */
+    { 14, 4, 14,  0,  352 }, /* kong */
+    {  5, 4,  5,  0,  855 }, /* zang */
+    { 20, 4, 20,  0,  893 }, /* zhun */
+    { 14, 3, 14,  0,  170 }, /* die */
+    {  8, 3,  8,  0,  565 }, /* qie */
+    {  6, 3,  6,  0,  715 }, /* tao */
+    {  0, 1, -1, 17,  499 }, /* p */
+    { 16, 4, 16,  0,  728 }, /* tong */
+    {  4, 3,  4,  1,  744 }, /* wen */
+    { 19, 2, 19,  0,  445 }, /* mu */
+    {  8, 4,  8,  0,  229 }, /* gang */
+    {  4, 3,  4,  0,   26 }, /* bao */
+    {  9, 3, -1,  2,   35 }, /* bia */
+    {  9, 2,  9,  3,  479 }, /* ne */
+    {  0, 2, -1, 18,  631 }, /* sh */
+    { 32, 3, 32,  0,  685 }, /* suo */
+    {  6, 3,  6,  0,  228 }, /* gai */
+    {  7, 5,  7,  0,  565 }, /* qiang */
+    {  5, 2, -1,  3,   26 }, /* be */
+    {  9, 3,  9,  0,  162 }, /* dei */
+    {  0, 2, 14,  4,  845 }, /* zu */
+    {  2, 2,  2,  1,    4 }, /* an */
+    { 17, 2, 17,  1,  444 }, /* mo */
+    { 10, 2, 10,  3,  229 }, /* ge */
+    {  9, 3,  9,  0,  718 }, /* tei */
+    {  0, 3, -1,  1,  849 }, /* zua */
+    { 24, 4, 24,  1,  897 }, /* zhan */
+    {  4, 2,  4,  0,    5 }, /* ao */
+    { 12, 3, 12,  0,  597 }, /* ruo */
+    { 14, 4, 14,  0,  669 }, /* shou */
+    {  3, 4,  3,  0,  741 }, /* wang */
+    {  7, 2,  7,  3,  855 }, /* ze */
+    {  5, 2,  5,  4,  224 }, /* ga */
+    {  0, 1, -1, 16,    5 }, /* b */
+    {  0, 1, -1, 14,  745 }, /* x */
+    { 30, 4, 30,  0,  127 }, /* cong */
+    {  4, 3,  4,  1,  854 }, /* zan */
+    { 16, 3, 16,  0,  171 }, /* diu */
+    {  0, 4,  0,  3,  656 }, /* shua */
+    { 22, 3, 22,  0,  497 }, /* nou */
+    { 12, 4, 12,  0,  443 }, /* miao */
+    { 23, 3, -1,  1,  406 }, /* lon */
+    {  4, 3,  4,  1,  714 }, /* tan */
+    {  0, 1,  0, 25,  445 }, /* n */
+    {  0, 4,  0,  0,  587 }, /* ruan */
+    { 11, 3, 11,  0,  532 }, /* pie */
+    { 19, 4, 19,  0,  495 }, /* ning */
+    {  9, 2, -1,  2,  594 }, /* ro */
+    { 20, 2, 20,  4,  116 }, /* ca */
+    {  2, 2,  2,  4,  850 }, /* za */
+    { 13, 3, 13,  0,  351 }, /* kou */
+    {  7, 4,  7,  0,  479 }, /* nang */
+    {  6, 3,  6,  0,  855 }, /* zao */
+    { 29, 5, 29,  0,  902 }, /* zheng */
+    { 12, 3, 12,  0,  807 }, /* you */
+    {  1, 3,  1,  0,  383 }, /* lue */
+    {  8, 4,  8,  0,  718 }, /* teng */
+    {  7, 5,  7,  0,  776 }, /* xiang */
+    { 33, 3, 33,  0,  127 }, /* cui */
+    { 30, 4, 30,  0,  902 }, /* zhei */
+    { 14, 3, -1,  1,  668 }, /* sho */
+    { 17, 4, 17,  0,  669 }, /* shui */
+    { 10, 4, 10,  0,  532 }, /* piao */
+    {  4, 5,  4,  0,  660 }, /* shuai */
+    {  6, 4,  6,  0,   30 }, /* beng */
+    {  0, 3,  0,  0,  257 }, /* hng */
+    { 17, 2, -1,  2,  171 }, /* do */
+    { 17, 3, 17,  0,  173 }, /* dou */
+    { 19, 3, 19,  0,  674 }, /* sun */
+    {  5, 3,  5,  0,  478 }, /* nai */
+    {  0, 2,  0,  2,  186 }, /* fa */
+    {  1, 2,  1,  4,  426 }, /* ma */
+    {  9, 4,  9,  0,  273 }, /* hang */
+    {  0, 2,  0,  3,  737 }, /* wa */
+    { 13, 4, 13,  0,  808 }, /* yong */
+    { 15, 4, 15,  0,  403 }, /* liao */
+    { 12, 2, 12,  8,  391 }, /* li */
+    { 10, 3, -1,  1,  310 }, /* jio */
+    {  2, 3,  2,  1,  590 }, /* ran */
+    { 33, 3, 33,  0,  685 }, /* sui */
+    { 12, 3, 12,  0,  779 }, /* xiu */
+    {  7, 2,  7,  0,  745 }, /* wo */
+    {  0, 3, -1,  1,  551 }, /* qua */
+    { 32, 3, 32,  0,  127 }, /* cuo */
+    { 14, 4, 14,  1,  493 }, /* nian */
+    { 14, 4, -1,  1,  110 }, /* chon */
+    {  6, 4,  6,  0,  565 }, /* qiao */
+    {  2, 2,  2,  4,  154 }, /* da */
+    { 16, 3, -1,  1,  279 }, /* hon */
+    {  8, 2,  8,  2,  802 }, /* yi */
+    { 18, 4, 18,  0,  116 }, /* cuan */
+    {  0, 3, 15,  6,   90 }, /* chu */
+    { 11, 3, -1,  1,  777 }, /* xio */
+    {  9, 4,  9,  0,  859 }, /* zeng */
+    {  6, 4,  6,  0,  664 }, /* shai */
+    {  0, 2, 13,  3,  548 }, /* qu */
+    {  0, 3,  0,  3,  220 }, /* gua */
+    {  4, 3,  4,  4,  100 }, /* cha */
+    {  0, 3, 15,  7,  649 }, /* shu */
+    {  0, 2, 15,  7,  330 }, /* ku */
+    { 33, 5, 33,  0,  905 }, /* zhong */
+    { 11, 5, 11,  0,  568 }, /* qiong */
+    {  9, 3, -1,  2,  530 }, /* pia */
+    { 11, 3, 11,  1,  232 }, /* gen */
+    {  9, 4,  9,  0,  310 }, /* jing */
+    { 17, 3, 17,  0,  403 }, /* lie */
+    { 29, 3, 29,  0,  684 }, /* sou */
+    { 28, 2, 28,  0,  124 }, /* ci */
+    { 15, 4, 15,  0,  494 }, /* niao */
+    {  0, 1, -1, 14,  534 }, /* q */
+    {  7, 3,  7,  1,  434 }, /* men */
+    {  4, 3,  4,  0,  591 }, /* rao */
+    { 25, 2, 25,  2,  121 }, /* ce */
+    { 19, 4, 19,  0,  404 }, /* ling */
+    {  4, 4,  4,  1,  308 }, /* jian */
+    { 10, 4, 10,  0,  805 }, /* ying */
+    {  0, 1, -1, 20,  685 }, /* t */
+    { 17, 3, 17,  0,  352 }, /* kui */
+    {  1, 3,  1,  0,  296 }, /* jue */
+    {  0, 2,  0,  4,   21 }, /* ba */
+    {  0, 4,  0,  0,  154 }, /* duan */
+    {  1, 4,  1,  1,  340 }, /* kuan */
+    { 19, 3, 19,  0,  728 }, /* tui */
+    { 11, 2, 11,  2,  805 }, /* yo */
+    {  0, 1,  0,  1,  498 }, /* o */
+    {  2, 3,  2,  0,  798 }, /* yun */
+    {  6, 4,  6,  0,  776 }, /* xiao */
+    { 24, 3, 24,  0,  679 }, /* sao */
+    {  2, 3,  2,  0,  552 }, /* qun */
+    {  0, 3,  0,  3,  337 }, /* kua */
+    { 10, 3, -1,  1,  390 }, /* len */
+    { 20, 2, 20,  4,  674 }, /* sa */
+    {  7, 4,  7,  1,  664 }, /* shan */
+};
+
+/* vague search sequence of each key (syllable index in code_index) */
+const uint8_t zh_hash_vague_idx[905] = {
+    1,2,3,4,3,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,3,1,2,
+    4,3,6,7,5,6,9,10,13,11,12,9,10,13,0,1,2,3,4,5,6,7,8,9,
+    10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,
+    1,7,11,14,3,0,5,6,8,10,13,17,2,16,4,9,12,15,1,3,0,17,2,16,
+    1,3,0,1,7,5,6,8,7,11,10,11,14,13,14,18,33,19,32,18,23,21,22,24,
+    23,27,26,27,30,29,30,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,
+    17,18,19,20,21,0,21,1,20,0,5,3,4,6,5,8,9,8,12,13,15,11,14,16,
+    12,13,15,18,17,18,1,2,3,0,1,2,3,4,5,6,7,8,2,1,2,4,5,3,
+    4,7,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,2,4,1,
+    0,18,3,17,2,4,1,2,8,6,7,9,8,12,13,11,12,15,14,15,0,1,2,3,
+    4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,0,3,5,2,1,19,4,18,
+    3,5,2,3,9,7,8,10,9,13,14,12,13,16,15,16,0,1,2,3,4,5,6,7,
+    8,9,10,11,12,0,1,0,6,10,4,5,9,3,7,8,11,6,4,5,6,9,10,10,
+    0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,2,4,1,0,17,3,
+    16,2,4,1,2,8,6,7,9,8,12,11,12,14,13,14,0,1,2,3,4,5,6,7,
+    8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,0,1,2,25,0,7,
+    5,6,8,7,10,11,10,16,14,15,19,13,17,18,20,16,14,15,16,19,23,22,23,1,
+    2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,4,2,3,5,4,8,
+    9,7,8,11,12,15,13,14,16,11,12,15,18,1,2,3,4,5,6,7,8,9,10,11,
+    12,13,14,15,16,17,18,19,20,21,22,23,24,25,1,2,25,1,7,5,6,8,7,11,
+    12,10,11,16,14,15,19,17,18,20,16,14,15,16,19,23,22,23,1,0,1,2,3,4,
+    5,6,7,8,9,10,11,12,13,14,15,16,3,1,2,4,3,6,7,5,6,9,10,13,
+    11,12,9,10,13,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,0,1,2,0,
+    7,11,5,6,10,4,8,9,12,7,5,6,7,10,11,11,0,1,2,3,4,5,6,7,
+    8,9,10,11,12,13,0,13,1,12,0,3,2,4,3,7,6,7,10,9,10,0,1,2,
+    3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,
+    27,28,29,30,31,32,33,2,8,12,4,1,6,7,9,11,14,0,17,3,16,5,10,13,
+    15,2,4,1,0,17,3,16,2,4,1,2,8,6,7,9,8,12,11,12,14,18,33,19,
+    32,18,23,21,22,24,23,27,26,27,30,29,30,0,1,2,3,4,5,6,7,8,9,10,
+    11,12,13,14,15,16,17,18,19,0,19,1,18,0,5,3,4,6,5,8,9,8,11,12,
+    14,13,11,12,14,16,15,16,0,1,2,3,4,5,6,7,8,3,1,2,3,5,6,4,
+    5,0,1,2,3,4,5,6,7,8,9,10,11,12,13,0,1,2,0,7,11,5,6,10,
+    4,8,9,12,7,5,6,7,10,11,11,0,1,2,3,4,5,6,7,8,9,10,11,12,
+    13,14,0,1,2,0,5,4,6,5,10,9,10,13,12,13,0,1,2,3,4,5,6,7,
+    8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,
+    32,33,34,35,36,0,16,1,15,0,5,3,4,6,5,9,10,8,9,13,12,13,19,25,
+    29,33,21,18,23,24,26,30,28,32,17,36,20,35,22,27,31,34,19,21,18,17,36,20,
+    35,19,21,18,19,25,23,24,26,25,29,30,28,29,33,32,33
+};
+
+/* { child_mask, child_base } of each entry, the last one is root */
+const __zh_syl_node_t zh_syl_node[492] = {
+    { 0x0000040,    0 }, /* man */
+    { 0x0000000,    1 }, /* huo */
+    { 0x0000000,    1 }, /* hong */
+    { 0x0000000,    1 }, /* kuai */
+    { 0x0000000,    1 }, /* juan */
+    { 0x0006000,    1 }, /* ra */
+    { 0x0000000,    3 }, /* cun */
+    { 0x0104111,    3 }, /* zh */
+    { 0x0102011,    8 }, /* ni */
+    { 0x0000000,   12 }, /* xing */
+    { 0x0000000,   12 }, /* deng */
+    { 0x0000000,   12 }, /* chi */
+    { 0x0000000,   12 }, /* mai */
+    { 0x0000000,   12 }, /* bo */
+    { 0x0002011,   12 }, /* yu */
+    { 0x0000000,   15 }, /* pu */
+    { 0x0000000,   15 }, /* neng */
+    { 0x0000000,   15 }, /* fou */
+    { 0x0000040,   15 }, /* dan */
+    { 0x0002100,   16 }, /* fe */
+    { 0x0002100,   18 }, /* hua */
+    { 0x0000000,   20 }, /* sai */
+    { 0x0000000,   20 }, /* wu */
+    { 0x0000000,   20 }, /* en */
+    { 0x0000040,   20 }, /* ren */
+    { 0x0002011,   21 }, /* ti */
+    { 0x0006100,   24 }, /* a */
+    { 0x0000040,   27 }, /* qian */
+    { 0x0000000,   28 }, /* ting */
+    { 0x0000040,   28 }, /* ben */
+    { 0x0000040,   29 }, /* min */
+    { 0x0000040,   30 }, /* ken */
+    { 0x0102011,   31 }, /* di */
+    { 0x0000000,   35 }, /* xuan */
+    { 0x0104111,   35 }, /* y */
+    { 0x0000040,   40 }, /* fan */
+    { 0x0006101,   41 }, /* ru */
+    { 0x0000040,   45 }, /* chan */
+    { 0x0000040,   46 }, /* han */
+    { 0x0000000,   47 }, /* cang */
+    { 0x0000000,   47 }, /* pao */
+    { 0x0000000,   47 }, /* kai */
+    { 0x0000040,   47 }, /* guan */
+    { 0x0000000,   48 }, /* zai */
+    { 0x0000000,   48 }, /* tun */
+    { 0x0000000,   48 }, /* duo */
+    { 0x0000000,   48 }, /* rou */
+    { 0x0000000,   48 }, /* hai */
+    { 0x0000000,   48 }, /* zhuai */
+    { 0x0104111,   48 }, /* d */
+    { 0x0000000,   53 }, /* nuan */
+    { 0x0006101,   53 }, /* cu */
+    { 0x0102000,   57 }, /* ho */
+    { 0x0104011,   59 }, /* k */
+    { 0x0004011,   63 }, /* nu */
+    { 0x0000000,   66 }, /* ye */
+    { 0x0000000,   66 }, /* kuang */
+    { 0x0006101,   66 }, /* du */
+    { 0x0000000,   70 }, /* nei */
+    { 0x0000040,   70 }, /* zhon */
+    { 0x0000000,   71 }, /* gei */
+    { 0x0000000,   71 }, /* hun */
+    { 0x0000000,   71 }, /* tie */
+    { 0x0102000,   71 }, /* go */
+    { 0x0000000,   73 }, /* dang */
+    { 0x0002100,   73 }, /* zhua */
+    { 0x0006101,   75 }, /* gu */
+    { 0x0000000,   79 }, /* zhou */
+    { 0x0000000,   79 }, /* yuan */
+    { 0x0104111,   79 }, /* ch */
+    { 0x0000000,   84 }, /* tuan */
+    { 0x0000000,   84 }, /* sheng */
+    { 0x0006100,   84 }, /* ha */
+    { 0x0000000,   87 }, /* bie */
+    { 0x0000040,   87 }, /* fen */
+    { 0x0000000,   88 }, /* guang */
+    { 0x0106011,   88 }, /* xi */
+    { 0x0102000,   93 }, /* co */
+    { 0x0000000,   95 }, /* mie */
+    { 0x0006100,   95 }, /* la */
+    { 0x0000040,   98 }, /* zhen */
+    { 0x0100000,   99 }, /* po */
+    { 0x0000000,  100 }, /* shao */
+    { 0x0000040,  100 }, /* ton */
+    { 0x0000000,  101 }, /* zhai */
+    { 0x0000000,  101 }, /* song */
+    { 0x0006000,  101 }, /* jia */
+    { 0x0000040,  103 }, /* chuan */
+    { 0x0002100,  104 }, /* me */
+    { 0x0000040,  106 }, /* pan */
+    { 0x0000000,  107 }, /* bei */
+    { 0x0002000,  107 }, /* she */
+    { 0x0000000,  108 }, /* qiu */
+    { 0x0000040,  108 }, /* wan */
+    { 0x0000000,  109 }, /* chai */
+    { 0x0000000,  109 }, /* huang */
+    { 0x0000000,  109 }, /* jiu */
+    { 0x0000000,  109 }, /* yue */
+    { 0x0000000,  109 }, /* bu */
+    { 0x0000000,  109 }, /* nao */
+    { 0x0002000,  109 }, /* re */
+    { 0x0000000,  110 }, /* niang */
+    { 0x0000040,  110 }, /* yon */
+    { 0x0000000,  111 }, /* bang */
+    { 0x0006101,  111 }, /* zhu */
+    { 0x0000000,  115 }, /* weng */
+    { 0x0002000,  115 }, /* se */
+    { 0x0002011,  116 }, /* bi */
+    { 0x0000000,  119 }, /* fei */
+    { 0x0000000,  119 }, /* nie */
+    { 0x0006000,  119 }, /* nia */
+    { 0x0000040,  121 }, /* kan */
+    { 0x0000000,  122 }, /* nue */
+    { 0x0000040,  122 }, /* non */
+    { 0x0104111,  123 }, /* r */
+    { 0x0000000,  128 }, /* shang */
+    { 0x0006100,  128 }, /* pa */
+    { 0x0002000,  131 }, /* qio */
+    { 0x0002000,  132 }, /* yua */
+    { 0x0000000,  133 }, /* keng */
+    { 0x0000000,  133 }, /* ri */
+    { 0x0000040,  133 }, /* gan */
+    { 0x0000000,  134 }, /* tang */
+    { 0x0000000,  134 }, /* gou */
+    { 0x0002100,  134 }, /* de */
+    { 0x0000040,  136 }, /* xin */
+    { 0x0000000,  137 }, /* long */
+    { 0x0000000,  137 }, /* ding */
+    { 0x0000000,  137 }, /* pei */
+    { 0x0000000,  137 }, /* xun */
+    { 0x0000040,  137 }, /* xion */
+    { 0x0000000,  138 }, /* tai */
+    { 0x0006000,  138 }, /* xia */
+    { 0x0000040,  140 }, /* yan */
+    { 0x0000000,  141 }, /* er */
+    { 0x0000000,  141 }, /* mei */
+    { 0x0000000,  141 }, /* jiong */
+    { 0x0006100,  141 }, /* sha */
+    { 0x0102000,  144 }, /* so */
+    { 0x0102000,  146 }, /* to */
+    { 0x0000040,  148 }, /* nen */
+    { 0x0000040,  149 }, /* ten */
+    { 0x0106011,  150 }, /* qi */
+    { 0x0000040,  155 }, /* con */
+    { 0x0000040,  156 }, /* qion */
+    { 0x0000000,  157 }, /* ceng */
+    { 0x0000000,  157 }, /* rui */
+    { 0x0006000,  157 }, /* lia */
+    { 0x0006000,  159 }, /* dia */
+    { 0x0104011,  161 }, /* w */
+    { 0x0000000,  165 }, /* jie */
+    { 0x0002100,  165 }, /* te */
+    { 0x0000000,  167 }, /* hao */
+    { 0x0000040,  167 }, /* kon */
+    { 0x0000000,  168 }, /* geng */
+    { 0x0000000,  168 }, /* shun */
+    { 0x0000000,  168 }, /* lang */
+    { 0x0006101,  168 }, /* su */
+    { 0x0000040,  172 }, /* pin */
+    { 0x0000040,  173 }, /* jin */
+    { 0x0000000,  174 }, /* gui */
+    { 0x0000040,  174 }, /* ban */
+    { 0x0000000,  175 }, /* gao */
+    { 0x0000000,  175 }, /* liu */
+    { 0x0000000,  175 }, /* lei */
+    { 0x0000000,  175 }, /* lv */
+    { 0x0006100,  175 }, /* ka */
+    { 0x0000000,  178 }, /* jiang */
+    { 0x0102000,  178 }, /* ko */
+    { 0x0002100,  180 }, /* zhe */
+    { 0x0000040,  182 }, /* jion */
+    { 0x0000040,  183 }, /* nin */
+    { 0x0000000,  184 }, /* pai */
+    { 0x0000000,  184 }, /* jiao */
+    { 0x0000000,  184 }, /* luo */
+    { 0x0000000,  184 }, /* bai */
+    { 0x0000000,  184 }, /* lai */
+    { 0x0102000,  184 }, /* lo */
+    { 0x0000000,  186 }, /* zhi */
+    { 0x0000000,  186 }, /* lun */
+    { 0x0000000,  186 }, /* gong */
+    { 0x0000040,  186 }, /* chen */
+    { 0x0000000,  187 }, /* bing */
+    { 0x0000000,  187 }, /* qing */
+    { 0x0000000,  187 }, /* diao */
+    { 0x0000040,  187 }, /* zon */
+    { 0x0000040,  188 }, /* tin */
+    { 0x0000000,  189 }, /* kuo */
+    { 0x0000000,  189 }, /* shuang */
+    { 0x0000040,  189 }, /* san */
+    { 0x0000000,  190 }, /* guai */
+    { 0x0304111,  190 }, /* l */
+    { 0x0000000,  196 }, /* wei */
+    { 0x0000000,  196 }, /* zun */
+    { 0x0006101,  196 }, /* hu */
+    { 0x0002000,  200 }, /* sua */
+    { 0x0106011,  201 }, /* h */
+    { 0x0000040,  206 }, /* gon */
+    { 0x0000040,  207 }, /* don */
+    { 0x0002000,  208 }, /* ke */
+    { 0x0000000,  209 }, /* ang */
+    { 0x0000000,  209 }, /* zhuo */
+    { 0x0102000,  209 }, /* zho */
+    { 0x0000000,  211 }, /* niu */
+    { 0x0000000,  211 }, /* zong */
+    { 0x0000000,  211 }, /* seng */
+    { 0x0100100,  211 }, /* j */
+    { 0x0000000,  213 }, /* xue */
+    { 0x0000000,  213 }, /* chao */
+    { 0x0000040,  213 }, /* lan */
+    { 0x0000000,  214 }, /* zei */
+    { 0x0102000,  214 }, /* zo */
+    { 0x0000000,  216 }, /* luan */
+    { 0x0000000,  216 }, /* reng */
+    { 0x0000040,  216 }, /* shen */
+    { 0x0000000,  217 }, /* dun */
+    { 0x0000000,  217 }, /* fang */
+    { 0x0000000,  217 }, /* yao */
+    { 0x0000000,  217 }, /* nv */
+    { 0x0002011,  217 }, /* pi */
+    { 0x0000000,  220 }, /* zuo */
+    { 0x0002000,  220 }, /* dua */
+    { 0x0000000,  221 }, /* dian */
+    { 0x0102000,  221 }, /* no */
+    { 0x0000000,  223 }, /* bian */
+    { 0x0000000,  223 }, /* ping */
+    { 0x0000000,  223 }, /* heng */
+    { 0x0000000,  223 }, /* cheng */
+    { 0x0002000,  223 }, /* xua */
+    { 0x0006100,  224 }, /* ta */
+    { 0x0000000,  227 }, /* ai */
+    { 0x0000000,  227 }, /* liang */
+    { 0x0000000,  227 }, /* pian */
+    { 0x0000000,  227 }, /* fu */
+    { 0x0000000,  227 }, /* si */
+    { 0x0000000,  227 }, /* mian */
+    { 0x0000000,  227 }, /* hou */
+    { 0x0000000,  227 }, /* cao */
+    { 0x0000040,  227 }, /* huan */
+    { 0x0000040,  228 }, /* can */
+    { 0x0000011,  229 }, /* ju */
+    { 0x0000000,  231 }, /* zhui */
+    { 0x0000000,  231 }, /* run */
+    { 0x0000000,  231 }, /* hei */
+    { 0x0000000,  231 }, /* leng */
+    { 0x0002011,  231 }, /* xu */
+    { 0x0000000,  234 }, /* mao */
+    { 0x0000040,  234 }, /* zhuan */
+    { 0x0106011,  235 }, /* ji */
+    { 0x0000000,  240 }, /* mou */
+    { 0x0000000,  240 }, /* quan */
+    { 0x0000000,  240 }, /* ming */
+    { 0x0002000,  240 }, /* lua */
+    { 0x0000000,  241 }, /* chong */
+    { 0x0000000,  241 }, /* suan */
+    { 0x0000000,  241 }, /* tuo */
+    { 0x0000000,  241 }, /* pang */
+    { 0x0104011,  241 }, /* g */
+    { 0x0000040,  245 }, /* cen */
+    { 0x0000000,  246 }, /* tiao */
+    { 0x0000000,  246 }, /* cai */
+    { 0x0000000,  246 }, /* gun */
+    { 0x0000000,  246 }, /* dong */
+    { 0x0000000,  246 }, /* chang */
+    { 0x0000000,  246 }, /* zi */
+    { 0x0000000,  246 }, /* nuo */
+    { 0x0000040,  246 }, /* lin */
+    { 0x0000000,  247 }, /* kun */
+    { 0x0104111,  247 }, /* m */
+    { 0x0000000,  252 }, /* huai */
+    { 0x0000000,  252 }, /* ng */
+    { 0x0002000,  252 }, /* rua */
+    { 0x0000040,  253 }, /* nan */
+    { 0x0000000,  254 }, /* tou */
+    { 0x0000000,  254 }, /* nong */
+    { 0x0000000,  254 }, /* lao */
+    { 0x0000000,  254 }, /* yang */
+    { 0x0000000,  254 }, /* zhao */
+    { 0x0000040,  254 }, /* zen */
+    { 0x0000000,  255 }, /* biao */
+    { 0x0000000,  255 }, /* shi */
+    { 0x0104011,  255 }, /* f */
+    { 0x0006000,  259 }, /* mia */
+    { 0x0000040,  261 }, /* son */
+    { 0x0006000,  262 }, /* qia */
+    { 0x0000000,  264 }, /* chun */
+    { 0x0000000,  264 }, /* hui */
+    { 0x0102000,  264 }, /* cho */
+    { 0x0000000,  266 }, /* ei */
+    { 0x0000000,  266 }, /* shuo */
+    { 0x0000000,  266 }, /* rang */
+    { 0x0000040,  266 }, /* ron */
+    { 0x0000040,  267 }, /* qin */
+    { 0x0000000,  268 }, /* chuang */
+    { 0x0006000,  268 }, /* tia */
+    { 0x0006100,  270 }, /* zha */
+    { 0x0022100,  273 }, /* e */
+    { 0x0000000,  276 }, /* cou */
+    { 0x0000040,  276 }, /* din */
+    { 0x0000000,  277 }, /* dao */
+    { 0x0000040,  277 }, /* shuan */
+    { 0x0000000,  278 }, /* tian */
+    { 0x0000000,  278 }, /* miu */
+    { 0x0000040,  278 }, /* lian */
+    { 0x0000000,  279 }, /* zhang */
+    { 0x0002000,  279 }, /* che */
+    { 0x0000000,  280 }, /* meng */
+    { 0x0000040,  280 }, /* hen */
+    { 0x0000040,  281 }, /* pen */
+    { 0x0000040,  282 }, /* yin */
+    { 0x0000000,  283 }, /* chuai */
+    { 0x0002100,  283 }, /* he */
+    { 0x0000000,  285 }, /* zou */
+    { 0x0000000,  285 }, /* zui */
+    { 0x0102011,  285 }, /* mi */
+    { 0x0000000,  289 }, /* kao */
+    { 0x0000040,  289 }, /* xian */
+    { 0x0000000,  290 }, /* feng */
+    { 0x0002100,  290 }, /* le */
+    { 0x0104191,  292 }, /* s */
+    { 0x0000000,  298 }, /* mang */
+    { 0x0000000,  298 }, /* pou */
+    { 0x0002000,  298 }, /* tua */
+    { 0x0002100,  299 }, /* we */
+    { 0x0000000,  301 }, /* chuo */
+    { 0x0000000,  301 }, /* lou */
+    { 0x0002000,  301 }, /* jua */
+    { 0x0000000,  302 }, /* chou */
+    { 0x0000000,  302 }, /* rong */
+    { 0x0000000,  302 }, /* peng */
+    { 0x0006011,  302 }, /* lu */
+    { 0x0000000,  306 }, /* ou */
+    { 0x0002000,  306 }, /* nua */
+    { 0x0000000,  307 }, /* chui */
+    { 0x0000000,  307 }, /* guo */
+    { 0x0000000,  307 }, /* xiong */
+    { 0x0006100,  307 }, /* na */
+    { 0x0006101,  310 }, /* tu */
+    { 0x0002100,  314 }, /* chua */
+    { 0x0000000,  316 }, /* dai */
+    { 0x0000000,  316 }, /* zhuang */
+    { 0x0000000,  316 }, /* kang */
+    { 0x0000040,  316 }, /* bin */
+    { 0x0104191,  317 }, /* z */
+    { 0x0002100,  323 }, /* pe */
+    { 0x0000000,  325 }, /* wai */
+    { 0x0104191,  325 }, /* c */
+    { 0x0006000,  331 }, /* ya */
+    { 0x0000000,  333 }, /* sang */
+    { 0x0100000,  333 }, /* fo */
+    { 0x0000040,  334 }, /* sen */
+    { 0x0000000,  335 }, /* dui */
+    { 0x0000000,  335 }, /* zuan */
+    { 0x0000040,  335 }, /* hn */
+    { 0x0000000,  336 }, /* que */
+    { 0x0002000,  336 }, /* cua */
+    { 0x0000040,  337 }, /* den */
+    { 0x0000000,  338 }, /* xie */
+    { 0x0000000,  338 }, /* kong */
+    { 0x0000000,  338 }, /* zang */
+    { 0x0000000,  338 }, /* zhun */
+    { 0x0000000,  338 }, /* die */
+    { 0x0000000,  338 }, /* qie */
+    { 0x0000000,  338 }, /* tao */
+    { 0x0104111,  338 }, /* p */
+    { 0x0000000,  343 }, /* tong */
+    { 0x0000040,  343 }, /* wen */
+    { 0x0000000,  344 }, /* mu */
+    { 0x0000000,  344 }, /* gang */
+    { 0x0000000,  344 }, /* bao */
+    { 0x0006000,  344 }, /* bia */
+    { 0x0002100,  346 }, /* ne */
+    { 0x0104111,  348 }, /* sh */
+    { 0x0000000,  353 }, /* suo */
+    { 0x0000000,  353 }, /* gai */
+    { 0x0000000,  353 }, /* qiang */
+    { 0x0002100,  353 }, /* be */
+    { 0x0000000,  355 }, /* dei */
+    { 0x0006101,  355 }, /* zu */
+    { 0x0000040,  359 }, /* an */
+    { 0x0100000,  360 }, /* mo */
+    { 0x0002100,  361 }, /* ge */
+    { 0x0000000,  363 }, /* tei */
+    { 0x0002000,  363 }, /* zua */
+    { 0x0000040,  364 }, /* zhan */
+    { 0x0000000,  365 }, /* ao */
+    { 0x0000000,  365 }, /* ruo */
+    { 0x0000000,  365 }, /* shou */
+    { 0x0000000,  365 }, /* wang */
+    { 0x0002100,  365 }, /* ze */
+    { 0x0006100,  367 }, /* ga */
+    { 0x0104111,  370 }, /* b */
+    { 0x0100100,  375 }, /* x */
+    { 0x0000000,  377 }, /* cong */
+    { 0x0000040,  377 }, /* zan */
+    { 0x0000000,  378 }, /* diu */
+    { 0x0002100,  378 }, /* shua */
+    { 0x0000000,  380 }, /* nou */
+    { 0x0000000,  380 }, /* miao */
+    { 0x0000040,  380 }, /* lon */
+    { 0x0000040,  381 }, /* tan */
+    { 0x0304151,  382 }, /* n */
+    { 0x0000000,  389 }, /* ruan */
+    { 0x0000000,  389 }, /* pie */
+    { 0x0000000,  389 }, /* ning */
+    { 0x0102000,  389 }, /* ro */
+    { 0x0006100,  391 }, /* ca */
+    { 0x0006100,  394 }, /* za */
+    { 0x0000000,  397 }, /* kou */
+    { 0x0000000,  397 }, /* nang */
+    { 0x0000000,  397 }, /* zao */
+    { 0x0000000,  397 }, /* zheng */
+    { 0x0000000,  397 }, /* you */
+    { 0x0000000,  397 }, /* lue */
+    { 0x0000000,  397 }, /* teng */
+    { 0x0000000,  397 }, /* xiang */
+    { 0x0000000,  397 }, /* cui */
+    { 0x0000000,  397 }, /* zhei */
+    { 0x0100000,  397 }, /* sho */
+    { 0x0000000,  398 }, /* shui */
+    { 0x0000000,  398 }, /* piao */
+    { 0x0000000,  398 }, /* shuai */
+    { 0x0000000,  398 }, /* beng */
+    { 0x0000000,  398 }, /* hng */
+    { 0x0102000,  398 }, /* do */
+    { 0x0000000,  400 }, /* dou */
+    { 0x0000000,  400 }, /* sun */
+    { 0x0000000,  400 }, /* nai */
+    { 0x0002000,  400 }, /* fa */
+    { 0x0006100,  401 }, /* ma */
+    { 0x0000000,  404 }, /* hang */
+    { 0x0002100,  404 }, /* wa */
+    { 0x0000000,  406 }, /* yong */
+    { 0x0000000,  406 }, /* liao */
+    { 0x0102011,  406 }, /* li */
+    { 0x0002000,  410 }, /* jio */
+    { 0x0000040,  411 }, /* ran */
+    { 0x0000000,  412 }, /* sui */
+    { 0x0000000,  412 }, /* xiu */
+    { 0x0000000,  412 }, /* wo */
+    { 0x0002000,  412 }, /* qua */
+    { 0x0000000,  413 }, /* cuo */
+    { 0x0000040,  413 }, /* nian */
+    { 0x0000040,  414 }, /* chon */
+    { 0x0000000,  415 }, /* qiao */
+    { 0x0006100,  415 }, /* da */
+    { 0x0000040,  418 }, /* hon */
+    { 0x0002000,  419 }, /* yi */
+    { 0x0000000,  420 }, /* cuan */
+    { 0x0006101,  420 }, /* chu */
+    { 0x0002000,  424 }, /* xio */
+    { 0x0000000,  425 }, /* zeng */
+    { 0x0000000,  425 }, /* shai */
+    { 0x0002011,  425 }, /* qu */
+    { 0x0002100,  428 }, /* gua */
+    { 0x0006100,  430 }, /* cha */
+    { 0x0006101,  433 }, /* shu */
+    { 0x0006101,  437 }, /* ku */
+    { 0x0000000,  441 }, /* zhong */
+    { 0x0000000,  441 }, /* qiong */
+    { 0x0006000,  441 }, /* pia */
+    { 0x0000040,  443 }, /* gen */
+    { 0x0000000,  444 }, /* jing */
+    { 0x0000000,  444 }, /* lie */
+    { 0x0000000,  444 }, /* sou */
+    { 0x0000000,  444 }, /* ci */
+    { 0x0000000,  444 }, /* niao */
+    { 0x0100100,  444 }, /* q */
+    { 0x0000040,  446 }, /* men */
+    { 0x0000000,  447 }, /* rao */
+    { 0x0002000,  447 }, /* ce */
+    { 0x0000000,  448 }, /* ling */
+    { 0x0000040,  448 }, /* jian */
+    { 0x0000000,  449 }, /* ying */
+    { 0x0104111,  449 }, /* t */
+    { 0x0000000,  454 }, /* kui */
+    { 0x0000000,  454 }, /* jue */
+    { 0x0006100,  454 }, /* ba */
+    { 0x0000000,  457 }, /* duan */
+    { 0x0000040,  457 }, /* kuan */
+    { 0x0000000,  458 }, /* tui */
+    { 0x0102000,  458 }, /* yo */
+    { 0x0100000,  460 }, /* o */
+    { 0x0000000,  461 }, /* yun */
+    { 0x0000000,  461 }, /* xiao */
+    { 0x0000000,  461 }, /* sao */
+    { 0x0000000,  461 }, /* qun */
+    { 0x0002100,  461 }, /* kua */
+    { 0x0000040,  463 }, /* len */
+    { 0x0006100,  464 }, /* sa */
+    { 0x0000040,  467 }, /* shan */
+    { 0x3cffeff,  468 }, /* root */
+};
+
+/* children (entry index) of each node in alphabet order */
+const uint16_t zh_syl_child[491] = {
+    320,436,469,295,169,178,202,104,110,109,171,203,118,97,483,64,
+    108,74,269,238,213,294,62,186,230,379,385,375,422,251,119,148,
+    361,298,395,347,55,447,481,14,216,271,146,242,386,263,430,75,
+    445,124,32,424,57,355,416,6,441,446,236,166,199,168,457,332,
+    112,265,221,351,215,45,458,197,123,48,247,454,160,261,334,455,
+    305,11,287,449,47,38,152,317,132,357,125,450,438,143,297,176,
+    209,275,411,321,365,472,173,293,135,468,256,214,388,24,432,65,
+    241,360,201,350,370,73,342,442,466,341,274,5,100,120,405,36,
+    172,89,40,144,68,368,377,356,9,335,316,484,276,452,490,82,
+    283,464,83,273,16,414,284,362,292,117,92,393,459,303,433,222,
+    184,431,323,439,22,382,141,358,195,437,426,373,225,462,103,41,
+    111,315,153,408,417,80,136,404,399,325,227,204,28,348,79,318,
+    434,177,330,165,20,286,61,1,254,72,311,353,52,194,180,262,
+    31,59,67,248,240,156,185,312,71,460,403,158,478,113,397,33,
+    131,400,363,95,39,326,476,228,207,129,340,86,150,159,435,96,
+    212,390,381,63,66,145,471,429,88,314,380,367,402,409,451,428,
+    19,349,233,235,398,85,27,444,443,327,328,183,301,259,84,384,
+    277,288,23,134,127,188,231,181,226,329,473,243,307,282,78,30,
+    302,415,164,488,489,106,372,234,138,157,70,192,366,4,252,413,
+    179,174,50,427,272,99,322,480,44,255,310,87,182,407,389,7,
+    264,211,378,128,308,406,470,69,465,77,51,133,217,17,205,423,
+    448,10,116,344,219,81,15,105,224,279,58,140,137,91,280,418,
+    456,90,29,383,313,193,220,200,249,60,461,352,304,210,278,374,
+    121,162,477,376,107,13,98,76,245,359,421,300,126,122,336,371,
+    270,8,223,54,218,291,46,260,239,237,43,394,410,387,198,425,
+    35,12,0,246,345,93,147,463,266,163,170,290,250,101,253,339,
+    18,299,2,309,338,333,285,324,130,440,354,486,190,42,94,37,
+    208,396,419,155,289,487,475,267,187,232,420,154,142,453,306,258,
+    167,229,151,25,139,337,175,161,369,56,102,412,331,3,479,244,
+    21,189,485,115,26,391,346,49,296,281,257,196,206,53,191,268,
+    401,482,364,467,114,319,474,149,392,34,343
+};
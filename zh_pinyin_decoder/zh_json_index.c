@@ -0,0 +1,252 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_index.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : sparse key offset index of json word dictionary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * keys of "zh_word_dict.json" are sorted, so the search of a key can start
+ * from the last entry before it, instead of the first key of its letter.
+ * when the index is not used, zh_json_bisect() finds a near location by
+ * binary search on the json file itself.
+ *****************************************************************************
+ */
+#include <string.h>
+#include <ctype.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_json_index.h"
+
+/************************   private functions   *********************************/
+
+static uint32_t rd_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief scan the json file for keys, keep every ZH_JSON_INDEX_STEP keys in idx 
+ * @note  only count the entries when idx->offset is NULL
+ * @param max  number of entries idx has room for
+ * @return number of entries (the entries after max are counted, not kept)
+ */
+static uint32_t json_index_scan(zh_storage_t* json, __json_index_t* idx, uint32_t max) {
+    uint8_t  buf[512];
+    char     key[ZH_JSON_INDEX_KEY_SZ];
+    uint32_t pos = 0, last_close = 0, key_num = 0, num = 0, n;
+    uint8_t  depth = 0, in_str = 0, esc = 0, is_key = 0, key_len = 0;
+    while ((n = zh_storage_read_at(json, pos, buf, sizeof(buf))) > 0) {
+        for (uint32_t i = 0; i < n; i++, pos++) {
+            uint8_t c = buf[i];
+            if (in_str) {
+                if (esc) esc = 0;
+                else if (c == '\\') esc = 1;
+                else if (c == '"') {
+                    in_str = 0;
+                    if (is_key) {   /* a key string is finished */
+                        if (key_num % ZH_JSON_INDEX_STEP == 0) {
+                            if (idx->offset != NULL && num < max) {
+                                idx->offset[num] = (key_num == 0) ? 0 : last_close;
+                                memset(idx->key[num], 0, ZH_JSON_INDEX_KEY_SZ);
+                                memcpy(idx->key[num], key, key_len);
+                            }
+                            num++;
+                        }
+                        key_num++;
+                    }
+                }
+                else if (is_key && key_len < ZH_JSON_INDEX_KEY_SZ) key[key_len++] = (char)c;
+                continue;
+            }
+            switch (c) {
+            case '"':
+                in_str = 1;
+                is_key = (depth == 1);  /* strings in top object (not in array) are keys */
+                key_len = 0;
+                break;
+            case '{': case '[':
+                depth++;
+                break;
+            case '}': case ']':
+                if (depth > 0) depth--;
+                if (c == ']' && depth == 1) last_close = pos;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return num;
+}
+
+/**
+ * @brief find the first entry boundary "]," at or after pos, and the key after it
+ * @param end  the boundary must be before end
+ * @param key  buffer for key (ZH_JSON_INDEX_KEY_SZ, zero padded)
+ * @return location of "]", or UINT32_MAX if no boundary (or the last entry)
+ */
+static uint32_t json_next_key(zh_storage_t* st, uint32_t pos, uint32_t end, uint8_t* buf, uint16_t buf_sz, char* key) {
+    while (pos < end) {
+        uint16_t n = (uint16_t)zh_storage_read_at(st, pos, buf, buf_sz);
+        if (n == 0) return UINT32_MAX;
+        uint16_t i = 0;
+        while (i < n && buf[i] != ']') i++;
+        if (i == n) {   /* no boundary in this piece */
+            pos += n;
+            continue;
+        }
+        if (pos + i >= end) return UINT32_MAX;
+        uint16_t j = i + 1;
+        while (j < n && (isspace(buf[j]) || buf[j] == ',')) j++;
+        if (j < n && buf[j] == '}') return UINT32_MAX;  /* the last entry */
+        uint16_t k = j + 1;
+        while (k < n && buf[k] != '"') k++;
+        if (k >= n) {   /* key is cut by the piece, read again from the boundary */
+            if (i == 0) return UINT32_MAX;
+            pos += i;
+            continue;
+        }
+        memset(key, 0, ZH_JSON_INDEX_KEY_SZ);
+        memcpy(key, buf + j + 1, __min(k - j - 1, ZH_JSON_INDEX_KEY_SZ));
+        return pos + i;
+    }
+    return UINT32_MAX;
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief build the index by scanning the whole json dictionary
+ * @return 0: success, 1: no key found, malloc failed or file changed while scanning (index is freed)
+ */
+uint8_t zh_json_index_build(zh_storage_t* json, __json_index_t* idx) {
+    memset(idx, 0, sizeof(__json_index_t));
+    uint32_t num = json_index_scan(json, idx, 0);
+    if (num == 0) return 1;
+    idx->offset = zh_buffer_malloc(sizeof(uint32_t) * num);
+    idx->key = zh_buffer_malloc((size_t)ZH_JSON_INDEX_KEY_SZ * num);
+    if (idx->offset == NULL || idx->key == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_json_index_free(idx);
+        return 1;
+    }
+    idx->num = json_index_scan(json, idx, num);
+    if (idx->num != num) {
+        zh_json_index_free(idx);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief read the index file, which must be built from json file of this size and modify time
+ * @return 0: success, 1: invalid or out of date file, or malloc failed
+ */
+uint8_t zh_json_index_read(FILE* fp, uint32_t json_size, int64_t json_mtime, __json_index_t* idx) {
+    uint8_t hdr[ZH_JSON_INDEX_HEADER_SZ], ent[ZH_JSON_INDEX_ENTRY_SZ];
+    memset(idx, 0, sizeof(__json_index_t));
+    if (fread(hdr, 1, ZH_JSON_INDEX_HEADER_SZ, fp) != ZH_JSON_INDEX_HEADER_SZ ||
+        memcmp(hdr + ZH_JSON_INDEX_HDR_MAGIC, ZH_JSON_INDEX_MAGIC, 4) != 0 ||
+        (hdr[ZH_JSON_INDEX_HDR_VERSION] | (hdr[ZH_JSON_INDEX_HDR_VERSION + 1] << 8)) != ZH_JSON_INDEX_VERSION ||
+        (hdr[ZH_JSON_INDEX_HDR_STEP] | (hdr[ZH_JSON_INDEX_HDR_STEP + 1] << 8)) != ZH_JSON_INDEX_STEP ||
+        rd_u32(hdr + ZH_JSON_INDEX_HDR_SIZE) != json_size ||
+        rd_u32(hdr + ZH_JSON_INDEX_HDR_MTIME) != (uint32_t)json_mtime ||
+        rd_u32(hdr + ZH_JSON_INDEX_HDR_MTIME + 4) != (uint32_t)((uint64_t)json_mtime >> 32)) {
+        return 1;
+    }
+    uint32_t num = rd_u32(hdr + ZH_JSON_INDEX_HDR_NUM);
+    if (num == 0) return 1;
+    idx->offset = zh_buffer_malloc(sizeof(uint32_t) * num);
+    idx->key = zh_buffer_malloc((size_t)ZH_JSON_INDEX_KEY_SZ * num);
+    if (idx->offset == NULL || idx->key == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_json_index_free(idx);
+        return 1;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        if (fread(ent, 1, ZH_JSON_INDEX_ENTRY_SZ, fp) != ZH_JSON_INDEX_ENTRY_SZ || 
+            rd_u32(ent) >= json_size) {
+            zh_json_index_free(idx);
+            return 1;
+        }
+        idx->offset[i] = rd_u32(ent);
+        memcpy(idx->key[i], ent + 4, ZH_JSON_INDEX_KEY_SZ);
+    }
+    idx->num = num;
+    return 0;
+}
+
+/**
+ * @brief write the index file, with the size and modify time of json file it's built from
+ * @return 0: success, 1: write failed
+ */
+uint8_t zh_json_index_write(FILE* fp, uint32_t json_size, int64_t json_mtime, const __json_index_t* idx) {
+    uint8_t hdr[ZH_JSON_INDEX_HEADER_SZ] = { 0 }, ent[ZH_JSON_INDEX_ENTRY_SZ];
+    memcpy(hdr + ZH_JSON_INDEX_HDR_MAGIC, ZH_JSON_INDEX_MAGIC, 4);
+    hdr[ZH_JSON_INDEX_HDR_VERSION] = ZH_JSON_INDEX_VERSION;
+    hdr[ZH_JSON_INDEX_HDR_STEP] = ZH_JSON_INDEX_STEP;
+    wr_u32(hdr + ZH_JSON_INDEX_HDR_SIZE, json_size);
+    wr_u32(hdr + ZH_JSON_INDEX_HDR_MTIME, (uint32_t)json_mtime);
+    wr_u32(hdr + ZH_JSON_INDEX_HDR_MTIME + 4, (uint32_t)((uint64_t)json_mtime >> 32));
+    wr_u32(hdr + ZH_JSON_INDEX_HDR_NUM, idx->num);
+    if (fwrite(hdr, 1, ZH_JSON_INDEX_HEADER_SZ, fp) != ZH_JSON_INDEX_HEADER_SZ) return 1;
+    for (uint32_t i = 0; i < idx->num; i++) {
+        wr_u32(ent, idx->offset[i]);
+        memcpy(ent + 4, idx->key[i], ZH_JSON_INDEX_KEY_SZ);
+        if (fwrite(ent, 1, ZH_JSON_INDEX_ENTRY_SZ, fp) != ZH_JSON_INDEX_ENTRY_SZ) return 1;
+    }
+    return 0;
+}
+
+/* free the index built or read */
+void zh_json_index_free(__json_index_t* idx) {
+    if (idx->offset) zh_buffer_free(idx->offset);
+    if (idx->key)    zh_buffer_free(idx->key);
+    memset(idx, 0, sizeof(__json_index_t));
+}
+
+/**
+ * @brief get the location to start searching the keys with prefix str[0, len)
+ * @note  it's the offset of the last entry with key < str[0, len), the keys 
+ *        before this entry are all smaller than the prefix
+ * @param len  length of prefix (<= ZH_JSON_INDEX_KEY_SZ)
+ * @return file offset for zh_json_reader_open to start
+ */
+uint32_t zh_json_index_seek(const __json_index_t* idx, const char* str, uint8_t len) {
+    uint32_t lo = 0, hi = idx->num;   /* first entry with key >= str */
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (strncmp(idx->key[mid], str, len) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo == 0) ? 0 : idx->offset[lo - 1];
+}
+
+/**
+ * @brief get the location to start searching the keys with prefix str[0, len) by binary search
+ *        on the json file, without index. each step reads one piece at the middle of range,
+ *        and compares the key after the first entry boundary "]," in it
+ * @param st      opened json file
+ * @param buf     buffer for reading file pieces (should be larger than 2 entries)
+ * @param len     length of prefix (<= ZH_JSON_INDEX_KEY_SZ)
+ * @return file offset for zh_json_reader_open to start (the keys before it are smaller than prefix)
+ */
+uint32_t zh_json_bisect(zh_storage_t* st, const char* str, uint8_t len, uint8_t* buf, uint16_t buf_sz) {
+    char key[ZH_JSON_INDEX_KEY_SZ];
+    uint32_t lo = 0, hi = st->size;   /* lo : 0 or boundary before a key < str, keys after hi are >= str */
+    while (hi - lo > buf_sz / 2) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        uint32_t p = json_next_key(st, mid, hi, buf, buf_sz, key);
+        if (p != UINT32_MAX && strncmp(key, str, len) < 0) lo = p;
+        else hi = mid;
+    }
+    return lo;
+}
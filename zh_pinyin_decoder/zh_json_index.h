@@ -0,0 +1,75 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_index.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : sparse key offset index of json word dictionary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when USE_ZH_WORD_DICT_BIN is set to 0. the index is built
+ * from "zh_word_dict.json" by zh_word_json_index_load() (called at init),
+ * and saved to the sidecar file ZH_WORD_DICT_INDEX_FILE_NAME, so that it's only
+ * rebuilt when size or modify time of json file changes. all numbers are
+ * stored in little endian.
+ *
+ *   header  : ZH_JSON_INDEX_HEADER_SZ bytes (see below)
+ *   entries : num * (uint32 offset, char key[ZH_JSON_INDEX_KEY_SZ])
+ *
+ * one entry is kept for every ZH_JSON_INDEX_STEP keys. offset is the location
+ * of the "]" closing the entry before the key (0 for the first key), which is
+ * where the tokenizer (zh_json_token.h) can start reading. key is zero padded (truncated if
+ * longer), it's only compared with the first piece of input.
+ *
+ * zh_json_bisect() gives the same kind of location without index (option
+ * USE_ZH_WORD_JSON_INDEX = 0, or the index can't be loaded), by binary search
+ * on the file and resynchronizing on the "]," entry boundary.
+ *****************************************************************************
+ */
+#ifndef __ZH_JSON_INDEX_H
+#define __ZH_JSON_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include <stdio.h>
+#include "zh_storage.h"
+
+#define ZH_JSON_INDEX_MAGIC         "ZHJI"
+#define ZH_JSON_INDEX_VERSION       1
+#define ZH_JSON_INDEX_STEP          32      /* keys between two entries (~20kb RAM for default dictionary) */
+#define ZH_JSON_INDEX_KEY_SZ        12      /* key prefix kept in entry, must > MAX_WORD_CODE_LENGTH */
+#define ZH_JSON_BISECT_PIECE_SZ     512     /* bytes read by each step of zh_json_bisect (> 2 * longest entry) */
+
+/** header layout (offset in bytes) */
+#define ZH_JSON_INDEX_HDR_MAGIC     0       /* char[4]     magic "ZHJI"              */
+#define ZH_JSON_INDEX_HDR_VERSION   4       /* uint16      format version            */
+#define ZH_JSON_INDEX_HDR_STEP      6       /* uint16      keys between two entries  */
+#define ZH_JSON_INDEX_HDR_SIZE      8       /* uint32      size of json file         */
+#define ZH_JSON_INDEX_HDR_MTIME     12      /* uint32[2]   modify time of json file (low, high) */
+#define ZH_JSON_INDEX_HDR_NUM       20      /* uint32      number of entries         */
+#define ZH_JSON_INDEX_HEADER_SZ     24
+#define ZH_JSON_INDEX_ENTRY_SZ      (4 + ZH_JSON_INDEX_KEY_SZ)
+
+typedef struct {
+    uint32_t num;               /* number of entries */
+    uint32_t* offset;           /* parse start location of each entry */
+    char     (*key)[ZH_JSON_INDEX_KEY_SZ];  /* key of each entry (sorted) */
+}__json_index_t;
+
+uint8_t zh_json_index_build(zh_storage_t* json, __json_index_t* idx);
+uint8_t zh_json_index_read(FILE* fp, uint32_t json_size, int64_t json_mtime, __json_index_t* idx);
+uint8_t zh_json_index_write(FILE* fp, uint32_t json_size, int64_t json_mtime, const __json_index_t* idx);
+void zh_json_index_free(__json_index_t* idx);
+
+uint32_t zh_json_index_seek(const __json_index_t* idx, const char* str, uint8_t len);
+uint32_t zh_json_bisect(zh_storage_t* st, const char* str, uint8_t len, uint8_t* buf, uint16_t buf_sz);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_scan.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-12  (last modified)
+ * @brief          : structural character indexer of json dictionary buffer
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * bit (i % 64) of bitmap[i / 64] is for buf[i]. for each 64 bytes, the kernel
+ * gives the masks of quotes, back slashes and closing brackets, then : 
+ *   1. a quote after back slash is checked by counting the back slashes 
+ *      before it (rare in dictionary, hanzi values only have "\u")
+ *   2. prefix xor of quotes gives the bytes in strings (opening quote to the 
+ *      byte before closing quote), carried to the next 64 bytes
+ *   3. closing brackets in strings are removed
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_json_scan.h"
+
+#if (USE_ZH_JSON_SIMD == 1)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/************************   private variables   *********************************/
+
+#define H(c)  ((c) >= '0' && (c) <= '9' ? (c) - '0' : (c) >= 'a' && (c) <= 'f' ? (c) - 'a' + 10 : \
+               (c) >= 'A' && (c) <= 'F' ? (c) - 'A' + 10 : ZH_JSON_HEX_NONE)
+#define H4(c) H(c), H(c + 1), H(c + 2), H(c + 3)
+#define H16(c) H4(c), H4(c + 4), H4(c + 8), H4(c + 12)
+
+/* hex digit value of each byte (ZH_JSON_HEX_NONE if not hex), used by "\uXXXX" decoding */
+const uint8_t zh_json_hex[256] = {
+    H16(0x00), H16(0x10), H16(0x20), H16(0x30), H16(0x40), H16(0x50), H16(0x60), H16(0x70),
+    H16(0x80), H16(0x90), H16(0xA0), H16(0xB0), H16(0xC0), H16(0xD0), H16(0xE0), H16(0xF0),
+};
+
+/************************   private functions   *********************************/
+
+/* index of lowest set bit (x != 0) */
+static uint8_t lowest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (uint8_t)i;
+#else
+    uint8_t i = 0;
+    while (!(x & 1)) { x >>= 1; i++; }
+    return i;
+#endif
+}
+
+/* bit i of result is xor of bit 0 ~ i of x */
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/* scalar kernel of n (<= 64) bytes */
+static void mask_scalar(const uint8_t* p, uint8_t n, uint64_t* q, uint64_t* bs, uint64_t* cl) {
+    *q = *bs = *cl = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        uint64_t b = (uint64_t)1 << i;
+        if (p[i] == '"') *q |= b;
+        else if (p[i] == '\\') *bs |= b;
+        else if (p[i] == ']' || p[i] == '}') *cl |= b;
+    }
+}
+
+#if !defined(JSON_SCAN_AVX2) && !defined(JSON_SCAN_SSE2) && !defined(JSON_SCAN_NEON) && \
+    (defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+#define JSON_SCAN_SWAR
+
+/* bit i of result is set if byte i of v is zero (8 bytes, little endian) */
+static uint8_t swar_zero(uint64_t v) {
+    const uint64_t lo7 = 0x7F7F7F7F7F7F7F7FULL;
+    uint64_t y = ~(((v & lo7) + lo7) | v | lo7);   /* 0x80 in zero bytes */
+    return (uint8_t)(((y >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* scalar kernel of 64 bytes, 8 bytes each step */
+static void mask_simd(const uint8_t* p, uint64_t* q, uint64_t* bs, uint64_t* cl) {
+    const uint64_t one = 0x0101010101010101ULL;
+    *q = *bs = *cl = 0;
+    for (uint8_t i = 0; i < 64; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        *q  |= (uint64_t)swar_zero(v ^ (one * '"')) << i;
+        *bs |= (uint64_t)swar_zero(v ^ (one * '\\')) << i;
+        *cl |= (uint64_t)(swar_zero(v ^ (one * ']')) | swar_zero(v ^ (one * '}'))) << i;
+    }
+}
+
+#elif defined(JSON_SCAN_AVX2)
+static void mask_simd(const uint8_t* p, uint64_t* q, uint64_t* bs, uint64_t* cl) {
+    const __m256i vq = _mm256_set1_epi8('"'), vbs = _mm256_set1_epi8('\\');
+    const __m256i vrb = _mm256_set1_epi8(']'), vrc = _mm256_set1_epi8('}');
+    *q = *bs = *cl = 0;
+    for (uint8_t i = 0; i < 64; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        *q  |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vq)) << i;
+        *bs |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vbs)) << i;
+        *cl |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, vrb), _mm256_cmpeq_epi8(v, vrc))) << i;
+    }
+}
+#elif defined(JSON_SCAN_SSE2)
+static void mask_simd(const uint8_t* p, uint64_t* q, uint64_t* bs, uint64_t* cl) {
+    const __m128i vq = _mm_set1_epi8('"'), vbs = _mm_set1_epi8('\\');
+    const __m128i vrb = _mm_set1_epi8(']'), vrc = _mm_set1_epi8('}');
+    *q = *bs = *cl = 0;
+    for (uint8_t i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        *q  |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vq)) << i;
+        *bs |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vbs)) << i;
+        *cl |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, vrb), _mm_cmpeq_epi8(v, vrc))) << i;
+    }
+}
+#elif defined(JSON_SCAN_NEON)
+/* bit i of result is set if byte i of v is 0xFF (16 bytes) */
+static uint16_t neon_movemask(uint8x16_t v) {
+    static const uint8_t bit[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t m = vandq_u8(v, vld1q_u8(bit));
+    return (uint16_t)(vaddv_u8(vget_low_u8(m)) | (vaddv_u8(vget_high_u8(m)) << 8));
+}
+
+static void mask_simd(const uint8_t* p, uint64_t* q, uint64_t* bs, uint64_t* cl) {
+    const uint8x16_t vq = vdupq_n_u8('"'), vbs = vdupq_n_u8('\\');
+    const uint8x16_t vrb = vdupq_n_u8(']'), vrc = vdupq_n_u8('}');
+    *q = *bs = *cl = 0;
+    for (uint8_t i = 0; i < 64; i += 16) {
+        uint8x16_t v = vld1q_u8(p + i);
+        *q  |= (uint64_t)neon_movemask(vceqq_u8(v, vq)) << i;
+        *bs |= (uint64_t)neon_movemask(vceqq_u8(v, vbs)) << i;
+        *cl |= (uint64_t)neon_movemask(vorrq_u8(vceqq_u8(v, vrb), vceqq_u8(v, vrc))) << i;
+    }
+}
+#endif
+
+/* mark buf[from, to) (from is multiple of 64) */
+static void mark_range(__json_mark_t* m, const uint8_t* buf, uint16_t from, uint16_t to) {
+    for (uint16_t i = from; i < to; i += 64) {
+        uint64_t q, bs, cl;
+        uint8_t  n = (to - i < 64) ? (uint8_t)(to - i) : 64;
+#if defined(JSON_SCAN_AVX2) || defined(JSON_SCAN_SSE2) || defined(JSON_SCAN_NEON) || defined(JSON_SCAN_SWAR)
+        if (n == 64) mask_simd(buf + i, &q, &bs, &cl);
+        else
+#endif
+        mask_scalar(buf + i, n, &q, &bs, &cl);
+
+        /* quote after odd number of back slashes is escaped */
+        uint64_t esc = q & ((bs << 1) | (i > 0 && buf[i - 1] == '\\'));
+        while (esc) {
+            uint8_t  b = lowest_bit(esc);
+            uint16_t k = i + b, c = 0;
+            while (k > 0 && buf[k - 1] == '\\') {
+                k--;
+                c++;
+            }
+            if (c & 1) q &= ~((uint64_t)1 << b);
+            esc &= esc - 1;
+        }
+        uint64_t s = prefix_xor(q) ^ m->in_str;   /* bytes in strings */
+        m->in_str = (uint64_t)0 - (s >> 63);
+        m->quote[i / 64] = q;
+        m->close[i / 64] = cl & ~s;
+    }
+}
+
+/************************   public functions   *********************************/
+
+/* clear the marks when buffer content is changed */
+void zh_json_mark_reset(__json_mark_t* m) {
+    m->marked = 0;
+    m->in_str = 0;
+}
+
+/**
+ * @brief location of the first bit set in bitmap (m->quote or m->close) at or after from, 
+ *        buffer is marked block by block when the location is not marked yet
+ * @return location found, len if not found
+ */
+uint16_t zh_json_next_mark(__json_mark_t* m, const uint64_t* bits, const uint8_t* buf, uint16_t len, uint16_t from) {
+    while (from < len) {
+        if (from >= m->marked) {
+            uint16_t to = (len - m->marked > ZH_JSON_MARK_BLOCK) ? m->marked + ZH_JSON_MARK_BLOCK : len;
+            mark_range(m, buf, m->marked, to);
+            m->marked = to;
+            continue;
+        }
+        uint16_t w = from / 64;
+        uint64_t x = bits[w] & (~(uint64_t)0 << (from % 64));
+        if (x) return w * 64 + lowest_bit(x);
+        from = (w + 1) * 64;
+    }
+    return len;
+}
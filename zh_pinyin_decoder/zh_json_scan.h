@@ -0,0 +1,52 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_scan.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-12  (last modified)
+ * @brief          : structural character indexer of json dictionary buffer
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the buffer is marked by 64 bytes words in bitmaps : quotes (not escaped)
+ * and closing brackets "]" "}" outside strings, so the json tokenizer jumps
+ * from key to key and to the end of value array, without testing every byte.
+ *
+ * with option USE_ZH_JSON_SIMD, the kernel uses AVX2, SSE2 or NEON when it's
+ * enabled by compiler (e.g. -mavx2, x64 always has SSE2, aarch64 has NEON),
+ * otherwise (or USE_ZH_JSON_SIMD = 0) 8 bytes are tested at a time in
+ * uint64 (byte loop if the byte order is unknown).
+ *****************************************************************************
+ */
+#ifndef __ZH_JSON_SCAN_H
+#define __ZH_JSON_SCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+
+#define ZH_JSON_MARK_WORDS(sz)      (((sz) + 63) / 64)  /* uint64 words of bitmap for sz bytes */
+#define ZH_JSON_MARK_BLOCK          256     /* bytes marked each time when needed (multiple of 64) */
+#define ZH_JSON_HEX_NONE            0xFF    /* zh_json_hex[] value of byte not a hex digit */
+
+/* structural bitmaps of a buffer (buffer must start outside strings) */
+typedef struct {
+    uint16_t marked;            /* bytes marked (multiple of 64 except the end of buffer) */
+    uint64_t in_str;            /* ~0 if the last marked byte is in string, else 0 */
+    uint64_t quote[ZH_JSON_MARK_WORDS(ZH_WORD_DICT_BUFFER_SZ)];   /* quotes not escaped */
+    uint64_t close[ZH_JSON_MARK_WORDS(ZH_WORD_DICT_BUFFER_SZ)];   /* "]" and "}" outside strings */
+}__json_mark_t;
+
+extern const uint8_t zh_json_hex[256];
+
+void zh_json_mark_reset(__json_mark_t* m);
+uint16_t zh_json_next_mark(__json_mark_t* m, const uint64_t* bits, const uint8_t* buf, uint16_t len, uint16_t from);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_token.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-11  (last modified)
+ * @brief          : streaming tokenizer of json word dictionary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the reader can start at offset 0 or at the "]" closing an entry (the
+ * location given by zh_json_index_seek or zh_json_bisect), the next string
+ * after it is always a key.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_json_token.h"
+#include "zh_json_scan.h"
+
+/************************   private functions   *********************************/
+
+/* parse 4 hex digits of "\uXXXX" at p (p + 4 <= end), return UINT32_MAX if invalid */
+static uint32_t hex4(const uint8_t* p, const uint8_t* end) {
+    if (end - p < 4) return UINT32_MAX;
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t h = zh_json_hex[p[i]];
+        if (h == ZH_JSON_HEX_NONE) return UINT32_MAX;
+        v = (v << 4) | h;
+    }
+    return v;
+}
+
+/* append utf-8 bytes of code point to out (bytes over out_sz are dropped) */
+static void put_utf8(uint32_t cp, char* out, uint8_t out_sz, uint8_t* n) {
+    uint8_t b[4], len;
+    if (cp < 0x80) { b[0] = (uint8_t)cp; len = 1; }
+    else if (cp < 0x800) { b[0] = 0xC0 | (cp >> 6); b[1] = 0x80 | (cp & 0x3F); len = 2; }
+    else if (cp < 0x10000) { b[0] = 0xE0 | (cp >> 12); b[1] = 0x80 | ((cp >> 6) & 0x3F); b[2] = 0x80 | (cp & 0x3F); len = 3; }
+    else { b[0] = 0xF0 | (cp >> 18); b[1] = 0x80 | ((cp >> 12) & 0x3F); b[2] = 0x80 | ((cp >> 6) & 0x3F); b[3] = 0x80 | (cp & 0x3F); len = 4; }
+    for (uint8_t i = 0; i < len && *n < out_sz; i++) out[(*n)++] = (char)b[i];
+}
+
+/**
+ * @brief tokenize the entry at rd->ptr by the structural marks
+ * @return 0: entry found, 1: end of dictionary or invalid, 2: entry is not complete in buffer
+ */
+static uint8_t parse_entry(__json_reader_t* rd, __json_entry_t* e) {
+    const uint8_t* buf = rd->buf;
+    __json_mark_t* m = &rd->mark;
+    uint16_t len = rd->len;
+    /* key : the next string */
+    uint16_t ks = zh_json_next_mark(m, m->quote, buf, len, rd->ptr);
+    if (ks >= len) return 2;
+    uint16_t ke = zh_json_next_mark(m, m->quote, buf, len, ks + 1);
+    if (ke >= len) return 2;
+    uint16_t c = zh_json_next_mark(m, m->close, buf, len, rd->ptr);
+    if (c < ks && buf[c] == '}') return 1;    /* end of the dictionary object */
+    e->key = (const char*)buf + ks + 1;
+    e->key_len = (ke - ks - 1 > 255) ? 0 : (uint8_t)(ke - ks - 1);
+    /* value : array after ':' */
+    uint16_t vs = ke + 1;
+    while (vs < len && buf[vs] != '[') {
+        if (buf[vs] != ':' && buf[vs] != ' ' && buf[vs] != '\t' && buf[vs] != '\r' && buf[vs] != '\n') return 1;
+        vs++;
+    }
+    if (vs >= len) return 2;
+    uint16_t ve = zh_json_next_mark(m, m->close, buf, len, ++vs);
+    if (ve >= len) return 2;
+    e->val = buf + vs;
+    e->val_len = ve - vs;
+    rd->ptr = ve + 1;
+    return 0;
+}
+
+/**
+ * @brief keep the rest of buffer (from rd->ptr) and read more after it. for mapped file the 
+ *        buffer is moved to the rest on the file, otherwise the rest is moved to buffer start
+ * @return number of bytes added
+ */
+static uint16_t reader_fill(__json_reader_t* rd) {
+    uint16_t rest = rd->len - rd->ptr, n;
+    const uint8_t* map = zh_storage_map(rd->st);
+    if (map != NULL) {
+        uint32_t left = (rd->pos < rd->st->size) ? rd->st->size - rd->pos : 0;
+        n = (uint16_t)__min(left, (uint32_t)(rd->buf_sz - rest));
+        rd->buf = map + rd->pos - rest;
+    }
+    else {
+        memmove(rd->mem, rd->buf + rd->ptr, rest);
+        n = (uint16_t)zh_storage_read_at(rd->st, rd->pos, rd->mem + rest, rd->buf_sz - rest);
+        rd->buf = rd->mem;
+    }
+    rd->len = rest + n;
+    rd->ptr = 0;
+    rd->pos += n;
+    zh_json_mark_reset(&rd->mark);
+    return n;
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief start reading json dictionary at offset (0 or the "]" before an entry)
+ * @return 0: success, 1: read failed
+ */
+uint8_t zh_json_reader_open(__json_reader_t* rd, zh_storage_t* st, uint32_t offset, uint8_t* buf, uint16_t buf_sz) {
+    rd->st = st;
+    rd->mem = buf;
+    rd->buf = buf;
+    rd->buf_sz = buf_sz;
+    rd->len = 0;
+    rd->ptr = 0;
+    rd->pos = offset;
+    rd->read_num = 0;
+    if (buf_sz > ZH_WORD_DICT_BUFFER_SZ) return 1;
+    reader_fill(rd);
+    return rd->len == 0;
+}
+
+/**
+ * @brief read the next entry, buffer is refilled when the entry is not complete in it
+ * @param e  key and value array of entry (slices of buffer, valid until next call)
+ * @return 0: success, 1: end of dictionary, invalid or entry larger than buffer
+ */
+uint8_t zh_json_next_entry(__json_reader_t* rd, __json_entry_t* e) {
+    for (;;) {
+        uint8_t res = parse_entry(rd, e);
+        if (res != 2) return res;
+        if (rd->ptr == 0 && rd->len == rd->buf_sz) return 1;   /* entry larger than buffer */
+        if (reader_fill(rd) == 0) return 1;
+        rd->read_num++;
+    }
+}
+
+/**
+ * @brief decode the next string of value array to utf-8
+ * @param p        location in value array, moved after the string
+ * @param end      end of value array
+ * @param out      buffer for decoded string (not terminated)
+ * @param out_sz   size of out, the bytes over it are dropped
+ * @param out_len  length of decoded string
+ * @return 0: success, 1: no more string
+ */
+uint8_t zh_json_next_string(const uint8_t** p, const uint8_t* end, char* out, uint8_t out_sz, uint8_t* out_len) {
+    const uint8_t* s = *p;
+    while (s < end && *s != '"') s++;
+    if (s >= end) {
+        *p = end;
+        return 1;
+    }
+    uint8_t n = 0;
+    for (s++; s < end && *s != '"'; s++) {
+        if (*s != '\\') {
+            if (n < out_sz) out[n++] = (char)*s;
+            continue;
+        }
+        if (++s >= end) break;
+        uint32_t cp;
+        switch (*s) {
+        case 'u':
+            cp = hex4(s + 1, end);
+            if (cp == UINT32_MAX) break;
+            s += 4;
+            /* surrogate pair "\uD8XX\uDCXX" */
+            if (cp >= 0xD800 && cp < 0xDC00 && end - s > 6 && s[1] == '\\' && s[2] == 'u') {
+                uint32_t lo = hex4(s + 3, end);
+                if (lo >= 0xDC00 && lo < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    s += 6;
+                }
+            }
+            put_utf8(cp, out, out_sz, &n);
+            break;
+        case 'b': put_utf8('\b', out, out_sz, &n); break;
+        case 'f': put_utf8('\f', out, out_sz, &n); break;
+        case 'n': put_utf8('\n', out, out_sz, &n); break;
+        case 'r': put_utf8('\r', out, out_sz, &n); break;
+        case 't': put_utf8('\t', out, out_sz, &n); break;
+        default : put_utf8(*s, out, out_sz, &n); break;   /* '"', '\\', '/' */
+        }
+    }
+    *p = (s < end) ? s + 1 : end;
+    *out_len = n;
+    return 0;
+}
+
+/**
+ * @brief read the number after the string just decoded by zh_json_next_string (frequency of word)
+ * @param p    location in value array, moved after the number if it exists
+ * @param end  end of value array
+ * @param num  the number (fraction is dropped, saturated to UINT32_MAX)
+ * @return 0: success, 1: next value is not a number
+ */
+uint8_t zh_json_next_number(const uint8_t** p, const uint8_t* end, uint32_t* num) {
+    const uint8_t* s = *p;
+    while (s < end && (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n' || *s == ',')) s++;
+    if (s >= end || *s < '0' || *s > '9') return 1;
+    uint32_t v = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; s++) {
+        v = (v > (UINT32_MAX - 9) / 10) ? UINT32_MAX : v * 10 + (*s - '0');
+    }
+    while (s < end && *s != ',' && *s != '"') s++;   /* fraction or exponent */
+    *num = v;
+    *p = s;
+    return 0;
+}
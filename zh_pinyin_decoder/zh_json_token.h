@@ -0,0 +1,70 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_json_token.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-11  (last modified)
+ * @brief          : streaming tokenizer of json word dictionary
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when USE_ZH_WORD_DICT_BIN is set to 0. it only accepts
+ * the schema of "zh_word_dict.json" :
+ *
+ *   { "key": ["\uXXXX\uXXXX", ...], "key": [...], ... }
+ *
+ * a word may be followed by its frequency ("key": ["\uXXXX\uXXXX", 12000, ...]).
+ * entries are read into the buffer given by caller (or viewed in place when
+ * the storage backend maps the file), quotes and closing
+ * brackets of the buffer are marked by zh_json_scan.c (block by block when
+ * needed), and the entry is tokenized by jumping between the marks. key
+ * and value array are given as slices of the buffer (valid until the next entry is read), so
+ * no memory is allocated and no tree is built. strings of value array are
+ * decoded to utf-8 one by one into the buffer of caller.
+ *****************************************************************************
+ */
+#ifndef __ZH_JSON_TOKEN_H
+#define __ZH_JSON_TOKEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_storage.h"
+#include "zh_json_scan.h"
+
+#define ZH_JSON_KEY_MAX_LEN     31      /* max length of key accepted, "zhuang zhuang zhuang zhuang" is 27 */
+
+/* json dictionary reader (uses an external buffer) */
+typedef struct {
+    zh_storage_t* st;
+    uint8_t* mem;               /* read buffer (must be larger than the longest entry, <= ZH_WORD_DICT_BUFFER_SZ) */
+    const uint8_t* buf;         /* bytes being tokenized, mem or mapped file (no copy) */
+    uint16_t buf_sz;            /* size of read buffer */
+    uint16_t len;               /* valid bytes in buffer */
+    uint16_t ptr;               /* location of next entry in buffer */
+    uint32_t pos;               /* file location after buffer */
+    uint16_t read_num;          /* number of buffers read after the first one */
+    __json_mark_t mark;         /* structural marks of buffer */
+}__json_reader_t;
+
+/* one entry of dictionary, as slices of the reader buffer */
+typedef struct {
+    const char*    key;         /* key string (not terminated, no escape) */
+    uint8_t        key_len;     /* length of key (0 if longer than 255) */
+    const uint8_t* val;         /* content of value array between "[" and "]" */
+    uint16_t       val_len;     /* length of value array content */
+}__json_entry_t;
+
+uint8_t zh_json_reader_open(__json_reader_t* rd, zh_storage_t* st, uint32_t offset, uint8_t* buf, uint16_t buf_sz);
+uint8_t zh_json_next_entry(__json_reader_t* rd, __json_entry_t* e);
+uint8_t zh_json_next_string(const uint8_t** p, const uint8_t* end, char* out, uint8_t out_sz, uint8_t* out_len);
+uint8_t zh_json_next_number(const uint8_t** p, const uint8_t* end, uint32_t* num);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_learn.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : usage learning by counters of committed candidates
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * key of a counter is the 32-bit FNV-1a hash of pinyin, a 0xFF byte (never in
+ * pinyin or utf-8) and text, only the hash is stored (0 marks an empty slot).
+ * slots of a key are [hash, hash + ZH_LEARN_PROBE) (mod table size). each slot
+ * keeps the count and the half life period of its last commit, the count read
+ * is shifted right by the number of periods passed since then.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_learn.h"
+
+#if (USE_ZH_LEARN == 1)
+
+#define LEARN_TMP_FILE_NAME     ZH_LEARN_FILE_NAME ".tmp"
+#define LEARN_FILE_SZ           (ZH_LEARN_HDR_SZ + ZH_LEARN_TABLE_SZ * ZH_LEARN_SLOT_SZ)
+
+typedef struct {
+    uint32_t fp;        /* hash of key (0 : empty slot) */
+    uint16_t stamp;     /* half life period of the last commit */
+    uint8_t  count;     /* count at the last commit */
+    uint8_t  reserved;
+}__learn_slot_t;
+
+/************************   private functions   *********************************/
+
+static uint32_t learn_hash(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len);
+static uint8_t  learn_decayed(const __learn_slot_t* s);
+static void     learn_put32(uint8_t* p, uint32_t v);
+static uint32_t learn_get32(const uint8_t* p);
+
+static __learn_slot_t learn_slot[ZH_LEARN_TABLE_SZ];
+static uint16_t learn_num = 0;         /* number of used slots */
+static uint32_t learn_clock = 0;       /* number of commits */
+static uint32_t learn_gen = 0;         /* changed on each commit */
+
+/* hash of (pinyin, text), never 0 */
+static uint32_t learn_hash(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len) {
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < pinyin_len; i++) h = (h ^ (uint8_t)pinyin[i]) * 16777619u;
+    h = (h ^ 0xFF) * 16777619u;
+    for (uint8_t i = 0; i < text_len; i++) h = (h ^ (uint8_t)text[i]) * 16777619u;
+    return h ? h : 1;
+}
+
+/* count of slot after decay */
+static uint8_t learn_decayed(const __learn_slot_t* s) {
+    uint16_t age = (uint16_t)(learn_clock / ZH_LEARN_HALF_LIFE) - s->stamp;
+    return (age >= 8) ? 0 : (uint8_t)(s->count >> age);
+}
+
+static void learn_put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t learn_get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief count a candidate committed by user
+ * @param pinyin  input letters covered by candidate (first piece for a character, whole input for a word)
+ * @param text    utf-8 text of candidate (not terminated)
+ * @return 0: success, 1: invalid parameter
+ */
+uint8_t zh_commit(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len) {
+    if (pinyin == NULL || text == NULL || pinyin_len == 0 || text_len == 0) return 1;
+    uint32_t fp = learn_hash(pinyin, pinyin_len, text, text_len);
+    ZH_LEARN_LOCK();
+    __learn_slot_t* s = NULL, * v = NULL;   /* slot of key, slot to replace */
+    for (uint8_t i = 0; i < ZH_LEARN_PROBE && s == NULL; i++) {
+        __learn_slot_t* p = &learn_slot[(fp + i) & (ZH_LEARN_TABLE_SZ - 1)];
+        if (p->fp == fp) s = p;
+        else if (v == NULL || (v->fp != 0 && (p->fp == 0 || learn_decayed(p) < learn_decayed(v)))) v = p;
+    }
+    uint8_t count = 0;
+    if (s != NULL) {
+        count = learn_decayed(s);
+    }
+    else {
+        s = v;
+        if (s->fp == 0) learn_num++;
+        s->fp = fp;
+    }
+    learn_clock++;
+    s->count = (count < UINT8_MAX) ? count + 1 : UINT8_MAX;
+    s->stamp = (uint16_t)(learn_clock / ZH_LEARN_HALF_LIFE);
+    learn_gen++;
+    ZH_LEARN_UNLOCK();
+    return 0;
+}
+
+/* decayed count of candidate (pinyin, text), 0 if it's never committed */
+uint8_t zh_learn_count(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len) {
+    if (learn_num == 0) return 0;
+    uint32_t fp = learn_hash(pinyin, pinyin_len, text, text_len);
+    uint8_t count = 0;
+    ZH_LEARN_LOCK();
+    for (uint8_t i = 0; i < ZH_LEARN_PROBE; i++) {
+        const __learn_slot_t* p = &learn_slot[(fp + i) & (ZH_LEARN_TABLE_SZ - 1)];
+        if (p->fp == fp) {
+            count = learn_decayed(p);
+            break;
+        }
+    }
+    ZH_LEARN_UNLOCK();
+    return count;
+}
+
+/* number of candidates counted */
+uint16_t zh_learn_num(void) {
+    return learn_num;
+}
+
+/* generation of counters, it's changed on each commit (results matched with an older generation are stale) */
+uint32_t zh_learn_gen(void) {
+    return learn_gen;
+}
+
+/* forget all the counters */
+void zh_learn_clear(void) {
+    ZH_LEARN_LOCK();
+    memset(learn_slot, 0, sizeof(learn_slot));
+    learn_num = 0;
+    learn_clock = 0;
+    learn_gen++;
+    ZH_LEARN_UNLOCK();
+}
+
+/**
+ * @brief read counters from the snapshot file ZH_LEARN_FILE_NAME
+ * @return 0: success, 1: file not exist or invalid (counters are not changed)
+ */
+uint8_t zh_learn_load(void) {
+    FILE* fp = fopen(ZH_LEARN_FILE_NAME, "rb");
+    if (fp == NULL) return 1;
+    uint8_t* buf = (uint8_t*)zh_buffer_malloc(LEARN_FILE_SZ);
+    uint8_t res = (buf == NULL || fread(buf, 1, LEARN_FILE_SZ, fp) != LEARN_FILE_SZ);
+    fclose(fp);
+    if (!res && (memcmp(buf, ZH_LEARN_MAGIC, 4) != 0 || buf[4] != ZH_LEARN_VERSION || learn_get32(buf + 8) != ZH_LEARN_TABLE_SZ)) {
+        ZH_LOG_WARNING("invalid learned counter file");
+        res = 1;
+    }
+    if (!res) {
+        ZH_LEARN_LOCK();
+        learn_num = 0;
+        learn_clock = learn_get32(buf + 12);
+        for (uint16_t i = 0; i < ZH_LEARN_TABLE_SZ; i++) {
+            const uint8_t* p = buf + ZH_LEARN_HDR_SZ + (uint32_t)i * ZH_LEARN_SLOT_SZ;
+            learn_slot[i].fp = learn_get32(p);
+            learn_slot[i].stamp = (uint16_t)(p[4] | (p[5] << 8));
+            learn_slot[i].count = p[6];
+            learn_slot[i].reserved = 0;
+            if (learn_slot[i].fp != 0) learn_num++;
+        }
+        learn_gen++;
+        ZH_LEARN_UNLOCK();
+    }
+    if (buf != NULL) zh_buffer_free(buf);
+    return res;
+}
+
+/**
+ * @brief write counters to the snapshot file ZH_LEARN_FILE_NAME
+ * @note  counters are copied under lock, the file is written without it (to a temporary file
+ *        renamed over the old one), so commits are not blocked by the file system
+ * @return 0: success, 1: failed (the old file is kept)
+ */
+uint8_t zh_learn_save(void) {
+    uint8_t* buf = (uint8_t*)zh_buffer_malloc(LEARN_FILE_SZ);
+    if (buf == NULL) return 1;
+    memcpy(buf, ZH_LEARN_MAGIC, 4);
+    buf[4] = ZH_LEARN_VERSION;
+    buf[5] = buf[6] = buf[7] = 0;
+    learn_put32(buf + 8, ZH_LEARN_TABLE_SZ);
+    ZH_LEARN_LOCK();
+    learn_put32(buf + 12, learn_clock);
+    for (uint16_t i = 0; i < ZH_LEARN_TABLE_SZ; i++) {
+        uint8_t* p = buf + ZH_LEARN_HDR_SZ + (uint32_t)i * ZH_LEARN_SLOT_SZ;
+        learn_put32(p, learn_slot[i].fp);
+        p[4] = (uint8_t)learn_slot[i].stamp;
+        p[5] = (uint8_t)(learn_slot[i].stamp >> 8);
+        p[6] = learn_slot[i].count;
+        p[7] = 0;
+    }
+    ZH_LEARN_UNLOCK();
+
+    FILE* fp = fopen(LEARN_TMP_FILE_NAME, "wb");
+    uint8_t res = (fp == NULL || fwrite(buf, 1, LEARN_FILE_SZ, fp) != LEARN_FILE_SZ);
+    if (fp != NULL && fclose(fp) != 0) res = 1;
+    zh_buffer_free(buf);
+    if (!res && rename(LEARN_TMP_FILE_NAME, ZH_LEARN_FILE_NAME) != 0) {
+        remove(ZH_LEARN_FILE_NAME);   /* rename doesn't replace existing file on windows */
+        res = (rename(LEARN_TMP_FILE_NAME, ZH_LEARN_FILE_NAME) != 0);
+    }
+    if (res) {
+        remove(LEARN_TMP_FILE_NAME);
+        ZH_LOG_WARNING("save learned counters failed");
+    }
+    return res;
+}
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_learn.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : usage learning by counters of committed candidates
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_LEARN is set to 1. each candidate the
+ * user commits is counted by (pinyin it covers, utf-8 text), and the match
+ * functions move the counted candidates before the others (higher count
+ * first, the order of dictionary is kept for the same count) :
+ *
+ *   zh_commit("zhong", 5, "中", 3);    // character of first piece "zhong"
+ *   zh_commit("nihao", 5, "你好", 6);  // word of whole input "nihao"
+ *
+ * zh_commit_cand() and zh_session_select_candidate() commit a candidate of
+ * candidate list directly. counters are kept in a fixed hash table of
+ * ZH_LEARN_TABLE_SZ slots (fingerprint of key only), an update probes at most
+ * ZH_LEARN_PROBE slots and allocates nothing, so it can run in the keypress
+ * handler. counters are halved every ZH_LEARN_HALF_LIFE commits (applied when
+ * a slot is read), so old habits fade. when the probed slots are all used,
+ * the one with the smallest count is replaced.
+ *
+ * the table is saved to ZH_LEARN_FILE_NAME by zh_learn_save() (call it when
+ * idle or before power off) and read back by zh_learn_load() :
+ *
+ *   header : magic(4) | version(1) | reserved(3) | slot_num(4) | commits(4)
+ *   slots  : fingerprint(4) | stamp(2) | count(1) | reserved(1), slot_num times
+ *
+ * define ZH_LEARN_LOCK() and ZH_LEARN_UNLOCK() (e.g. by a mutex of RTOS) when
+ * candidates are committed while other threads decode.
+ *****************************************************************************
+ */
+#ifndef __ZH_LEARN_H
+#define __ZH_LEARN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+
+#if (USE_ZH_LEARN == 1)
+
+#define ZH_LEARN_TABLE_SZ       1024    /* number of slots (power of 2), 8 bytes each */
+#define ZH_LEARN_PROBE          4       /* slots probed for a key */
+#define ZH_LEARN_HALF_LIFE      256     /* counters are halved every this number of commits */
+
+#define ZH_LEARN_MAGIC          "ZHLN"
+#define ZH_LEARN_VERSION        1
+#define ZH_LEARN_HDR_SZ         16
+#define ZH_LEARN_SLOT_SZ        8
+
+#if (ZH_LEARN_TABLE_SZ & (ZH_LEARN_TABLE_SZ - 1)) != 0
+    #error "ZH_LEARN_TABLE_SZ must be power of 2"
+#endif
+
+#ifndef ZH_LEARN_LOCK
+#define ZH_LEARN_LOCK()         do{}while(0)
+#define ZH_LEARN_UNLOCK()       do{}while(0)
+#endif
+
+uint8_t zh_commit(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len);
+uint8_t zh_learn_count(const char* pinyin, uint8_t pinyin_len, const char* text, uint8_t text_len);
+uint16_t zh_learn_num(void);
+uint32_t zh_learn_gen(void);
+void zh_learn_clear(void);
+uint8_t zh_learn_load(void);
+uint8_t zh_learn_save(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -23,52 +23,195 @@
 #include "zh_hash_boost.h"
 #endif
 
+#if (USE_ZH_VAGUE_TABLE == 1)
+#include "zh_vague_table.h"
+#endif
+
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+#include "zh_char_id.h"
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
+#include "zh_result_cache.h"
+#endif
+
 #if (USE_ZH_WORD_MATCH == 1)
-#include <ctype.h>
-#include "../CJSON/cJSON.h"
+#if (USE_ZH_WORD_DICT_BIN == 1)
+#include "zh_word_dict.h"
+#if (USE_ZH_WORD_TRIE == 1)
+#include "zh_word_trie.h"
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+#include "zh_word_abbr.h"
+#endif
+#define WORD_DICT_FILE_NAME  ZH_WORD_DICT_BIN_FILE_NAME
+#else
+#include <sys/stat.h>
+#include "zh_word_dict.h"     /* weight of word frequency */
+#include "zh_json_index.h"
+#include "zh_json_token.h"
+#define WORD_DICT_FILE_NAME  ZH_WORD_DICTIONARY_FILE_NAME
+#endif
+#endif
+
+#if (USE_ZH_USER_DICT == 1)
+#include "zh_user_dict.h"
+#endif
+
+#if (USE_ZH_LEARN == 1)
+#include "zh_learn.h"
 #endif
 
 /************************* private vairables ***************************************/
 
-static int g_word_match_number = 0;
-static int g_word_match_max = ZH_PINYIN_MAX_SPLIT_METHODS;
+/* default context shared by the functions without "_r" suffix (not thread safe) */
+static zh_decoder_t g_decoder = { NULL };
 
-#if (USE_ZH_WORD_MATCH == 1)
-static uint8_t word_dict_buffer[ZH_WORD_DICT_BUFFER_SZ];
+/* changed when a resident table is loaded or released, results cached before are dropped (the abbreviation 
+   index changes results, the others give the same results only when their files agree with the files read without them) */
+static uint32_t table_gen = 0;
+
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+static uint8_t* code_table_data = NULL;    /* resident copy of code table file (NULL if not loaded) */
+static uint32_t code_table_size = 0;       /* size of resident code table */
+#endif
+
+#if (USE_ZH_VAGUE_TABLE == 1)
+static __vague_table_t vague_table = { 0 };  /* precomputed vague match results (slots is NULL if not loaded) */
+#endif
+
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+static __char_id_table_t char_id_table = { 0 };  /* resident character id code table (ids is NULL if not loaded) */
+#endif
+
+#if (USE_ZH_WORD_TRIE == 1)
+static __word_trie_t word_trie = { 0 };    /* resident key trie (base is NULL if not loaded) */
+#endif
+
+#if (USE_ZH_WORD_ABBR == 1)
+static __word_abbr_t word_abbr = { 0 };    /* resident abbreviation index (keys is NULL if not loaded) */
+#endif
+
+#if (USE_ZH_WORD_BOUND == 1)
+static uint8_t* word_bound = NULL;         /* resident max word weight of each key (NULL if not loaded) */
+static uint32_t word_bound_num = 0;        /* number of keys of word_bound */
+#endif
 
-const uint32_t word_dict_offset[26] = { 0x00, 0x2A92 ,0x12CDB ,0x24184, 0x36696, 0x37ACC, 0x434A0, 0x52F50,
-                                        0x00 , 0x621CC, 0x787EB, 0x809A8, 0x8E942, 0x98543, 0x9E815, 0x9ECC8,
-                                        0xA4FD2, 0xAFA24, 0xB448E, 0xCE4C5, 0x00, 0x00, 0xDA638, 0xE499F, 0xF745F, 0x10D105};
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+static __json_index_t json_index = { 0 };  /* sparse key offset index of json dictionary (offset is NULL if not loaded) */
+#endif
 
+#if (USE_ZH_WORD_MATCH == 1)
+/* word kept by top-k word search */
+typedef struct {
+    uint8_t  wt;                        /* weight of word */
+    uint8_t  len;                       /* number of characters */
+    uint16_t seq;                       /* order it's found, the earlier one ranks higher for the same weight */
+    char     text[3 * MAX_WORD_LENGTH];
+#if (USE_ZH_LEARN == 1)
+    uint8_t  lc;                        /* learned count, counted words rank before the others */
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+    uint8_t  abbr;                      /* 1: found only by a syllable taken as initial, ranks after the others */
+#endif
+}__word_topk_item_t;
+
+/* the heaviest MAX_WORD_BLK_WORD_NUM words found, item[0] is the lowest ranked (min heap) */
+typedef struct {
+    __word_topk_item_t item[MAX_WORD_BLK_WORD_NUM];
+    uint8_t  num;
+    uint16_t seq;
+#if (USE_ZH_WORD_ABBR == 1)
+    uint8_t  abbr;                      /* abbr flag of the words pushed */
+#endif
+#if (USE_ZH_USER_DICT == 1)
+    uint8_t  boost;                     /* max weight user dictionary adds to a word of dictionary */
+#endif
+}__word_topk_t;
 #endif
 
 /*******************   private function prototypes     ****************************/
 
 static uint8_t chk_valid_string(const char* str);
+static void* query_malloc(zh_decoder_t* dec, size_t sz);
+static void query_free(zh_decoder_t* dec, void* p);
+static void query_begin(zh_decoder_t* dec);
+static void query_end(zh_decoder_t* dec);
+static uint8_t code_table_open(zh_decoder_t* dec, zh_storage_t* tmp, zh_storage_t** st);
+static void code_table_close(zh_decoder_t* dec, zh_storage_t* st);
+static uint8_t code_table_read(zh_storage_t* st, uint32_t loc, char* buf, uint16_t len);
+static uint8_t code_table_get(zh_storage_t* st, uint8_t idx, uint8_t syl, uint8_t first, uint8_t n, char* buf);
+static uint8_t code_match_vague(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br);
+#if (USE_ZH_LEARN == 1)
+static void learn_rerank_codes(const char* pinyin, char* codes, uint8_t num, uint8_t rev);
+#endif
+#if (USE_ZH_HASH_BOOST == 0)
 static uint8_t common_prefix_length(const char* str1, const char* str2);
+#endif
 
-static __split_method_t* mnode_init(void);
-static int mnode_cmp(__split_method_t* m1, __split_method_t* m2);
-static __split_method_list_t* mlist_init(void);
+static __split_method_t* mnode_init(zh_decoder_t* dec);
+static __split_method_list_t* mlist_init(zh_decoder_t* dec);
 static uint8_t mnode_prec(__split_method_t* m);
-static void mlist_insert(__split_method_list_t* m_list, __split_method_t* m);
-static void mlist_remove(__split_method_list_t* m_list, uint8_t idx);
-static void mlist_destroy(__split_method_list_t* m_list);
+static void mlist_remove(zh_decoder_t* dec, __split_method_list_t* m_list, uint8_t idx);
+static void mlist_destroy(zh_decoder_t* dec, __split_method_list_t* m_list);
 
 static uint8_t get_match_idx(const char* str, int8_t* match_idx, const uint8_t vag_num, uint8_t* vag_idx_arr, int8_t* vag_br);
-static uint8_t pinyin_dfs(__split_method_list_t* m_list, const char* str, uint8_t* spm, uint8_t m_wt, uint8_t depth);
+static void pinyin_lattice_update(__pinyin_lattice_t* lat, const char* str, uint8_t len, uint8_t from);
+static void pinyin_lattice_build(__pinyin_lattice_t* lat, const char* str, uint8_t len);
+static uint8_t pinyin_lattice_split(zh_decoder_t* dec, const __pinyin_lattice_t* lat, __split_method_list_t* m_list, uint8_t len);
+static uint8_t pinyin_lattice_syllables(const __pinyin_lattice_t* lat, const char* str, uint8_t len);
+static __split_method_list_t* pinyin_lattice_list(zh_decoder_t* dec, const __pinyin_lattice_t* lat, const char* str, uint8_t len);
 
 #if (USE_ZH_WORD_MATCH == 1)
 
-static __word_block_t* wordblock_init(uint8_t type);
+static __word_block_t* wordblock_init(zh_decoder_t* dec, uint8_t type);
 static void wordblock_append(__word_block_t** head, __word_block_t* w);
-static void wordblock_destroy(__word_block_t* w);
+static void wordblock_destroy(zh_decoder_t* dec, __word_block_t* w);
+
+static uint8_t dict_file_open(zh_decoder_t* dec, zh_storage_t* tmp, zh_storage_t** st);
+static void dict_file_close(zh_decoder_t* dec, zh_storage_t* st);
+static int str_match_key(const char* str, __split_method_t* m, const char* key);
+static __split_method_t* mlist_match_key(__split_method_list_t* m_list, const char* str, const char* key, uint8_t* idx);
+static void mlist_match_done(zh_decoder_t* dec, __split_method_list_t* m_list, __split_method_t* m, uint8_t idx);
+static uint8_t topk_lower(const __word_topk_item_t* a, const __word_topk_item_t* b);
+static uint8_t topk_rank_lower(const __word_topk_item_t* a, const __word_topk_item_t* b);
+static void topk_push(__word_topk_t* tk, uint8_t wt, const char* text, uint8_t len);
+static uint8_t topk_flush(__word_topk_t* tk, char* res_str, uint8_t* word_nbr);
+#if (USE_ZH_WORD_DICT_BIN == 1)
+static void word_dict_copy(const uint8_t* rec, const __split_method_t* m, __word_topk_t* tk);
+static uint32_t word_key_bound(const __word_dict_info_t* info, uint32_t key);
+static uint8_t topk_closed(const __word_topk_t* tk, uint32_t bound);
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+static void word_dict_trie_scan(zh_decoder_t* dec, zh_storage_t* st, const __word_dict_info_t* info, const char* str, __split_method_list_t* m_list, __word_topk_t* tk);
+#endif
+#if (USE_ZH_WORD_ABBR == 1)
+static uint8_t mlist_relax_initials(__split_method_list_t* m_list, uint8_t* wt);
+static void word_dict_abbr_scan(zh_decoder_t* dec, zh_storage_t* st, const __word_dict_info_t* info, const char* str, __split_method_list_t* m_list, const uint8_t* wt, __word_topk_t* tk);
+#endif
+#if (USE_ZH_WORD_DICT_BIN == 1)
+static void dict_key_range(zh_storage_t* st, const __word_dict_info_t* info, __zh_match_cache_t* cache, const char* str, uint8_t len, uint32_t* lo, uint32_t* hi);
+#endif
+#if (USE_ZH_USER_DICT == 1)
+static void user_word_push(const char* str, __split_method_list_t* m_list, __word_topk_t* tk);
+#endif
+static void word_dict_find(zh_decoder_t* dec, zh_storage_t* st, const char* str, __split_method_list_t* m_list, __zh_match_cache_t* cache, __word_topk_t* tk);
+static uint8_t word_dict_scan(zh_decoder_t* dec, zh_storage_t* st, const char* str, __split_method_list_t* m_list, char* res_str, uint8_t* word_nbr, __zh_match_cache_t* cache);
+static __word_block_t* word_dict_exit(zh_decoder_t* dec, char** res_str);
+static uint8_t word_match_code(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list, char* res_str, uint8_t* br, uint8_t* search_state, __zh_match_cache_t* cache);
+static __word_block_t* word_dict_search(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list);
+static uint8_t cand_fill(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list, __zh_cand_list_t* list, __zh_match_cache_t* cache);
+#if (USE_ZH_RESULT_CACHE == 1)
+static uint8_t cand_cache_get(zh_decoder_t* dec, const char* str, __split_method_t* sp, __zh_cand_list_t* list);
+static void cand_cache_put(zh_decoder_t* dec, const char* str, const __split_method_t* sp, const __zh_cand_list_t* list);
+static __word_block_t* word_cache_get(zh_decoder_t* dec, const char* str, __split_method_t* sp);
+static void word_cache_put(zh_decoder_t* dec, const char* str, const __split_method_t* sp, const __word_block_t* w);
+#endif
 
-static int str_match_cjson(const char* str, __split_method_t* m, cJSON* item);
-static cJSON* cjson_parse_piece(char* buf, uint32_t* bytes_left);
-static __word_block_t* word_dict_exit(char** res_str);
-static __word_block_t* word_dict_search(const char* str, __split_method_list_t* m_list);
+#endif
 
+#if (USE_ZH_RESULT_CACHE == 1)
+static void result_cache_sync(zh_decoder_t* dec);
 #endif
 
 /************************   private functions   *********************************/
@@ -85,6 +228,182 @@ static uint8_t chk_valid_string(const char* str) {
     return 0;
 }
 
+/**
+* @brief  split method list of lattice (query memory is held until zh_pinyin_free_split_r)
+* @return NULL if no split method or malloc failed
+*/
+static __split_method_list_t* pinyin_lattice_list(zh_decoder_t* dec, const __pinyin_lattice_t* lat, const char* str, uint8_t len) {
+    query_begin(dec);
+    __split_method_list_t* m_list = mlist_init(dec);
+    if (m_list == NULL) {
+        query_end(dec);
+        return NULL;
+    }
+    if (pinyin_lattice_split(dec, lat, m_list, len) || m_list->head == NULL) {
+        zh_pinyin_free_split_r(dec, m_list);
+        return NULL;
+    }
+    m_list->syl = pinyin_lattice_syllables(lat, str, len);
+    return m_list;
+}
+
+/**
+ * @brief  allocate memory for a query result (split methods, word blocks and their buffers)
+ * @note   when USE_ZH_QUERY_ARENA is set, memory is cut from the arena of context, and heap is 
+ *         only used when arena is full. memory is aligned to pointer size.
+ */
+static void* query_malloc(zh_decoder_t* dec, size_t sz) {
+#if (USE_ZH_QUERY_ARENA == 1)
+    __zh_arena_t* a = &dec->arena;
+    sz = (sz + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    if (sz <= sizeof(a->buf) - a->used) {
+        void* p = (uint8_t*)a->buf + a->used;
+        a->last = a->used;
+        a->used += sz;
+        if (a->used > a->peak) a->peak = a->used;
+        return p;
+    }
+#endif
+    return zh_buffer_malloc(sz);
+}
+
+/**
+ * @brief  free memory from query_malloc
+ * @note   memory in arena is not released one by one (except the last allocation), 
+ *         but all at once by query_end()
+ */
+static void query_free(zh_decoder_t* dec, void* p) {
+    if (p == NULL) return;
+#if (USE_ZH_QUERY_ARENA == 1)
+    __zh_arena_t* a = &dec->arena;
+    if ((uint8_t*)p >= (uint8_t*)a->buf && (uint8_t*)p < (uint8_t*)a->buf + sizeof(a->buf)) {
+        if ((uint8_t*)p == (uint8_t*)a->buf + a->last) a->used = a->last;
+        return;
+    }
+#endif
+    zh_buffer_free(p);
+}
+
+/* a query result is going to be returned (arena must be kept until it's freed) */
+static void query_begin(zh_decoder_t* dec) {
+#if (USE_ZH_QUERY_ARENA == 1)
+    dec->arena.refs++;
+#endif
+}
+
+/* a query result is freed, reset the arena when no result is alive */
+static void query_end(zh_decoder_t* dec) {
+#if (USE_ZH_QUERY_ARENA == 1)
+    if (dec->arena.refs > 0) dec->arena.refs--;
+    if (dec->arena.refs == 0) dec->arena.used = dec->arena.last = 0;
+#endif
+}
+
+/**
+ * @brief  open code table file for reading
+ * @note   when code table (or character id table) is resident in RAM, no file is opened and *st is set to NULL. 
+ *         if the context keeps the file opened, that file is used. 
+ * @param  dec decoder context
+ * @param  tmp storage to open the file in when the context doesn't keep it
+ * @param  st  pointer to store the opened file
+ * @return 0: success, 1: file not exist
+ */
+static uint8_t code_table_open(zh_decoder_t* dec, zh_storage_t* tmp, zh_storage_t** st) {
+    *st = NULL;
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+    if (char_id_table.ids != NULL) return 0;
+#endif
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+    if (code_table_data != NULL) return 0;
+#endif
+    if (dec->code_st.be != NULL) {
+        *st = &dec->code_st;
+        return 0;
+    }
+    if (zh_storage_open(tmp, ZH_CODE_TABLE_FILE_NAME)) {
+        ZH_LOG_ERROR("code table file \"zh pinyin.bin\" not exist");
+        return 1;
+    }
+    *st = tmp;
+    return 0;
+}
+
+/* close the code table file opened by code_table_open (file kept by context is not closed) */
+static void code_table_close(zh_decoder_t* dec, zh_storage_t* st) {
+    if (st != NULL && st != &dec->code_st) zh_storage_close(st);
+}
+
+/**
+ * @brief  read code table piece from the resident buffer (if loaded) or from file
+ * @param  st   file opened by code_table_open (not used when code table is resident)
+ * @param  loc  location in code table file
+ * @param  buf  buffer to store the data read
+ * @param  len  number of bytes to read
+ * @return 0: success, 1: read error
+ */
+static uint8_t code_table_read(zh_storage_t* st, uint32_t loc, char* buf, uint16_t len) {
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+    if (code_table_data != NULL) {
+        if (loc + len > code_table_size) return 1;
+        memcpy(buf, code_table_data + loc, len);
+        return 0;
+    }
+#endif
+    return st == NULL || zh_storage_read_at(st, loc, buf, len) != len;
+}
+
+/**
+ * @brief  get utf-8 characters of a syllable, from the character id table (if loaded) or code table
+ * @param  st    file opened by code_table_open
+ * @param  idx   first letter index of syllable (str[0] - 'a')
+ * @param  syl   index of syllable in code_index[idx]
+ * @param  first index of the first character to get in syllable
+ * @param  n     number of characters to get (3 * n bytes are written to buf, not terminated)
+ * @return 0: success, 1: read error
+ */
+static uint8_t code_table_get(zh_storage_t* st, uint8_t idx, uint8_t syl, uint8_t first, uint8_t n, char* buf) {
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+    if (char_id_table.ids != NULL) {
+        zh_char_id_emit(zh_char_id_syllable(&char_id_table, idx, syl) + first, n, buf);
+        return 0;
+    }
+#endif
+    const __code_index_t* codex = (&code_index[idx]);
+    return code_table_read(st, codex->char_start + codex->code_offset[syl] + 3 * (uint32_t)first, buf, 3 * (uint16_t)n);
+}
+
+#if (USE_ZH_LEARN == 1)
+
+/**
+ * @brief move the codes committed by user (counted with pinyin) before the others, higher count first,
+ *        the order of the same count is kept
+ * @param rev  codes are in reversed order (the first one is at the end)
+ */
+static void learn_rerank_codes(const char* pinyin, char* codes, uint8_t num, uint8_t rev) {
+    if (zh_learn_num() == 0 || num < 2) return;
+    uint8_t cnt[UINT8_MAX], found = 0, len = (uint8_t)strlen(pinyin);
+    for (uint8_t i = 0; i < num; i++) {
+        cnt[i] = zh_learn_count(pinyin, len, codes + 3 * i, 3);
+        found |= cnt[i];
+    }
+    if (!found) return;
+    /* insertion sort, only the counted codes move */
+    for (uint8_t i = 1; i < num; i++) {
+        uint8_t c = cnt[i], j = i;
+        char code[3];
+        memcpy(code, codes + 3 * i, 3);
+        for (; j > 0 && (rev ? cnt[j - 1] > c : cnt[j - 1] < c); j--) {
+            cnt[j] = cnt[j - 1];
+            memcpy(codes + 3 * j, codes + 3 * (j - 1), 3);
+        }
+        cnt[j] = c;
+        memcpy(codes + 3 * j, code, 3);
+    }
+}
+
+#endif
+
+#if (USE_ZH_HASH_BOOST == 0)
 /**
  * @brief  get the common prefix length of two string
  * @return common length
@@ -97,15 +416,16 @@ static uint8_t common_prefix_length(const char* str1, const char* str2) {
     }
     return str1 - start1;
 }
+#endif
 
 /**
  * @brief init method node (sigle linked list node)
  * @return __split_method_t* node pointer
  */
-static __split_method_t* mnode_init(void) {
-    __split_method_t* m = zh_buffer_malloc(sizeof(__split_method_t));
+static __split_method_t* mnode_init(zh_decoder_t* dec) {
+    __split_method_t* m = query_malloc(dec, sizeof(__split_method_t));
     if (m == NULL) {
-        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        ZH_LOG_ERROR("query_malloc failed");
         return NULL;
     }
     memset(m->spm, 0, MAX_WORD_LENGTH);
@@ -116,18 +436,6 @@ static __split_method_t* mnode_init(void) {
     return m;
 }
 
-/**
-* @brief compare the method (decide the sequence that method in list.) 
-* @note compare insert sequence : insert seq : 1.m->length(shorter)  2.m->wt(larger)  3.m->spm(smaller)
-* @note  m1 and m2 must not be NULL 
-* @return < 0 m1 is before m2,  = 0: same , >0: m1 is after m2
-*/
-static int mnode_cmp(__split_method_t* m1, __split_method_t* m2) {
-    if (m1->length != m2->length) return m1->length - m2->length;
-    if (m1->wt != m2->wt) return  m2->wt - m1->wt;
-    return memcmp(m1->spm, m2->spm, m1->length - 1);
-}
-
 /**
  * @brief check if a split method is precise match method
  * @param m method for check
@@ -140,52 +448,26 @@ static uint8_t mnode_prec(__split_method_t* m){
 }
 
 /* init the split method linked list */
-static __split_method_list_t* mlist_init(void) {
-    __split_method_list_t* m_list = zh_buffer_malloc(sizeof(__split_method_list_t));
+static __split_method_list_t* mlist_init(zh_decoder_t* dec) {
+    __split_method_list_t* m_list = query_malloc(dec, sizeof(__split_method_list_t));
     if (m_list == NULL) {
-        ZH_LOG_ERROR("zh_buffer_malloc fail");
+        ZH_LOG_ERROR("query_malloc fail");
         return NULL;
     }
     m_list->num = 0;
+    m_list->syl = 0;
     m_list->head = NULL;
     // m_list->tail = NULL;
     return m_list;
 }
 
-/* insert a split method element to linked list */
-static void mlist_insert(__split_method_list_t* m_list, __split_method_t* m) {
-    if (m_list == NULL || m == NULL) return;
-    int res = m_list->head == NULL ? -1 : mnode_cmp(m, m_list->head);
-    if (res < 0) {
-        m->next = m_list->head;
-        m_list->head = m;
-        m_list->num++;
-        return;
-    }
-    if (res == 0) return; // do nothing
-    __split_method_t* pre = m_list->head;
-    __split_method_t* nxt = m_list->head->next;
-    while (1) {
-        res = (nxt == NULL) ? -1 : mnode_cmp(m, nxt);
-        if (res < 0) {
-            m->next = nxt;
-            pre->next = m;
-            m_list->num++;
-            return;
-        }
-        if (res == 0) return;
-        nxt = pre->next->next;
-        pre = pre->next;
-    }
-}
-
 /* remove the element on the index of list */
-static void mlist_remove(__split_method_list_t* m_list, uint8_t idx){
+static void mlist_remove(zh_decoder_t* dec, __split_method_list_t* m_list, uint8_t idx){
     if (m_list == NULL|| m_list->head == NULL || idx >= m_list->num) return;
     __split_method_t* pre = m_list->head;
     if (idx == 0) {
         m_list->head = pre->next;
-        zh_buffer_free(pre);
+        query_free(dec, pre);
         m_list->num--;
         return;
     }
@@ -193,22 +475,22 @@ static void mlist_remove(__split_method_list_t* m_list, uint8_t idx){
         pre = pre->next;
     }
     __split_method_t* nxt = pre->next->next;
-    zh_buffer_free(pre->next);
+    query_free(dec, pre->next);
     pre->next = nxt;
     m_list->num--;
 }
 
 /* free single linked list */
-static void mlist_destroy(__split_method_list_t* m_list) {
+static void mlist_destroy(zh_decoder_t* dec, __split_method_list_t* m_list) {
     if (m_list == NULL) return;
 
     __split_method_t* m = m_list->head;
     while (m != NULL) {
         __split_method_t* tmp = m;
         m = m->next;
-        zh_buffer_free(tmp);
+        query_free(dec, tmp);
     }
-    zh_buffer_free(m_list);
+    query_free(dec, m_list);
 }
 
 /**
@@ -239,38 +521,13 @@ static uint8_t get_match_idx(const char* str, int8_t* match_idx, const uint8_t v
         }
     }
 #else
-    if (strlen(str) == 1) {
-        if (strlen(codex->code_table[0]) == 1) {
-            /* 1st result precise, other vague result */
-            (*match_idx) = 0;
-            cur_vague_num = codex->table_length - 1 > vag_num ? vag_num : codex->table_length - 1;
-            for (int i = 0; i < cur_vague_num; i++) {
-                vag_idx_arr[i] = i + 1;
-            }
-        }
-        else {
-            /* all are vague result */
-            cur_vague_num = codex->table_length > vag_num ? vag_num : codex->table_length;
-            for (int i = 0; i < cur_vague_num; i++) {
-                vag_idx_arr[i] = i;
-            }
-        }
-    }
-    else 
-    {
-        if (!zh_hash_inlist(str)) return 1;
-        uint8_t idx2 = (str[1] - 'a') % ZH_HASH_TABLE_DIV;
-        for (int i = 0; i < hash_list[idx][idx2]->num; i++) {
-            uint8_t index = hash_list[idx][idx2]->idx_list[i];
-            if (strcmp(str, codex->code_table[index]) == 0) {
-                (*match_idx) = index;
-            }
-            else if (cur_vague_num < vag_num && strncmp(str, codex->code_table[index], strlen(str)) == 0) {
-                vag_idx_arr[cur_vague_num] = index;
-                cur_vague_num++;
-            }
-        }
-    }
+    /* one probe gives precise index and vague search sequence */
+    size_t len = strlen(str);
+    const __zh_hash_entry_t* e = zh_hash_find(str, len > ZH_HASH_KEY_MAX_LEN ? 0 : (uint8_t)len);
+    if (e == NULL) return 1;
+    (*match_idx) = e->prec;
+    cur_vague_num = __min(e->vague_num, vag_num);
+    if (cur_vague_num > 0) memcpy(vag_idx_arr, zh_hash_vague_idx + e->vague_start, cur_vague_num);
 #endif
     if (vag_br != NULL) {
         (*vag_br) = cur_vague_num;
@@ -279,91 +536,146 @@ static uint8_t get_match_idx(const char* str, int8_t* match_idx, const uint8_t v
 }
 
 /**
-* @brief  dfs algorithm function for pinyin split method
-* @note   dfs function terminate when search number >= ZH_PINYIN_MAX_SPLIT_METHODS to optimize performance.
-*         change ZH_PINYIN_MAX_SPLIT_METHODS if you need more split method.
-* @param  m_list split method list (we concatenate the split method into this list)
-* @param  str input string
-* @param  spm split method array (use MAX_WORD_LENGTH zero array when input) 
-* @param  m_wt split method weight (use 0 when input)
-* @param  depth split method depth (use 0 when input)
-* @return 0: success, 1: fail
+* @brief  rebuild the lattice rows from position "from" to the end of string
+* @note   each position is scanned once : piece str[p, p + l) is an edge if some syllable has common
+*         prefix of length l (l >= 2) with str[p:], it's precise if the syllable is the whole piece.
+*         if no such syllable, the single letter is used as an edge.
+*         then reach[] is filled backward, so that dead ends are never visited when extracting.
+*         row p only depends on str[p, p + MAX_WORD_CODE_LENGTH], so when the string is changed after
+*         position n, rows before n - MAX_WORD_CODE_LENGTH are kept.
+* @param  lat    lattice to update (rows before "from" are valid)
+* @param  str    input string (valid string)
+* @param  len    strlen(str)
+* @param  from   first row to rebuild
 */
-static uint8_t pinyin_dfs(__split_method_list_t* m_list, const char* str, uint8_t* spm, uint8_t m_wt, uint8_t depth) {
-    uint8_t start_idx = (depth == 0) ? 0 : spm[depth - 1];
-    /* termiate conditions -> string end */
-    if (start_idx == strlen(str)) {  /* note : depth must not be 0 here */
-        /* word split successfully, concanate the split method into m_list */
-        __split_method_t* m = mnode_init();
-        if (m == NULL) return 1;
-        m->length = depth;
-        m->wt = m_wt;
-        memcpy(m->spm, spm, sizeof(uint8_t) * depth);
-        memset(m->spm + depth, 0, MAX_WORD_LENGTH - depth);
-        mlist_insert(m_list, m);
-        g_word_match_number++;
-        return 0;
-    }
-    else if (depth == MAX_WORD_LENGTH) {
-        /* still not find the split method */
-        g_word_match_number++; return 1; 
-    }
-    if (g_word_match_number >= g_word_match_max) {
-        // ZH_LOG_INFO("reach the maximum search length, search terminated");
-        return 1;
-    }
-    uint8_t idx1 = str[start_idx] - 'a';
-    __code_index_t* codex = (&code_index[idx1]);
-    if (codex->table_length == 0) {
-        g_word_match_number++; return 1;
-    }
-    uint8_t sl = __min(strlen(str) - start_idx, MAX_WORD_CODE_LENGTH);   /* strlen (left_str) */
-    uint8_t res = 1;
-    if (sl > 1) {
+static void pinyin_lattice_update(__pinyin_lattice_t* lat, const char* str, uint8_t len, uint8_t from) {
+    if (from < len) memset(lat->edge[from], 0, sizeof(lat->edge[0]) * (len - from));
+    for (uint8_t p = from; p < len; p++) {
+        uint8_t idx1 = str[p] - 'a';
+        const __code_index_t* codex = (&code_index[idx1]);
+        if (codex->table_length == 0) continue;  /* no syllable starts with this letter */
+        uint8_t res = 1;
+        if (len - p > 1) {
 #if (USE_ZH_HASH_BOOST == 0)
-        for (int i = 0; i < codex->table_length; i++) {
-            uint8_t sr = strlen(codex->code_table[i]); /* strlen (result_str) */
-            uint8_t sc = common_prefix_length(str + start_idx, codex->code_table[i]);
-            if (sc <= 1) continue;  /* for */
-            res = 0;   /* have at least 1 vague match (1 letter occasion needn't to be considered) */
-            m_wt = sc == sr ? (m_wt | (1 << (MAX_WORD_LENGTH - 1 - depth))) : m_wt & ~(1 << (MAX_WORD_LENGTH - 1 - depth));  /* record precise match location */
-            spm[depth] = start_idx + sc;     /* the match part */
-            pinyin_dfs(m_list, str, spm, m_wt, depth + 1);  /* If any result is found, set res to 0 */
-        }
+            for (int i = 0; i < codex->table_length; i++) {
+                uint8_t sc = common_prefix_length(str + p, codex->code_table[i]);
+                if (sc <= 1) continue;  /* for */
+                res = 0;   /* have at least 1 vague match (1 letter occasion needn't to be considered) */
+                lat->edge[p][sc] |= (sc == strlen(codex->code_table[i])) ? ZH_PINYIN_EDGE_PREC : ZH_PINYIN_EDGE_VAGUE;
+            }
 #else
-        uint8_t idx2 = (str[start_idx + 1] - 'a') % ZH_HASH_TABLE_DIV;
-        char s_tmp[2] = {str[start_idx], str[start_idx + 1]};
-        if (zh_hash_inlist(s_tmp)) {
-            for (int i = 0; i < hash_list[idx1][idx2]->num; i++) {
-                uint8_t idx = hash_list[idx1][idx2]->idx_list[i];
-                uint8_t sr = strlen(codex->code_table[idx]);
-                uint8_t sc = common_prefix_length(str + start_idx, codex->code_table[idx]);
-                if (sc <= 1) continue;
+            /* walk the syllable prefix automaton from p, node is the entry of str[p, p + l). piece is 
+               vague if some syllable has common prefix of exactly length l with str[p:], i.e. it has more 
+               syllables starting with it than the next piece has */
+            int16_t node = zh_syl_step(ZH_SYL_ROOT, str[p]);
+            if (node >= 0) node = zh_syl_step(node, str[p + 1]);
+            for (uint8_t l = 2; node >= 0; l++) {
+                const __zh_hash_entry_t* e = &zh_hash_entry[node];
+                int16_t nxt = (p + l < len) ? zh_syl_step(node, str[p + l]) : -1;
+                uint8_t nxt_num = (nxt < 0) ? 0 : zh_hash_entry[nxt].vague_num + (zh_hash_entry[nxt].prec >= 0);
                 res = 0;
-                m_wt = sc == sr ? (m_wt | (1 << (MAX_WORD_LENGTH - 1 - depth))) : m_wt & ~(1 << (MAX_WORD_LENGTH - 1 - depth));  /* record precise match location */
-                spm[depth] = start_idx + sc;     /* the match part */
-                pinyin_dfs(m_list, str, spm, m_wt, depth + 1);
+                if (e->prec >= 0) lat->edge[p][l] |= ZH_PINYIN_EDGE_PREC;
+                if (e->vague_num > nxt_num) lat->edge[p][l] |= ZH_PINYIN_EDGE_VAGUE;
+                node = nxt;
             }
-        }
 #endif
+        }
+        if (res) { /**  no match found for len >=2, we can just split it in 1*/
+            lat->edge[p][1] = strlen(codex->code_table[0]) == 1 ? ZH_PINYIN_EDGE_PREC : ZH_PINYIN_EDGE_VAGUE;
+        }
+    }
+    /* reach[p] bit k : str[p:] can be split into k pieces */
+    lat->reach[len] = 1;
+    for (int p = len - 1; p >= 0; p--) {
+        lat->reach[p] = 0;
+        for (uint8_t l = 1; l <= MAX_WORD_CODE_LENGTH && p + l <= len; l++) {
+            if (lat->edge[p][l]) lat->reach[p] |= lat->reach[p + l] << 1;
+        }
+        lat->reach[p] &= (1 << (MAX_WORD_LENGTH + 1)) - 1;
     }
-    /* when all result is 1, no other split ways */
-    if (res) { /**  no match found for len >=2, we can just split it in 1*/
-        uint8_t tmp = __min(codex->table_length, ZH_PINYIN_SIGNLE_SEARCH_DEPTH);
-        code_index[idx1].code_table;
-        /* when 1 code can be fully matched */
-        m_wt = strlen(codex->code_table[0]) == 1 ? (m_wt | (1 << (MAX_WORD_LENGTH - 1 - depth))) : m_wt & ~(1 << (MAX_WORD_LENGTH - 1 - depth));
-        spm[depth] = start_idx + 1;   /* sc = 1 */
-        pinyin_dfs(m_list, str, spm, m_wt, depth + 1);
+}
+
+/* build the syllable lattice of the whole string */
+static void pinyin_lattice_build(__pinyin_lattice_t* lat, const char* str, uint8_t len) {
+    memset(lat, 0, sizeof(__pinyin_lattice_t));
+    pinyin_lattice_update(lat, str, len, 0);
+}
+
+/**
+* @brief  extract all the split methods from lattice in list order 
+* @note   methods are generated in list order : 1.m->length(shorter)  2.m->wt(larger)  3.m->spm(smaller),
+*         so they are appended to the list tail directly (zh_pinyin_filter_split_r may lower wt of a
+*         method without moving it). 
+*         every generated path is a complete split method since reach[] is checked for each edge.
+* @param  dec    decoder context
+* @param  lat    lattice built by pinyin_lattice_build
+* @param  m_list split method list (empty when input)
+* @param  len    strlen(str)
+* @return 0: success, 1: malloc failed
+*/
+static uint8_t pinyin_lattice_split(zh_decoder_t* dec, const __pinyin_lattice_t* lat, __split_method_list_t* m_list, uint8_t len) {
+    __split_method_t** tail = &m_list->head;
+    for (uint8_t length = 1; length <= MAX_WORD_LENGTH; length++) {
+        if (!(lat->reach[0] & (1 << length))) continue;
+        uint8_t shift = MAX_WORD_LENGTH - length;
+        for (int w = (1 << length) - 1; w >= 0; w--) {
+            uint8_t wt = (uint8_t)(w << shift);
+            uint8_t pos[MAX_WORD_LENGTH], l[MAX_WORD_LENGTH], spm[MAX_WORD_LENGTH] = { 0 };
+            int8_t  depth = 0;
+            pos[0] = 0; l[0] = 0;
+            while (depth >= 0) {
+                /* next edge of current depth */
+                if (++l[depth] > MAX_WORD_CODE_LENGTH || pos[depth] + l[depth] > len) {
+                    depth--;
+                    continue;
+                }
+                uint8_t q = pos[depth] + l[depth];
+                uint8_t need = (wt & (1 << (MAX_WORD_LENGTH - 1 - depth))) ? ZH_PINYIN_EDGE_PREC : ZH_PINYIN_EDGE_VAGUE;
+                if (!(lat->edge[pos[depth]][l[depth]] & need) || !(lat->reach[q] & (1 << (length - depth - 1)))) continue;
+                spm[depth] = q;
+                if (depth < length - 1) {
+                    depth++;
+                    pos[depth] = q;
+                    l[depth] = 0;
+                    continue;
+                }
+                /* word split successfully, concanate the split method into m_list */
+                __split_method_t* m = mnode_init(dec);
+                if (m == NULL) return 1;
+                m->length = length;
+                m->wt = wt;
+                memcpy(m->spm, spm, MAX_WORD_LENGTH);
+                *tail = m;
+                tail = &m->next;
+                m_list->num++;
+            }
+        }
     }
     return 0;
 }
 
+/**
+* @brief  check if the string splits fully into whole syllables (by precise edges of lattice)
+* @note   single consonant syllable ("m", "n") is taken as initial, so "jinm" is not a full split
+* @return 1: full split exists, 0: some piece is prefix or initial
+*/
+static uint8_t pinyin_lattice_syllables(const __pinyin_lattice_t* lat, const char* str, uint8_t len) {
+    uint8_t full[ZH_MAX_STRING_LENGTH + 1];
+    full[len] = 1;
+    for (int p = len - 1; p >= 0; p--) {
+        full[p] = 0;
+        for (uint8_t l = 1; l <= MAX_WORD_CODE_LENGTH && p + l <= len && !full[p]; l++) {
+            if ((lat->edge[p][l] & ZH_PINYIN_EDGE_PREC) && (l > 1 || strchr("aeo", str[p]) != NULL)) full[p] = full[p + l];
+        }
+    }
+    return full[0];
+}
+
 #if (USE_ZH_WORD_MATCH == 1)
 
 /// @param type refer to @defgroup word_block_type in zh_pinyin_decoder.h
-static __word_block_t* wordblock_init(uint8_t type) {
-    __word_block_t* w = zh_buffer_malloc(sizeof(__word_block_t));
+static __word_block_t* wordblock_init(zh_decoder_t* dec, uint8_t type) {
+    __word_block_t* w = query_malloc(dec, sizeof(__word_block_t));
     if (!w) return NULL;
     w->type = type;
     switch(type){
@@ -394,28 +706,46 @@ static void wordblock_append(__word_block_t** head, __word_block_t* w){
 }
 
 /** destroy the block one by one */
-static void wordblock_destroy(__word_block_t* w){
+static void wordblock_destroy(zh_decoder_t* dec, __word_block_t* w){
     if (w == NULL) return;
     while (w != NULL){
         if (w->type == WORD_BLK_TYPE_WORDS){
-            zh_buffer_free(w->num.word_nbr);
+            query_free(dec, w->num.word_nbr);
         }
-        zh_buffer_free(w->buf);
+        query_free(dec, w->buf);
         __word_block_t* tmp = w;
         w = w->next;
-        zh_buffer_free(tmp);
+        query_free(dec, tmp);
+    }
+}
+
+/* open word dictionary file (use the file kept by context if opened) */
+static uint8_t dict_file_open(zh_decoder_t* dec, zh_storage_t* tmp, zh_storage_t** st) {
+    *st = &dec->dict_st;
+    if (dec->dict_st.be != NULL) return 0;
+    *st = tmp;
+    if (zh_storage_open(tmp, WORD_DICT_FILE_NAME)) {
+        ZH_LOG_WARNING("Word Dictionary file not exist");
+        *st = NULL;
+        return 1;
     }
+    return 0;
+}
+
+/* close the word dictionary file opened by dict_file_open */
+static void dict_file_close(zh_decoder_t* dec, zh_storage_t* st) {
+    if (st != NULL && st != &dec->dict_st) zh_storage_close(st);
 }
 
 /**
-* @brief test if the string split matches a json object 
+* @brief test if the string split matches a dictionary key 
 * @param str string to match 
 * @param m   split method of this string 
-* @param item cjson object 
+* @param key key of dictionary (pinyin seperated by ' ')
 * @return 0: search succeed  1: not match (match failed)
 */
-static int str_match_cjson(const char* str, __split_method_t* m, cJSON* item) {
-    char* str2 = item->string;
+static int str_match_key(const char* str, __split_method_t* m, const char* key) {
+    const char* str2 = key;
     if (strlen(str) + m->length - 1 > strlen(str2)) return 1; /* string length check */
 
     uint8_t loc1 = 0, loc2 = 0;
@@ -445,314 +775,1280 @@ static int str_match_cjson(const char* str, __split_method_t* m, cJSON* item) {
     return 1;
 }
 
-/* parse cJSON file piece, return parse result */
-static cJSON* cjson_parse_piece(char* buf, uint32_t* bytes_left) {
-    uint8_t* pstart, * pend;
-    uint8_t  conn[2];           /* file piece connector array */
-    pstart = buf;
-    while (*pstart && isspace(*pstart)) pstart++;
-    if (pstart == '\0') return NULL;
-    /* build the left bracket "{" for piece */
-    if (*pstart != '{') {
-        while (*pstart && *pstart != ']') pstart++;
-        if (!pstart) return NULL;
-        pstart++;
-        /* can't find location for parse */
-        while (isspace(*pstart)) pstart++;
-        if (pstart - (uint8_t*)buf == ZH_WORD_DICT_BUFFER_SZ) return NULL;
-        if (*pstart == ',') {
-            *pstart = '{';
-        }
-        else { /* *pstart == '}' or other case */
-            return NULL;
+/**
+* @brief find the first split method in list which matches the dictionary key
+* @param idx  index of the matched method in list
+* @return matched method, NULL if no method match
+*/
+static __split_method_t* mlist_match_key(__split_method_list_t* m_list, const char* str, const char* key, uint8_t* idx) {
+    __split_method_t* m = m_list->head;
+    for (uint8_t i = 0; i < m_list->num; i++, m = m->next) {
+        if (str_match_key(str, m, key) == 0) {
+            *idx = i;
+            return m;
         }
     }
-    /* construct the final "}" for piece */
-    for (pend = buf + ZH_WORD_DICT_BUFFER_SZ - 2; pend != pstart; pend--) {
-        if (*pend == ']') {
-            uint8_t* pend_tmp = pend;  /* record address */
-            pend++;
-            while (isspace(*pend)) pend++;
-            /* if read to the end but can't find signal */
-            if (pend - (uint8_t*)buf == ZH_WORD_DICT_BUFFER_SZ) {
-                pend = pend_tmp;      /* relocate pointer */
-                continue;
-            }
-            memcpy(conn, pend, 2);
-            *pend = '}';
-            if (ZH_WORD_DICT_BUFFER_SZ - (pend - (uint8_t*)buf) != 1) {
-                *(pend + 1) = '\0';
-            }
-            break;
-        }
+    return NULL;
+}
+
+/**
+ * @brief record a dictionary match of method m (index idx), and remove it when it's finished
+ * @note  a precise method matches only one key. a vague method of binary dictionary is kept until
+ *        the scan ends by the bounds of top-k search, so a heavy word is found whatever keys are
+ *        before it. json dictionary has no bound, its vague method ends after ZH_WORD_VAGE_SEARCH_DEPTH keys.
+ */
+static void mlist_match_done(zh_decoder_t* dec, __split_method_list_t* m_list, __split_method_t* m, uint8_t idx) {
+    m->cm_num++;
+#if (USE_ZH_WORD_DICT_BIN == 1)
+    if (mnode_prec(m)) {
+#else
+    if (mnode_prec(m) || m->cm_num >= ZH_WORD_VAGE_SEARCH_DEPTH) {
+#endif
+        mlist_remove(dec, m_list, idx);
     }
-    if (pend == pstart) return NULL;   /* can't get reasonable parse location */
-    cJSON* item = cJSON_Parse(pstart);
-    memcpy(pend, conn, 2);
-    if (bytes_left) *bytes_left = ZH_WORD_DICT_BUFFER_SZ - (pend - (uint8_t*)buf);  /* size left in current buffer */
-    return item;
 }
 
-/* auxiliary function for exit */
-static __word_block_t* word_dict_exit(char** res_str) {
-    zh_buffer_free(*res_str);
-    res_str = NULL;
-    return NULL;
+/* word a ranks lower than word b */
+static uint8_t topk_lower(const __word_topk_item_t* a, const __word_topk_item_t* b) {
+#if (USE_ZH_WORD_ABBR == 1)
+    if (a->abbr != b->abbr) return a->abbr > b->abbr;
+#endif
+    return a->wt < b->wt || (a->wt == b->wt && a->seq > b->seq);
 }
 
 /**
-* @brief reshape the word block according to search type
-* @param w_res   the word block to be modified  
-* @param search_state  refer to @defgroup word_search_state
-* @return the modified w_res pointer
-*/
-static __word_block_t* wordblock_reshape(__word_block_t* w_res, uint8_t search_state) {
-    if (!w_res) return NULL;
-    if (search_state == WORD_SEARCH_STATE_CODE_PREC_MATCH && w_res->num.code_nbr > ZH_WORD_CODE_DISP_NUM) {
-        /* when it not reach, do nothing */
-        __word_block_t* w3 = wordblock_init(WORD_BLK_TYPE_CODES);
-        if (w3 == NULL) return NULL;
-
-        uint16_t buf1_sz = 3 * ZH_WORD_CODE_DISP_NUM;
-        uint16_t buf2_sz = 3 * (w_res->num.code_nbr - ZH_WORD_CODE_DISP_NUM);
-        uint8_t* new_buf1 = zh_buffer_malloc(buf1_sz + 1);
-        uint8_t* new_buf2 = zh_buffer_malloc(buf2_sz + 1);
-        if (!new_buf1 || !new_buf2)
-        {
-            if (new_buf1) zh_buffer_free(new_buf1);
-            if (new_buf2) zh_buffer_free(new_buf2);
-            return NULL;
+ * @brief give a found word (len characters) to top-k search, it's kept if it's one of the
+ *        heaviest MAX_WORD_BLK_WORD_NUM words found
+ */
+static void topk_push(__word_topk_t* tk, uint8_t wt, const char* text, uint8_t len) {
+    __word_topk_item_t x = { .wt = wt, .len = len, .seq = tk->seq++ };   /* text and the other fields are zeroed */
+#if (USE_ZH_WORD_ABBR == 1)
+    x.abbr = tk->abbr;
+#endif
+    uint8_t i;
+    if (tk->num < MAX_WORD_BLK_WORD_NUM) {
+        for (i = tk->num++; i > 0 && topk_lower(&x, &tk->item[(i - 1) / 2]); i = (i - 1) / 2) {
+            tk->item[i] = tk->item[(i - 1) / 2];
         }
-        else
-        {
-            memcpy(new_buf1, w_res->buf, buf1_sz); new_buf1[buf1_sz] = '\0';
-            memcpy(new_buf2, w_res->buf + 3 * ZH_WORD_CODE_DISP_NUM, buf2_sz); new_buf2[buf2_sz] = '\0';
-            w3->buf = new_buf2;
-            w3->num.code_nbr = w_res->num.code_nbr - ZH_WORD_CODE_DISP_NUM;
-            zh_buffer_free(w_res->buf);
-            w_res->buf = new_buf1;
-            w_res->num.code_nbr = ZH_WORD_CODE_DISP_NUM;
-            wordblock_append(&w_res, w3);
+    }
+    else {
+        if (!topk_lower(&tk->item[0], &x)) return;
+        /* replace the lowest ranked word */
+        for (i = 0; 2 * i + 1 < tk->num; ) {
+            uint8_t c = 2 * i + 1;
+            if (c + 1 < tk->num && topk_lower(&tk->item[c + 1], &tk->item[c])) c++;
+            if (!topk_lower(&tk->item[c], &x)) break;
+            tk->item[i] = tk->item[c];
+            i = c;
         }
     }
-    else { 
-        // no match or vague match
-        /* reshape the search code after the word result */
-        __word_block_t* tmp = w_res;
-        if (w_res->next!=NULL) {
-            w_res = w_res->next;
-            tmp->next = NULL;
-            w_res->next = tmp;
+    tk->item[i] = x;
+    memcpy(tk->item[i].text, text, 3 * len);
+}
+
+/* word a is output after word b (learned count first, then weight and order) */
+static uint8_t topk_rank_lower(const __word_topk_item_t* a, const __word_topk_item_t* b) {
+#if (USE_ZH_LEARN == 1)
+    if (a->lc != b->lc) return a->lc < b->lc;
+#endif
+    return topk_lower(a, b);
+}
+
+/* write the kept words to res_str (heaviest first) and their character number to word_nbr, return number of words */
+static uint8_t topk_flush(__word_topk_t* tk, char* res_str, uint8_t* word_nbr) {
+    for (uint8_t i = 1; i < tk->num; i++) {
+        __word_topk_item_t x = tk->item[i];
+        uint8_t j = i;
+        for (; j > 0 && topk_rank_lower(&tk->item[j - 1], &x); j--) tk->item[j] = tk->item[j - 1];
+        tk->item[j] = x;
+    }
+    uint16_t ptr = 0;
+    for (uint8_t i = 0; i < tk->num; i++) {
+        memcpy(res_str + ptr, tk->item[i].text, 3 * tk->item[i].len);
+        ptr += 3 * tk->item[i].len;
+        word_nbr[i] = tk->item[i].len;
+    }
+    res_str[ptr] = '\0';
+    return tk->num;
+}
+
+#if (USE_ZH_WORD_DICT_BIN == 1)
+
+/* give the words of record with m->length characters to top-k search (words deleted or replaced by user dictionary are dropped) */
+static void word_dict_copy(const uint8_t* rec, const __split_method_t* m, __word_topk_t* tk) {
+    const uint8_t* w = ZH_WORD_REC_WORDS(rec);
+#if (USE_ZH_USER_DICT == 1)
+    ZH_USER_DICT_LOCK();    /* record is already read, the lock is not held across reads of storage */
+    uint8_t user = (zh_user_dict_num() > 0);
+#endif
+    for (uint8_t j = 0; j < ZH_WORD_REC_WORD_NUM(rec); j++, w += ZH_WORD_W_SIZE(w)) {
+        if (ZH_WORD_W_LEN(w) != 3 * m->length) continue;
+        uint8_t wt = ZH_WORD_W_WEIGHT(w);
+#if (USE_ZH_USER_DICT == 1)
+        if (user && zh_user_dict_filter((const char*)ZH_WORD_REC_KEY(rec), ZH_WORD_REC_KEY_LEN(rec),
+            (const char*)ZH_WORD_W_TEXT(w), ZH_WORD_W_LEN(w), &wt)) {
+            continue;
         }
+#endif
+        topk_push(tk, wt, ZH_WORD_W_TEXT(w), m->length);
     }
-    return w_res;
+#if (USE_ZH_USER_DICT == 1)
+    ZH_USER_DICT_UNLOCK();
+#endif
+}
+
+/* max weight of the words of key (max weight of dictionary if bounds are not loaded) */
+static uint32_t word_key_bound(const __word_dict_info_t* info, uint32_t key) {
+#if (USE_ZH_WORD_BOUND == 1)
+    if (word_bound != NULL && key < word_bound_num) return word_bound[key];
+#else
+    (void)key;
+#endif
+    return info->max_weight;
 }
 
 /**
- * @brief search the split method in word dictionary and store the result in res_str 
- * @param str       input string
- * @param m_list    split method list
- * @note            MAX_WORD_BLK_WORD_NUM is assumed to be maximum word results, and 
- *                  MAX_CODE_SEARCH_TYPES is assumed to be maximum code search types 
- * @return pointer of resulted word block 
- * @note : after filtering buffer, there may be at most 1 split method of single code. 
- *       in this case, no matter the signal(corresponding bit of wt) is vague or precise, we would use vague search for result
- *       whether signal is precise determines whether we split the block into 2 parts for better search.
+ * @brief check if the words found later with weight <= bound can't be kept, since they 
+ *        rank lower than all kept words (the earlier word wins the same weight)
+ * @param bound max weight of the words in dictionary, the weight boosted by user dictionary is added
  */
-static __word_block_t* word_dict_search(const char* str, __split_method_list_t* m_list){
-    uint16_t read_buf_num = 0;   /* number of buffers readed */
-    uint8_t  search_state = WORD_SEARCH_STATE_CODE_NO_MATCH;
+static uint8_t topk_closed(const __word_topk_t* tk, uint32_t bound) {
+#if (USE_ZH_WORD_ABBR == 1)
+    if (tk->num == MAX_WORD_BLK_WORD_NUM && tk->item[0].abbr) return 0;  /* any word of full syllables ranks higher */
+#endif
+#if (USE_ZH_USER_DICT == 1)
+    bound += tk->boost;
+#endif
+    return tk->num == MAX_WORD_BLK_WORD_NUM && bound <= tk->item[0].wt;
+}
+
+#if (USE_ZH_WORD_TRIE == 1)
+
+/**
+ * @brief find the keys of split methods by resident trie, then read only the matched records
+ * @note  keys are processed in increasing order, and each key is given to the first method 
+ *        matches it, same as the prefix scan. the keys of each method are walked one by one,
+ *        so the scan ends only by the bounds of top-k search (or when no key is left). the record
+ *        of a key is not read (and the method is not counted) when its bound can't give a word
+ *        heavier than the kept ones, same as the abbreviation scan.
+ */
+static void word_dict_trie_scan(zh_decoder_t* dec, zh_storage_t* st, const __word_dict_info_t* info, const char* str, __split_method_list_t* m_list, __word_topk_t* tk) {
+    __split_method_t* mt[ZH_PINYIN_MAX_FILTER_TYPES];
+    __word_trie_iter_t it[ZH_PINYIN_MAX_FILTER_TYPES];
+    uint32_t next[ZH_PINYIN_MAX_FILTER_TYPES];  /* next key of each method (UINT32_MAX : no more key) */
+    uint8_t  mt_num = 0;
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next, mt_num++) {
+        mt[mt_num] = m;
+        if (zh_word_trie_iter_init(&word_trie, str, m, &it[mt_num]) ||
+            zh_word_trie_next(&word_trie, &it[mt_num], &next[mt_num])) {
+            next[mt_num] = UINT32_MAX;
+        }
+    }
+
+    __word_dict_cursor_t cur = { .st = st, .info = info, .buf = dec->dict_buf, .buf_sz = ZH_WORD_DICT_BUFFER_SZ };
+    while (m_list->num > 0 && !topk_closed(tk, info->max_weight)) {
+        uint32_t key = UINT32_MAX;  /* smallest key not processed */
+        for (uint8_t j = 0; j < mt_num; j++) {
+            if (next[j] < key) key = next[j];
+        }
+        if (key == UINT32_MAX) break;
+
+        /* the first method left in list that has this key */
+        __split_method_t* m = NULL;
+        uint8_t idx = 0;
+        for (__split_method_t* p = m_list->head; p != NULL && m == NULL; p = p->next) {
+            for (uint8_t j = 0; j < mt_num; j++) {
+                if (mt[j] == p && next[j] == key) m = p;
+            }
+            if (m == NULL) idx++;
+        }
+        for (uint8_t j = 0; j < mt_num; j++) {
+            if (next[j] == key && zh_word_trie_next(&word_trie, &it[j], &next[j])) next[j] = UINT32_MAX;
+        }
+        if (m == NULL || topk_closed(tk, word_key_bound(info, key))) continue;
+
+        const uint8_t* rec = zh_word_dict_record(&cur, key);
+        if (rec == NULL) break;
+        word_dict_copy(rec, m, tk);
+        mlist_match_done(dec, m_list, m, idx);
+    }
+}
+
+#endif
+
+#if (USE_ZH_WORD_ABBR == 1)
+
+/**
+ * @brief treat the single letter pieces of split methods as initials ("nhsj" -> "n* h* s* j*")
+ * @note  it's done only when the string can't split fully into syllables, so "cha" (not "ch|a*") or 
+ *        "ben" (not "be|n*") is not abbreviated. the precise flag of single letter piece is cleared, 
+ *        so "n" also matches "ni", "na" ...
+ * @param wt  weights of methods before relaxed (in list order)
+ * @return 1: some method has single letter piece (and all methods can be found in index), 0: none
+ */
+static uint8_t mlist_relax_initials(__split_method_list_t* m_list, uint8_t* wt) {
+    if (m_list->syl) return 0;
+    uint8_t found = 0;
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next) {
+        if (m->length > ZH_WORD_DICT_ABBR_MAX_LEN) return 0;
+        for (uint8_t i = 0, loc = 0; i < m->length; loc = m->spm[i++]) {
+            if (m->spm[i] - loc == 1) found = 1;
+        }
+    }
+    if (!found) return 0;
+    uint8_t j = 0;
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next) {
+        wt[j++] = m->wt;
+        for (uint8_t i = 0, loc = 0; i < m->length; loc = m->spm[i++]) {
+            if (m->spm[i] - loc == 1) m->wt &= ~(1 << (MAX_WORD_LENGTH - 1 - i));
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief find the keys of split methods by resident abbreviation index, then read only these records
+ * @note  every key a method matches has the initials of the method, so keys of the index group are 
+ *        processed in increasing order and given to the first method matches it, same as the prefix scan.
+ *        the record of a key is skipped (not given to any method) when its bound can't give a word
+ *        heavier than the kept ones. words of a key the method doesn't match before relaxed (a syllable
+ *        like "n" taken as initial) rank after the others.
+ * @param wt  weights of methods before relaxed (in list order)
+ */
+static void word_dict_abbr_scan(zh_decoder_t* dec, zh_storage_t* st, const __word_dict_info_t* info, const char* str, __split_method_list_t* m_list, const uint8_t* wt, __word_topk_t* tk) {
+    __split_method_t* mt[ZH_PINYIN_MAX_FILTER_TYPES];
+    const uint32_t* cand[ZH_PINYIN_MAX_FILTER_TYPES];
+    uint32_t cand_num[ZH_PINYIN_MAX_FILTER_TYPES], cand_ptr[ZH_PINYIN_MAX_FILTER_TYPES] = { 0 };
+    uint8_t  mt_num = 0;
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next, mt_num++) {
+        mt[mt_num] = m;
+        cand[mt_num] = zh_word_abbr_find(&word_abbr, str, m, &cand_num[mt_num]);
+    }
+
+    __word_dict_cursor_t cur = { .st = st, .info = info, .buf = dec->dict_buf, .buf_sz = ZH_WORD_DICT_BUFFER_SZ };
+    char key_str[ZH_WORD_DICT_KEY_MAX_LEN + 1];
+    while (m_list->num > 0 && !topk_closed(tk, info->max_weight)) {
+        uint32_t key = UINT32_MAX;  /* smallest key not processed */
+        for (uint8_t j = 0; j < mt_num; j++) {
+            if (cand_ptr[j] < cand_num[j] && cand[j][cand_ptr[j]] < key) key = cand[j][cand_ptr[j]];
+        }
+        if (key == UINT32_MAX) break;
+
+        uint8_t has[ZH_PINYIN_MAX_FILTER_TYPES] = { 0 };
+        for (uint8_t j = 0; j < mt_num; j++) {
+            if (cand_ptr[j] < cand_num[j] && cand[j][cand_ptr[j]] == key) {
+                has[j] = 1;
+                cand_ptr[j]++;
+            }
+        }
+        if (topk_closed(tk, word_key_bound(info, key))) continue;
+        const uint8_t* rec = zh_word_dict_record(&cur, key);
+        if (rec == NULL) break;
+        uint8_t kl = ZH_WORD_REC_KEY_LEN(rec);
+        if (kl > ZH_WORD_DICT_KEY_MAX_LEN) continue;
+        memcpy(key_str, ZH_WORD_REC_KEY(rec), kl);
+        key_str[kl] = '\0';
+
+        /* the first method left in list that has this key in its group and matches it */
+        __split_method_t* m = NULL;
+        uint8_t idx = 0, mj = 0;
+        for (__split_method_t* p = m_list->head; p != NULL && m == NULL; p = p->next) {
+            for (uint8_t j = 0; j < mt_num && m == NULL; j++) {
+                if (mt[j] == p && has[j] && str_match_key(str, p, key_str) == 0) {
+                    m = p;
+                    mj = j;
+                }
+            }
+            if (m == NULL) idx++;
+        }
+        if (m == NULL) continue;
+        __split_method_t m0 = *m;
+        m0.wt = wt[mj];
+        tk->abbr = (m0.wt != m->wt && str_match_key(str, &m0, key_str) != 0);
+        word_dict_copy(rec, m, tk);
+        tk->abbr = 0;
+        mlist_match_done(dec, m_list, m, idx);
+    }
+}
+
+#endif
+
+/**
+ * @brief get the range [lo, hi) of keys starting with str[0, len) from the range stack of cache
+ * @note  range of prefix str[0, k + 1) is searched inside the range of str[0, k), so a new 
+ *        keystroke only binary searches in the range of the prefix before it.
+ */
+static void dict_key_range(zh_storage_t* st, const __word_dict_info_t* info, __zh_match_cache_t* cache, const char* str, uint8_t len, uint32_t* lo, uint32_t* hi) {
+    for (uint8_t k = cache->range_num; k < len; k++) {
+        uint32_t l, h;
+        if (k == 0) {
+            l = info->letter_first[str[0] - 'a'];
+            h = info->letter_first[str[0] - 'a' + 1];
+        }
+        else {
+            l = cache->range[k - 1].lo;
+            h = cache->range[k - 1].hi;
+        }
+        l = zh_word_dict_lower_bound(st, info, str, k + 1, l, h);
+        h = zh_word_dict_upper_bound(st, info, str, k + 1, l, h);
+        cache->range[k] = (__zh_key_range_t){ l, h };
+    }
+    if (cache->range_num < len) cache->range_num = len;
+    *lo = cache->range[len - 1].lo;
+    *hi = cache->range[len - 1].hi;
+}
+
+/**
+ * @brief find the words of split methods in the compiled binary dictionary 
+ * @note  all the split methods must start with the first piece of str, so we binary search 
+ *        the first key with this prefix, and only read the records after it. the heaviest 
+ *        words are kept, the scan ends when no word of dictionary can be heavier than them.
+ * @param cache    key ranges of input prefixes (NULL : search from the range of first letter)
+ * @param tk       top-k search the words are given to
+ */
+static void word_dict_find(zh_decoder_t* dec, zh_storage_t* st, const char* str, __split_method_list_t* m_list, __zh_match_cache_t* cache, __word_topk_t* tk) {
+    __word_dict_info_t info;
+    if (zh_word_dict_info(st, &info)) {
+        ZH_LOG_ERROR("invalid word dictionary file");
+        return;
+    }
+#if (USE_ZH_WORD_ABBR == 1)
+    uint8_t wt[ZH_PINYIN_MAX_FILTER_TYPES];
+    if (word_abbr.keys != NULL && m_list->num <= ZH_PINYIN_MAX_FILTER_TYPES && mlist_relax_initials(m_list, wt)) {
+#if (USE_ZH_USER_DICT == 1)
+        user_word_push(str, m_list, tk);   /* user words are also found by initials */
+#endif
+        word_dict_abbr_scan(dec, st, &info, str, m_list, wt, tk);
+        return;
+    }
+#endif
+#if (USE_ZH_USER_DICT == 1)
+    user_word_push(str, m_list, tk);
+#endif
+#if (USE_ZH_WORD_TRIE == 1)
+    if (word_trie.base != NULL && m_list->num <= ZH_PINYIN_MAX_FILTER_TYPES) {
+        word_dict_trie_scan(dec, st, &info, str, m_list, tk);
+        return;
+    }
+#endif
+    uint8_t pre_len = MAX_WORD_CODE_LENGTH;  /* length of common key prefix */
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next) {
+        pre_len = __min(pre_len, m->spm[0]);
+    }
+    uint32_t lo, hi;
+    if (cache != NULL) {
+        dict_key_range(st, &info, cache, str, pre_len, &lo, &hi);
+    }
+    else {
+        lo = info.letter_first[str[0] - 'a'];
+        hi = info.letter_first[str[0] - 'a' + 1];
+        lo = zh_word_dict_lower_bound(st, &info, str, pre_len, lo, hi);
+    }
+
+    __word_dict_cursor_t cur = { .st = st, .info = &info, .buf = dec->dict_buf, .buf_sz = ZH_WORD_DICT_BUFFER_SZ };
+    if (lo >= hi || zh_word_dict_seek(&cur, lo)) return;
+
+    char key[ZH_WORD_DICT_KEY_MAX_LEN + 1];
+    while (m_list->num > 0 && !topk_closed(tk, info.max_weight) && cur.key_idx < hi) {
+        const uint8_t* rec = zh_word_dict_next(&cur);
+        uint8_t kl = rec ? ZH_WORD_REC_KEY_LEN(rec) : 0;
+        if (rec == NULL || kl < pre_len || kl > ZH_WORD_DICT_KEY_MAX_LEN ||
+            memcmp(ZH_WORD_REC_KEY(rec), str, pre_len) != 0) {
+            break;  /* no more key with the prefix */
+        }
+        memcpy(key, ZH_WORD_REC_KEY(rec), kl);
+        key[kl] = '\0';
+
+        uint8_t idx;
+        __split_method_t* m = mlist_match_key(m_list, str, key, &idx);
+        if (m == NULL) continue;
+        word_dict_copy(rec, m, tk);
+        mlist_match_done(dec, m_list, m, idx);   /* once a case match, we don't consider other case */
+    }
+}
+
+#else
+
+/**
+ * @brief find the words of split methods in the json dictionary (from the last index entry before the
+ *        first piece, or the location found by binary search on json file), entries are tokenized in
+ *        the buffer of context, without building json tree. json has no bound of weight, so the scan
+ *        ends when MAX_WORD_BLK_WORD_NUM words of dictionary are found, and they are ranked by weight
+ * @param cache    not used by json dictionary
+ * @param tk       top-k search the words are given to
+ */
+static void word_dict_find(zh_decoder_t* dec, zh_storage_t* st, const char* str, __split_method_list_t* m_list, __zh_match_cache_t* cache, __word_topk_t* tk) {
+    (void)cache;
+    uint8_t* dict_buf = dec->dict_buf;
+#if (USE_ZH_USER_DICT == 1)
+    user_word_push(str, m_list, tk);
+#endif
+    uint16_t seq = tk->seq;   /* words of dictionary are counted from here */
+
+    uint8_t pre_len = MAX_WORD_CODE_LENGTH;  /* length of common key prefix */
+    for (__split_method_t* m = m_list->head; m != NULL; m = m->next) {
+        pre_len = __min(pre_len, m->spm[0]);
+    }
+    uint32_t start;
+#if (USE_ZH_WORD_JSON_INDEX == 1)
+    if (json_index.offset != NULL) {   /* loaded at init by zh_word_json_index_load() */
+        start = zh_json_index_seek(&json_index, str, pre_len);
+    }
+    else
+#endif
+    {
+        start = zh_json_bisect(st, str, pre_len, dict_buf, ZH_JSON_BISECT_PIECE_SZ);
+    }
+    __json_reader_t rd;
+    __json_entry_t  e;
+    if (zh_json_reader_open(&rd, st, start, dict_buf, ZH_WORD_DICT_BUFFER_SZ)) return;
+
+    char key[ZH_JSON_KEY_MAX_LEN + 1];
+    char word[3 * MAX_WORD_LENGTH + 1];   /* one more byte, so a longer word never has the expected length */
+    /*  tokenize word dictionary json file */
+    while (m_list->num > 0 && tk->seq - seq < MAX_WORD_BLK_WORD_NUM && rd.read_num < ZH_WORD_MAX_BUFFER_READ) {
+        if (zh_json_next_entry(&rd, &e)) break;  /* json file end or can't parse */
+        if (e.key_len == 0 || e.key_len > ZH_JSON_KEY_MAX_LEN) continue;
+        memcpy(key, e.key, e.key_len);
+        key[e.key_len] = '\0';
+        if (strncmp(key, str, pre_len) > 0) break;  /* no more key with the prefix */
+
+        uint8_t idx;
+        __split_method_t* m = mlist_match_key(m_list, str, key, &idx);
+        if (m == NULL) continue;
+        /* the string match the json object */
+        const uint8_t* p = e.val;
+        uint8_t len = m->length * 3, wl;
+#if (USE_ZH_USER_DICT == 1)
+        ZH_USER_DICT_LOCK();    /* entry is already read, the lock is not held across reads of storage */
+        uint8_t user = (zh_user_dict_num() > 0);
+#endif
+        while (zh_json_next_string(&p, e.val + e.val_len, word, sizeof(word), &wl) == 0) {
+            uint32_t freq;
+            uint8_t wt = zh_json_next_number(&p, e.val + e.val_len, &freq) ? ZH_WORD_WEIGHT_DEFAULT : zh_word_weight(freq);
+            if (wl != len) continue;
+#if (USE_ZH_USER_DICT == 1)
+            if (user && zh_user_dict_filter(key, e.key_len, word, wl, &wt)) continue;
+#endif
+            topk_push(tk, wt, word, m->length);
+        }
+#if (USE_ZH_USER_DICT == 1)
+        ZH_USER_DICT_UNLOCK();
+#endif
+        mlist_match_done(dec, m_list, m, idx);   /* once a case match, we don't consider other case */
+    }
+}
+
+#endif
+
+#if (USE_ZH_USER_DICT == 1)
+
+/* give the user words of split methods to top-k search, they're given before dictionary words, so they win the same weight */
+static void user_word_push(const char* str, __split_method_list_t* m_list, __word_topk_t* tk) {
+    uint16_t num;
+    ZH_USER_DICT_LOCK();
+    const __user_word_t* u = zh_user_dict_words(&num);
+    for (uint16_t i = 0; i < num; i++) {
+        if (u[i].type != ZH_USER_WORD_ADD || u[i].key[0] != str[0]) continue;
+        for (__split_method_t* m = m_list->head; m != NULL; m = m->next) {
+            if (strlen(u[i].word) == 3 * (size_t)m->length && str_match_key(str, m, u[i].key) == 0) {
+                topk_push(tk, u[i].value, u[i].word, m->length);
+                break;
+            }
+        }
+    }
+    ZH_USER_DICT_UNLOCK();
+}
+
+#endif
+
+/**
+ * @brief search the heaviest words of split methods in user dictionary and word dictionary,
+ *        words committed by user are put before the others
+ * @note  the lock of user dictionary is held only while the overlay is looked up (user words, and the
+ *        words of a record already read), so edits and other contexts don't wait for reads of storage
+ * @param res_str  buffer to store the words found
+ * @param word_nbr buffer to store the character number of each word
+ * @param cache    key ranges of input prefixes (NULL : search from the range of first letter)
+ * @return number of words found
+ */
+static uint8_t word_dict_scan(zh_decoder_t* dec, zh_storage_t* st, const char* str, __split_method_list_t* m_list, char* res_str, uint8_t* word_nbr, __zh_match_cache_t* cache) {
+    __word_topk_t tk;
+    tk.num = 0;
+    tk.seq = 0;
+#if (USE_ZH_WORD_ABBR == 1)
+    tk.abbr = 0;
+#endif
+#if (USE_ZH_USER_DICT == 1)
+    ZH_USER_DICT_LOCK();
+    tk.boost = zh_user_dict_boost_max();
+    ZH_USER_DICT_UNLOCK();
+#endif
+    word_dict_find(dec, st, str, m_list, cache, &tk);
+#if (USE_ZH_LEARN == 1)
+    if (zh_learn_num() > 0) {
+        uint8_t len = (uint8_t)strlen(str);   /* a word covers the whole input */
+        for (uint8_t i = 0; i < tk.num; i++) {
+            tk.item[i].lc = zh_learn_count(str, len, tk.item[i].text, 3 * tk.item[i].len);
+        }
+    }
+#endif
+    return topk_flush(&tk, res_str, word_nbr);
+}
+
+/* auxiliary function for exit */
+static __word_block_t* word_dict_exit(zh_decoder_t* dec, char** res_str) {
+    query_free(dec, *res_str);
+    res_str = NULL;
+    return NULL;
+}
+
+/**
+ * @brief match the codes of the first piece of split methods, the single code method (if exists)
+ *        is removed from list since it's finished by code match
+ * @param res_str       buffer for codes (MAX_CODE_BUFF_SZ), codes are put in frequency order (most frequent first, 
+ *                      the codes committed by user are moved before the others)
+ * @param br            number of codes matched
+ * @param search_state  refer to @defgroup word_search_state
+ * @param cache         codes of the last first piece (NULL : always match code table)
+ * @return 0: success, 1: code match failed
+ */
+static uint8_t word_match_code(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list, char* res_str, uint8_t* br, uint8_t* search_state, __zh_match_cache_t* cache) {
+    char code_str[MAX_WORD_CODE_LENGTH + 1];
+    strncpy(code_str, str, m_list->head->spm[0]);
+    code_str[m_list->head->spm[0]] = '\0';
+    if (cache != NULL && strcmp(cache->code_key, code_str) == 0) {
+        *br = cache->code_br;
+        memcpy(res_str, cache->code_buf, 3 * (*br) + 1);
+    }
+    else {
+        if (code_match_vague(dec, code_str, res_str, MAX_CODE_SEARCH_TYPES, br)) return 1;
+
+        /* code table result is in reversed order */
+        for (int i = 0, j = (*br) - 1; i < j; i++, j--) {
+            char tmp[3];
+            memcpy(tmp, res_str + 3 * i, 3);
+            memcpy(res_str + 3 * i, res_str + 3 * j, 3);
+            memcpy(res_str + 3 * j, tmp, 3);
+        }
+        res_str[3 * (*br)] = '\0';
+        if (cache != NULL) {
+            strcpy(cache->code_key, code_str);
+            cache->code_br = *br;
+            memcpy(cache->code_buf, res_str, 3 * (*br) + 1);
+        }
+    }
+#if (USE_ZH_LEARN == 1)
+    learn_rerank_codes(code_str, res_str, *br, 0);   /* cache keeps the order of code table */
+#endif
+    if (m_list->head->length == 1) {
+        *search_state = mnode_prec(m_list->head) ? WORD_SEARCH_STATE_CODE_PREC_MATCH : WORD_SEARCH_STATE_CODE_VAGUE_MATCH;
+        mlist_remove(dec, m_list, 0);          /* delete head node */
+    }
+    else {
+        *search_state = WORD_SEARCH_STATE_CODE_NO_MATCH;
+    }
+    return 0;
+}
+
+/**
+* @brief reshape the word block according to search type
+* @param w_res   the word block to be modified  
+* @param search_state  refer to @defgroup word_search_state
+* @return the modified w_res pointer
+*/
+static __word_block_t* wordblock_reshape(zh_decoder_t* dec, __word_block_t* w_res, uint8_t search_state) {
+    if (!w_res) return NULL;
+    if (search_state == WORD_SEARCH_STATE_CODE_PREC_MATCH && w_res->num.code_nbr > ZH_WORD_CODE_DISP_NUM) {
+        /* when it not reach, do nothing */
+        __word_block_t* w3 = wordblock_init(dec, WORD_BLK_TYPE_CODES);
+        if (w3 == NULL) return NULL;
+
+        uint16_t buf1_sz = 3 * ZH_WORD_CODE_DISP_NUM;
+        uint16_t buf2_sz = 3 * (w_res->num.code_nbr - ZH_WORD_CODE_DISP_NUM);
+        uint8_t* new_buf1 = query_malloc(dec, buf1_sz + 1);
+        uint8_t* new_buf2 = query_malloc(dec, buf2_sz + 1);
+        if (!new_buf1 || !new_buf2)
+        {
+            if (new_buf1) query_free(dec, new_buf1);
+            if (new_buf2) query_free(dec, new_buf2);
+            return NULL;
+        }
+        else
+        {
+            memcpy(new_buf1, w_res->buf, buf1_sz); new_buf1[buf1_sz] = '\0';
+            memcpy(new_buf2, w_res->buf + 3 * ZH_WORD_CODE_DISP_NUM, buf2_sz); new_buf2[buf2_sz] = '\0';
+            w3->buf = new_buf2;
+            w3->num.code_nbr = w_res->num.code_nbr - ZH_WORD_CODE_DISP_NUM;
+            query_free(dec, w_res->buf);
+            w_res->buf = new_buf1;
+            w_res->num.code_nbr = ZH_WORD_CODE_DISP_NUM;
+            wordblock_append(&w_res, w3);
+        }
+    }
+    else { 
+        // no match or vague match
+        /* reshape the search code after the word result */
+        __word_block_t* tmp = w_res;
+        if (w_res->next!=NULL) {
+            w_res = w_res->next;
+            tmp->next = NULL;
+            w_res->next = tmp;
+        }
+    }
+    return w_res;
+}
+
+/**
+ * @brief search the split method in word dictionary and store the result in res_str 
+ * @param dec       decoder context
+ * @param str       input string
+ * @param m_list    split method list
+ * @note            MAX_WORD_BLK_WORD_NUM is assumed to be maximum word results, and 
+ *                  MAX_CODE_SEARCH_TYPES is assumed to be maximum code search types 
+ * @return pointer of resulted word block 
+ * @note : after filtering buffer, there may be at most 1 split method of single code. 
+ *       in this case, no matter the signal(corresponding bit of wt) is vague or precise, we would use vague search for result
+ *       whether signal is precise determines whether we split the block into 2 parts for better search.
+ */
+static __word_block_t* word_dict_search(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list){
+    uint8_t  search_state = WORD_SEARCH_STATE_CODE_NO_MATCH;
     if (m_list == NULL || m_list->head == NULL) return NULL;
     __word_block_t* w_res = NULL;
     
-    char* res_str = zh_buffer_malloc(MAX_WORD_BLK_BUFFER_SZ);
+    char* res_str = query_malloc(dec, MAX_WORD_BLK_BUFFER_SZ);
     if (!res_str) return NULL;  /* Memory allocation failed  */ 
 
     /** process single code match case */
-    char code_str[MAX_WORD_CODE_LENGTH + 1];
-    strncpy(code_str, str, m_list->head->spm[0]);
-    code_str[m_list->head->spm[0]] = '\0';
     uint8_t br = 0;
     uint8_t* buf = NULL;
-    __word_block_t* w1 = wordblock_init(WORD_BLK_TYPE_CODES);
-    uint8_t res_tmp = zh_match_code_vague(code_str, res_str, MAX_CODE_SEARCH_TYPES, &br);
-    if (res_tmp == 0) buf = zh_buffer_malloc(3 * br + 1);
-    if (w1 == NULL || res_tmp || buf == NULL) return word_dict_exit(&res_str);
+    __word_block_t* w1 = wordblock_init(dec, WORD_BLK_TYPE_CODES);
+    uint8_t res_tmp = word_match_code(dec, str, m_list, res_str, &br, &search_state, NULL);
+    if (res_tmp == 0) buf = query_malloc(dec, 3 * br + 1);
+    if (w1 == NULL || res_tmp || buf == NULL) return word_dict_exit(dec, &res_str);
+    
+    memcpy(buf, res_str, 3 * br + 1);
+    memset(res_str, 0, MAX_WORD_BLK_BUFFER_SZ);
+    w1->num.code_nbr = br;
+    w1->buf = buf;
+    wordblock_append(&w_res, w1); /* append the result to word block */
+    if (m_list->num == 0) {
+        query_free(dec, res_str);
+        return w_res;
+    };
+
+    /** process multi-code word match case */
+    zh_storage_t st_buf, *st = NULL;
+    __word_block_t* w2 = wordblock_init(dec, WORD_BLK_TYPE_WORDS);
+    uint8_t* word_nbr = query_malloc(dec, MAX_WORD_BLK_WORD_NUM + 1);
+
+    if (!w2 || !word_nbr || dict_file_open(dec, &st_buf, &st)) {
+        if (word_nbr) query_free(dec, word_nbr);
+        query_free(dec, res_str);
+        wordblock_destroy(dec, w2);
+        wordblock_destroy(dec, w_res);
+        return NULL;
+    }
+    w2->num.word_nbr = word_nbr;
+    uint8_t word_num = word_dict_scan(dec, st, str, m_list, res_str, word_nbr, NULL);
+    dict_file_close(dec, st);
+    w2->num.word_nbr[word_num] = 0;
+
+    size_t tmp = strlen(res_str);
+    if (word_num > 0 && tmp > 0) {
+        uint8_t* buf = query_malloc(dec, tmp + 1);
+        if (buf == NULL) {
+            ZH_LOG_ERROR("buffer malloc failed");
+            wordblock_destroy(dec, w2);  /* we just not append w2, but still retain w1 */ 
+        }
+        else {
+            memcpy(buf, res_str, tmp + 1);
+            w2->buf = buf;
+            wordblock_append(&w_res, w2);
+        }
+    }
+    else wordblock_destroy(dec, w2);
+
+    /* reshape the search result */
+    w_res = wordblock_reshape(dec, w_res, search_state);
     
-    for (int i = 0; i < br; i++) {
-        memcpy(buf + 3 * i, res_str + 3 * (br - 1 - i), 3); 
+    query_free(dec, res_str);
+    return w_res;
+}
+
+/**
+ * @brief fill the candidate list by filtered split method list (list->num is 0 before), m_list is freed
+ * @param cache  results kept between keystrokes (NULL if not in a session)
+ * @return 0: success, 1: nothing matched or read error
+ */
+static uint8_t cand_fill(zh_decoder_t* dec, const char* str, __split_method_list_t* m_list, __zh_cand_list_t* list, __zh_match_cache_t* cache) {
+    uint8_t br = 0, search_state, word_num = 0;
+    uint8_t word_nbr[MAX_WORD_BLK_WORD_NUM + 1];
+    if (word_match_code(dec, str, m_list, list->text, &br, &search_state, cache)) {
+        zh_pinyin_free_split_r(dec, m_list);
+        return 1;
+    }
+    zh_storage_t st_buf, *st = NULL;
+    if (m_list->num > 0 && dict_file_open(dec, &st_buf, &st) == 0) {
+        word_num = word_dict_scan(dec, st, str, m_list, list->text + 3 * br, word_nbr, cache);
+        dict_file_close(dec, st);
+    }
+    zh_pinyin_free_split_r(dec, m_list);
+
+    /* codes are shown before words only when first piece is precise and has enough codes */
+    uint8_t code_head = (search_state == WORD_SEARCH_STATE_CODE_PREC_MATCH && br > ZH_WORD_CODE_DISP_NUM) ? ZH_WORD_CODE_DISP_NUM : 0;
+    uint16_t word_off = 3 * br;
+    for (uint8_t i = 0; i < code_head; i++) {
+        list->cand[list->num++] = (__zh_cand_t){ 3 * i, 3, 1, CAND_KIND_CODE, 0 };
+    }
+    for (uint8_t i = 0; i < word_num; i++) {
+        list->cand[list->num++] = (__zh_cand_t){ word_off, 3 * word_nbr[i], word_nbr[i], CAND_KIND_WORD, 0 };
+        word_off += 3 * word_nbr[i];
+    }
+    for (uint8_t i = code_head; i < br; i++) {
+        list->cand[list->num++] = (__zh_cand_t){ 3 * i, 3, 1, CAND_KIND_CODE, 0 };
+    }
+    for (uint16_t i = 0; i < list->num; i++) {
+        list->cand[i].score = list->num - i;
+    }
+    return list->num == 0;
+}
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+/* 
+ * cached candidate list : split method | num(2) | num records | text
+ * cached word blocks    : split method | blocks, each block is type(1) | n(1) | word_nbr(n, words only) | len(2) | buf(len)
+ */
+
+/* restore candidate list of str from cache, return 0: found */
+static uint8_t cand_cache_get(zh_decoder_t* dec, const char* str, __split_method_t* sp, __zh_cand_list_t* list) {
+    result_cache_sync(dec);
+    uint16_t val_len;
+    const uint8_t* v = zh_result_cache_find(&dec->cache, ZH_RESULT_KIND_CAND, 0, str, (uint8_t)strlen(str), &val_len);
+    if (v == NULL) return 1;
+    if (sp != NULL) {
+        memcpy(sp, v, sizeof(__split_method_t));
+        sp->next = NULL;
+    }
+    v += sizeof(__split_method_t);
+    memcpy(&list->num, v, sizeof(uint16_t));
+    v += sizeof(uint16_t);
+    memcpy(list->cand, v, sizeof(__zh_cand_t) * list->num);
+    v += sizeof(__zh_cand_t) * list->num;
+    memcpy(list->text, v, val_len - sizeof(__split_method_t) - sizeof(uint16_t) - sizeof(__zh_cand_t) * list->num);
+    return 0;
+}
+
+/* keep candidate list of str in cache (text after the last candidate is not kept) */
+static void cand_cache_put(zh_decoder_t* dec, const char* str, const __split_method_t* sp, const __zh_cand_list_t* list) {
+    uint16_t text_len = 0;
+    for (uint16_t i = 0; i < list->num; i++) {
+        uint16_t end = list->cand[i].utf8_offset + list->cand[i].utf8_len;
+        if (end > text_len) text_len = end;
+    }
+    uint32_t val_len = sizeof(__split_method_t) + sizeof(uint16_t) + sizeof(__zh_cand_t) * list->num + text_len;
+    if (val_len > UINT16_MAX) return;
+    uint8_t* v = zh_result_cache_insert(&dec->cache, ZH_RESULT_KIND_CAND, 0, str, (uint8_t)strlen(str), (uint16_t)val_len);
+    if (v == NULL) return;
+    memcpy(v, sp, sizeof(__split_method_t));
+    v += sizeof(__split_method_t);
+    memcpy(v, &list->num, sizeof(uint16_t));
+    v += sizeof(uint16_t);
+    memcpy(v, list->cand, sizeof(__zh_cand_t) * list->num);
+    memcpy(v + sizeof(__zh_cand_t) * list->num, list->text, text_len);
+}
+
+/* rebuild the word blocks of str from cache (allocated as a normal result), NULL if not found */
+static __word_block_t* word_cache_get(zh_decoder_t* dec, const char* str, __split_method_t* sp) {
+    result_cache_sync(dec);
+    uint16_t val_len;
+    const uint8_t* v = zh_result_cache_find(&dec->cache, ZH_RESULT_KIND_WORD, 0, str, (uint8_t)strlen(str), &val_len);
+    if (v == NULL) return NULL;
+    const uint8_t* end = v + val_len;
+    if (sp != NULL) {
+        memcpy(sp, v, sizeof(__split_method_t));
+        sp->next = NULL;
+    }
+    v += sizeof(__split_method_t);
+
+    __word_block_t* w_res = NULL;
+    while (v < end) {
+        uint8_t type = v[0], n = v[1];
+        v += 2;
+        __word_block_t* w = wordblock_init(dec, type);
+        if (w == NULL) {
+            wordblock_destroy(dec, w_res);
+            return NULL;
+        }
+        wordblock_append(&w_res, w);
+        if (type == WORD_BLK_TYPE_WORDS) {
+            w->num.word_nbr = query_malloc(dec, n + 1);
+            if (w->num.word_nbr == NULL) {
+                wordblock_destroy(dec, w_res);
+                return NULL;
+            }
+            memcpy(w->num.word_nbr, v, n);
+            w->num.word_nbr[n] = 0;
+            v += n;
+        }
+        else {
+            w->num.code_nbr = n;
+        }
+        uint16_t len = (uint16_t)(v[0] | (v[1] << 8));
+        v += 2;
+        w->buf = query_malloc(dec, len + 1);
+        if (w->buf == NULL) {
+            wordblock_destroy(dec, w_res);
+            return NULL;
+        }
+        memcpy(w->buf, v, len);
+        w->buf[len] = '\0';
+        v += len;
+    }
+    return w_res;
+}
+
+/* keep the word blocks of str in cache */
+static void word_cache_put(zh_decoder_t* dec, const char* str, const __split_method_t* sp, const __word_block_t* w) {
+    uint32_t val_len = sizeof(__split_method_t);
+    for (const __word_block_t* p = w; p != NULL; p = p->next) {
+        uint8_t n = 0;
+        if (p->type == WORD_BLK_TYPE_WORDS) {
+            while (p->num.word_nbr[n]) n++;
+        }
+        val_len += 4 + n + strlen(p->buf);
+    }
+    if (val_len > UINT16_MAX) return;
+    uint8_t* v = zh_result_cache_insert(&dec->cache, ZH_RESULT_KIND_WORD, 0, str, (uint8_t)strlen(str), (uint16_t)val_len);
+    if (v == NULL) return;
+    memcpy(v, sp, sizeof(__split_method_t));
+    v += sizeof(__split_method_t);
+    for (const __word_block_t* p = w; p != NULL; p = p->next) {
+        uint8_t n = 0;
+        if (p->type == WORD_BLK_TYPE_WORDS) {
+            while (p->num.word_nbr[n]) n++;
+            memcpy(v + 2, p->num.word_nbr, n);
+        }
+        v[0] = p->type;
+        v[1] = p->type == WORD_BLK_TYPE_WORDS ? n : (uint8_t)p->num.code_nbr;
+        v += 2 + n;
+        uint16_t len = (uint16_t)strlen(p->buf);
+        v[0] = (uint8_t)len; v[1] = (uint8_t)(len >> 8);
+        memcpy(v + 2, p->buf, len);
+        v += 2 + len;
+    }
+}
+
+#endif
+
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+/* drop the cached results when a table is loaded, user dictionary is edited or a candidate is committed after they're matched */
+static void result_cache_sync(zh_decoder_t* dec) {
+    uint32_t gen = table_gen;   /* generations only increase, so their sum changes on any change */
+#if (USE_ZH_USER_DICT == 1)
+    gen += zh_user_dict_gen();
+#endif
+#if (USE_ZH_LEARN == 1)
+    gen += zh_learn_gen();
+#endif
+    if (dec->gen != gen) {
+        zh_result_cache_reset(&dec->cache);
+        dec->gen = gen;
+    }
+}
+
+#endif
+
+/********************************** public functions ***************************************/
+
+/**
+ * @brief       init a decoder context, code table and word dictionary files are opened 
+ *              and kept in context until zh_decoder_deinit() is called
+ * @note        each thread should own a context, contexts can decode concurrently
+ * @param       dec : context to init
+ * @retval      0: init succeed , 1: file not exist (context is still usable, files are opened on each call)
+ */
+uint8_t zh_decoder_init(zh_decoder_t* dec) {
+    if (dec == NULL) return 1;
+    uint8_t res = 0;
+#if (USE_ZH_QUERY_ARENA == 1)
+    dec->arena.used = 0;
+    dec->arena.last = 0;
+    dec->arena.peak = 0;
+    dec->arena.refs = 0;
+#endif
+#if (USE_ZH_RESULT_CACHE == 1)
+    zh_result_cache_reset(&dec->cache);
+    dec->cache.hit = dec->cache.miss = dec->cache.evict = 0;
+#endif
+#if (USE_ZH_RESULT_CACHE == 1)
+    dec->gen = 0;   /* synced at the first cache lookup */
+#endif
+    if (zh_storage_open(&dec->code_st, ZH_CODE_TABLE_FILE_NAME)) {
+        ZH_LOG_WARNING("code table file \"zh pinyin.bin\" not exist");
+        res = 1;
+    }
+#if (USE_ZH_WORD_MATCH == 1)
+    if (zh_storage_open(&dec->dict_st, WORD_DICT_FILE_NAME)) {
+        ZH_LOG_WARNING("Word Dictionary file not exist");
+        res = 1;
+    }
+#endif
+    return res;
+}
+
+/**
+ * @brief       close the files kept by decoder context
+ */
+void zh_decoder_deinit(zh_decoder_t* dec) {
+    if (dec == NULL) return;
+    zh_storage_close(&dec->code_st);
+#if (USE_ZH_WORD_MATCH == 1)
+    zh_storage_close(&dec->dict_st);
+#endif
+}
+
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+
+/**
+ * @brief       load the whole code table file into RAM, so that code match functions 
+ *              read from memory instead of opening and seeking the file every call
+ * @note        call it once at init, zh_code_table_unload() to release the buffer
+ * @retval      0: load succeed (or already loaded) , 1: file not exist or malloc failed
+ */
+uint8_t zh_code_table_load(void) {
+    if (code_table_data != NULL) return 0;
+    uint8_t* data;
+    uint32_t sz;
+    if (zh_storage_load(ZH_CODE_TABLE_FILE_NAME, &data, &sz)) {
+        ZH_LOG_ERROR("load code table file \"zh pinyin.bin\" failed");
+        return 1;
     }
-    buf[3 * br] = '\0';
-    w1->num.code_nbr = br;
-    w1->buf = buf;
-    wordblock_append(&w_res, w1); /* append the result to word block */
-    if (m_list->head->length == 1) {
-        search_state = mnode_prec(m_list->head) ? WORD_SEARCH_STATE_CODE_PREC_MATCH : WORD_SEARCH_STATE_CODE_VAGUE_MATCH;
-        memset(res_str, 0, MAX_WORD_BLK_BUFFER_SZ);
-        mlist_remove(m_list, 0);          /* delete head node */
+    code_table_size = sz;
+    code_table_data = data;
+    table_gen++;
+    return 0;
+}
+
+/**
+ * @brief       release the resident code table, code match functions fall back to file reading
+ */
+void zh_code_table_unload(void) {
+    if (code_table_data == NULL) return;
+    zh_buffer_free(code_table_data);
+    code_table_data = NULL;
+    code_table_size = 0;
+    table_gen++;
+}
+
+#endif
+
+#if (USE_ZH_WORD_TRIE == 1)
+
+/**
+ * @brief       load the syllable table and key trie of binary dictionary into RAM, 
+ *              then word match only reads the records of matched keys
+ * @note        call it once at init, zh_word_trie_unload() to release the buffer
+ * @retval      0: load succeed (or already loaded) , 1: file not exist or malloc failed
+ */
+uint8_t zh_word_trie_load(void) {
+    if (word_trie.base != NULL) return 0;
+    zh_storage_t st;
+    if (zh_storage_open(&st, ZH_WORD_DICT_BIN_FILE_NAME)) {
+        ZH_LOG_ERROR("word dictionary file \"zh_word_dict.bin\" not exist");
+        return 1;
     }
-    else {
-        search_state = WORD_SEARCH_STATE_CODE_NO_MATCH;
+    __word_dict_info_t info;
+    uint8_t res = zh_word_dict_info(&st, &info) || zh_word_trie_read(&st, &info, &word_trie);
+    zh_storage_close(&st);
+    if (res) ZH_LOG_ERROR("load word trie failed");
+    else table_gen++;
+    return res;
+}
+
+/**
+ * @brief       release the resident key trie, word match falls back to prefix scan
+ */
+void zh_word_trie_unload(void) {
+    if (word_trie.base == NULL) return;
+    zh_word_trie_free(&word_trie);
+    table_gen++;
+}
+
+#endif
+
+#if (USE_ZH_WORD_ABBR == 1)
+
+/**
+ * @brief       load the abbreviation index of binary dictionary into RAM, then single letters in
+ *              input are taken as initials of syllables ("nhsj" -> "ni hao shi jie"), and the keys 
+ *              of these inputs are found by one index probe for each split method
+ * @note        call it once at init, zh_word_abbr_unload() to release the buffer
+ * @retval      0: load succeed (or already loaded) , 1: file not exist or malloc failed
+ */
+uint8_t zh_word_abbr_load(void) {
+    if (word_abbr.keys != NULL) return 0;
+    zh_storage_t st;
+    if (zh_storage_open(&st, ZH_WORD_DICT_BIN_FILE_NAME)) {
+        ZH_LOG_ERROR("word dictionary file \"zh_word_dict.bin\" not exist");
+        return 1;
     }
-    if (m_list->num == 0) {
-        zh_buffer_free(*res_str);
-        return w_res;
-    };
+    __word_dict_info_t info;
+    uint8_t res = zh_word_dict_info(&st, &info) || zh_word_abbr_read(&st, &info, &word_abbr);
+    zh_storage_close(&st);
+    if (res) ZH_LOG_ERROR("load abbreviation index failed");
+    else table_gen++;
+    return res;
+}
 
-    /** process multi-code word match case */
-    FILE* fp = fopen(ZH_WORD_DICTIONARY_FILE_NAME, "r");
-    __word_block_t* w2 = wordblock_init(WORD_BLK_TYPE_WORDS);
-    uint8_t* word_nbr = zh_buffer_malloc(MAX_WORD_BLK_WORD_NUM + 1);
-    word_nbr[0] = 0;
-
-    if (!fp || !w2 || !word_nbr) {
-        ZH_LOG_WARNING("Word Dictionary file \"zh_word_dict.json\" not exist");
-        zh_buffer_free(res_str);
-        wordblock_destroy(w2);
-        wordblock_destroy(w_res);
-        return NULL;
+/**
+ * @brief       release the resident abbreviation index, single letters are matched as syllables again
+ */
+void zh_word_abbr_unload(void) {
+    if (word_abbr.keys == NULL) return;
+    zh_word_abbr_free(&word_abbr);
+    table_gen++;
+}
+
+#endif
+
+#if (USE_ZH_WORD_BOUND == 1)
+
+/**
+ * @brief       load the max word weight of each key of binary dictionary into RAM, then trie and 
+ *              abbreviation search don't read the records that can't give heavier words than 
+ *              the words found (without it, only the max weight of dictionary is known)
+ * @note        call it once at init, zh_word_bound_unload() to release the buffer
+ * @retval      0: load succeed (or already loaded) , 1: file not exist or malloc failed
+ */
+uint8_t zh_word_bound_load(void) {
+    if (word_bound != NULL) return 0;
+    zh_storage_t st;
+    if (zh_storage_open(&st, ZH_WORD_DICT_BIN_FILE_NAME)) {
+        ZH_LOG_ERROR("word dictionary file \"zh_word_dict.bin\" not exist");
+        return 1;
     }
-    w2->num.word_nbr = word_nbr;
-    fseek(fp, word_dict_offset[str[0] - 'a'], SEEK_SET);
+    __word_dict_info_t info;
+    uint8_t* bound = NULL;
+    uint8_t res = zh_word_dict_info(&st, &info) || info.key_num == 0 || (bound = zh_buffer_malloc(info.key_num)) == NULL ||
+                  zh_storage_read_at(&st, info.bound_off, bound, info.key_num) != info.key_num;
+    zh_storage_close(&st);
+    if (res) {
+        if (bound) zh_buffer_free(bound);
+        ZH_LOG_ERROR("load word weight bounds failed");
+        return 1;
+    }
+    word_bound = bound;
+    word_bound_num = info.key_num;
+    table_gen++;
+    return 0;
+}
 
-    uint8_t  word_buff_idx = 0;    /* index of word_nbr */
-    uint8_t  word_buff_ptr = 0;    /* location pointer  */
-    if (fread(word_dict_buffer, sizeof(uint8_t), sizeof(word_dict_buffer), fp) == 0) {
-        zh_buffer_free(*res_str);
-        return w_res;
+/**
+ * @brief       release the resident weight bounds, word search reads every record of candidate keys
+ */
+void zh_word_bound_unload(void) {
+    if (word_bound == NULL) return;
+    zh_buffer_free(word_bound);
+    word_bound = NULL;
+    word_bound_num = 0;
+    table_gen++;
+}
+
+#endif
+
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+
+/**
+ * @brief       load the sparse key offset index of json dictionary, from the sidecar file if it's 
+ *              built from current json file (same size and modify time), otherwise scan the json 
+ *              file to build it and save the sidecar file (not saved when the json file is not
+ *              on file system, e.g. a blob of RAM storage)
+ * @note        call it at init (before contexts are used), like the other resident tables. word match
+ *              doesn't load it, it finds the location by binary search on json file when the index 
+ *              is not loaded (or failed to load). zh_word_json_index_unload() releases it
+ * @retval      0: load succeed (or already loaded) , 1: json file not exist or malloc failed
+ */
+uint8_t zh_word_json_index_load(void) {
+    if (json_index.offset != NULL) return 0;
+    zh_storage_t json;
+    if (zh_storage_open(&json, ZH_WORD_DICTIONARY_FILE_NAME)) {
+        ZH_LOG_ERROR("word dictionary file \"zh_word_dict.json\" not exist");
+        return 1;
     }
-    /*  parse word dictionary json file */
-    while (m_list->num > 0 && read_buf_num < ZH_WORD_MAX_BUFFER_READ) {
-        /* Parse JSON object and do search operation */
-        uint32_t bytes_left = 0;
-        cJSON *item = cjson_parse_piece(word_dict_buffer, &bytes_left);
-        if (item == NULL || item->child == NULL || item->child->string[0] > str[0]) {
-            break;  /* json file end or can't parse */
-        }
-        for (cJSON* js = item->child; js != NULL; js = js->next) {
-            __split_method_t* m = m_list->head;
-            for (int i = 0; i < m_list->num; i++) {
-                if (str_match_cjson(str, m, js)) {
-                    m = m->next;
-                    continue;
-                }
-                /* the string match the json object */
-                uint8_t sz = cJSON_GetArraySize(js);
-                for (int j = 0; j < sz; j++) {
-                    char* m_str = cJSON_GetArrayItem(js, j)->valuestring;
-                    uint8_t len = m->length * 3;
-                    memcpy(res_str + word_buff_ptr, m_str, len);
-                    res_str[word_buff_ptr + len] = '\0';
-                    w2->num.word_nbr[word_buff_idx] = m->length;
-                    word_buff_ptr += len;
-                    word_buff_idx ++;
-                    if (word_buff_idx == MAX_WORD_BLK_WORD_NUM) break;
-                }
-                m->cm_num++;
-                if (mnode_prec(m) || m->cm_num >= ZH_WORD_VAGE_SEARCH_DEPTH)
-                {
-                    mlist_remove(m_list, i);
-                }
-                break;    /* once a case match, we don't consider other case */
-            }
-            if (word_buff_idx >= MAX_WORD_BLK_WORD_NUM) break;
+    struct stat st;
+    uint8_t on_disk = (stat(ZH_WORD_DICTIONARY_FILE_NAME, &st) == 0 && (uint32_t)st.st_size == json.size);
+    FILE* fp = on_disk ? fopen(ZH_WORD_DICT_INDEX_FILE_NAME, "rb") : NULL;
+    if (fp != NULL) {
+        uint8_t res = zh_json_index_read(fp, json.size, (int64_t)st.st_mtime, &json_index);
+        fclose(fp);
+        if (res == 0) {
+            zh_storage_close(&json);
+            return 0;
         }
-        cJSON_Delete(item);
-        /** re-read file and concanate the buffer */
-        memmove(word_dict_buffer, word_dict_buffer + ZH_WORD_DICT_BUFFER_SZ - bytes_left, bytes_left);
-        word_dict_buffer[0] = '{';
-        if (feof(fp)) break;
-        fread(word_dict_buffer + bytes_left, sizeof(uint8_t), ZH_WORD_DICT_BUFFER_SZ - bytes_left, fp);
-        read_buf_num++;
     }
-    w2->num.word_nbr[word_buff_idx] = 0;
+    /* sidecar file not exist or out of date, rebuild it */
+    uint8_t res = zh_json_index_build(&json, &json_index);
+    zh_storage_close(&json);
+    if (res) {
+        ZH_LOG_ERROR("build json dictionary index failed");
+        return 1;
+    }
+    if (!on_disk) return 0;
+    fp = fopen(ZH_WORD_DICT_INDEX_FILE_NAME, "wb");
+    if (fp == NULL || zh_json_index_write(fp, json.size, (int64_t)st.st_mtime, &json_index)) {
+        ZH_LOG_WARNING("save json dictionary index failed");  /* still usable in RAM */
+    }
+    if (fp) fclose(fp);
+    return 0;
+}
 
-    size_t tmp = strlen(res_str);
-    if (tmp > 0) {
-        uint8_t* buf = zh_buffer_malloc(tmp + 1);
-        if (buf == NULL) {
-            ZH_LOG_ERROR("buffer malloc failed");
-            wordblock_destroy(w2);  /* we just not append w2, but still retain w1 */ 
-        }
-        else {
-            memcpy(buf, res_str, tmp + 1);
-            w2->buf = buf;
-            wordblock_append(&w_res, w2);
-        }
+/**
+ * @brief       release the json dictionary index, word match finds the location by binary search after it
+ */
+void zh_word_json_index_unload(void) {
+    zh_json_index_free(&json_index);
+}
+
+#endif
+
+#if (USE_ZH_VAGUE_TABLE == 1)
+
+/**
+ * @brief       load the precomputed vague match table into RAM, then zh_match_code_vague of
+ *              a syllable prefix is one hash lookup and one copy, without reading code table
+ * @note        call it once at init, zh_vague_table_unload() to release the buffer
+ * @retval      0: load succeed (or already loaded) , 1: file not exist, invalid or malloc failed
+ */
+uint8_t zh_vague_table_load(void) {
+    if (vague_table.slots != NULL) return 0;
+    uint8_t* file;
+    uint32_t sz;
+    if (zh_storage_load(ZH_VAGUE_TABLE_FILE_NAME, &file, &sz)) {
+        ZH_LOG_ERROR("vague table file \"zh_vague.bin\" not exist");
+        return 1;
     }
-    else wordblock_destroy(w2);
+    uint8_t res = zh_vague_table_read(file, sz, &vague_table);
+    zh_buffer_free(file);
+    if (res) ZH_LOG_ERROR("load vague table failed");
+    else table_gen++;
+    return res;
+}
 
-    /* reshape the search result */
-    w_res = wordblock_reshape(w_res, search_state);
-    
-    zh_buffer_free(res_str);
-    return w_res;
+/**
+ * @brief       release the vague match table, vague match falls back to code table reading
+ */
+void zh_vague_table_unload(void) {
+    if (vague_table.slots == NULL) return;
+    zh_vague_table_free(&vague_table);
+    table_gen++;
 }
 
 #endif
 
-/********************************** public functions ***************************************/
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+
+/**
+ * @brief       load the 16-bit character id code table into RAM (2/3 size of resident utf-8 
+ *              code table), code match functions emit utf-8 from ids instead of reading file
+ * @note        call it once at init, zh_char_id_unload() to release the buffer. 
+ *              it takes precedence over zh_code_table_load() when both are loaded
+ * @retval      0: load succeed (or already loaded) , 1: file not exist, invalid or malloc failed
+ */
+uint8_t zh_char_id_load(void) {
+    if (char_id_table.ids != NULL) return 0;
+    uint8_t* file;
+    uint32_t sz;
+    if (zh_storage_load(ZH_CHAR_ID_FILE_NAME, &file, &sz)) {
+        ZH_LOG_ERROR("character id table file \"zh_pinyin_id.bin\" not exist");
+        return 1;
+    }
+    uint8_t res = zh_char_id_read(file, sz, &char_id_table);
+    zh_buffer_free(file);
+    if (res) ZH_LOG_ERROR("load character id table failed");
+    else table_gen++;
+    return res;
+}
+
+/**
+ * @brief       release the character id table, code match functions fall back to utf-8 code table
+ */
+void zh_char_id_unload(void) {
+    if (char_id_table.ids == NULL) return;
+    zh_char_id_free(&char_id_table);
+    table_gen++;
+}
+
+#endif
 
 /**
  * @brief       Match the utf-8 code in PinYin table precisely 
+ * @param       dec : decoder context
  * @param       str : string to match
  * @param       res_str : result string (must pre-malloc size at least 3 * num bytes + 1(MAX_CODE_BUFF_SZ is recommended)
  * @param       num : number of zh Character to read (set to ZH_VAGUE_MAX_LENGTH if want all)
  * @param       br : number of zh Character readed
  * @retval      0: match succeed , 1: read error or nothing to match
  */
-uint8_t zh_match_code_prec(const char* str, char* res_str, uint8_t num, uint8_t* br){
-    if (res_str == NULL || chk_valid_string(str)) return 1;
-    FILE* fp = fopen(ZH_CODE_TABLE_FILE_NAME, "rb");
-    if (fp == NULL) {
-        ZH_LOG_ERROR("code table file \"zh pinyin.bin\" not exist");
-        return 1;
-    }
+uint8_t zh_match_code_prec_r(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br){
+    if (dec == NULL || res_str == NULL || chk_valid_string(str)) return 1;
     int8_t  match_idx = -1;
     uint8_t v_br = 0;
 
-    if (get_match_idx(str, &match_idx, 0, NULL, &v_br) || match_idx < 0) {
-        fclose(fp);
-        return 1;
-    }
+    if (get_match_idx(str, &match_idx, 0, NULL, &v_br) || match_idx < 0) return 1;
+    zh_storage_t st_buf, *st = NULL;
+    if (code_table_open(dec, &st_buf, &st)) return 1;
     uint8_t idx = str[0] - 'a';
     const __code_index_t* codex = (&code_index[idx]);
     
     uint8_t br_read = codex->code_table_num[match_idx] > num ? num :codex->code_table_num[match_idx];
-    size_t read_loc = codex->char_start + codex->code_offset[match_idx] + (codex->code_table_num[match_idx] - br_read) * 3;
-    uint16_t read_length = 3 * br_read;
     
-    fseek(fp, read_loc, SEEK_SET);
-    fread(res_str, sizeof(uint8_t), read_length ,fp);
-    res_str[read_length] = '\0';
+    uint8_t res = code_table_get(st, idx, match_idx, codex->code_table_num[match_idx] - br_read, br_read, res_str);
+    res_str[3 * br_read] = '\0';
     if (br != NULL) (*br) = br_read;
-    fclose(fp);
-    return 0;
+    code_table_close(dec, st);
+    return res;
 }
 
-/**
- * @brief       vague match for the input pinyin code
- * @param       str : string to match
- * @param       res_str : result string (must pre-malloc size at least 3 * num bytes + 1(MAX_CODE_BUFF_SZ is recommended)
- * @param       num : number of zh Character to read (set to ZH_VAGUE_MAX_LENGTH if want all)
- * @param       br : number of zh Character readed
- * @return      0: match succeed , 1: read error or nothing to match
- * @bug         when str starts with '0' may cause fault 
- */
-uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t* br) {
-    if (res_str == NULL || chk_valid_string(str)) return 1;
+/* vague match in the order of code table (the most frequent is the last), refer to zh_match_code_vague_r */
+static uint8_t code_match_vague(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br) {
+    if (dec == NULL || res_str == NULL || chk_valid_string(str)) return 1;
+#if (USE_ZH_VAGUE_TABLE == 1)
+    const __vague_entry_t* e = zh_vague_table_find(&vague_table, str);
+    if (e != NULL) {
+        /* the result of num characters is the tail of whole result */
+        uint8_t n = __min(num, e->count);
+        memcpy(res_str, vague_table.data + e->offset + 3 * (e->count - n), 3 * (size_t)n);
+        res_str[3 * n] = '\0';
+        if (br != NULL) (*br) = n;
+        return 0;
+    }
+#endif
+#if (USE_ZH_RESULT_CACHE == 1)
+    result_cache_sync(dec);
+    uint16_t val_len;
+    const uint8_t* val = zh_result_cache_find(&dec->cache, ZH_RESULT_KIND_VAGUE, num, str, (uint8_t)strlen(str), &val_len);
+    if (val != NULL) {
+        memcpy(res_str, val, val_len);
+        res_str[val_len] = '\0';
+        if (br != NULL) (*br) = (uint8_t)(val_len / 3);
+        return 0;
+    }
+#endif
     int8_t mid = 0;
-    uint8_t* v_idx = zh_buffer_malloc(num);
+    uint8_t* v_idx = query_malloc(dec, num);
     if (v_idx == NULL) {
         ZH_LOG_ERROR("storge full, allocate buffer failed");
         return 1;
     }
     uint8_t  v_br = 0;
-    if (get_match_idx(str, &mid, num, v_idx, &v_br)) return 1;
-    FILE* fp = fopen(ZH_CODE_TABLE_FILE_NAME, "rb");
-    if (!fp) {
-        zh_buffer_free(v_idx);
-        ZH_LOG_ERROR("code table file \"zh pinyin.bin\" not exist");
+    zh_storage_t st_buf, *st = NULL;
+    if (get_match_idx(str, &mid, num, v_idx, &v_br) || code_table_open(dec, &st_buf, &st)) {
+        query_free(dec, v_idx);
         return 1;
     }
     uint8_t idx = str[0] - 'a';
@@ -767,9 +2063,7 @@ uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t
         match_num = __min(match_num, ZH_VAGUE_MATCH_HEAD_DEPTH);
         chars_left -= match_num; br_read += match_num;
         
-        size_t read_loc = codex->char_start + codex->code_offset[mid] + 3 * (codex->code_table_num[mid] - match_num);
-        fseek(fp, read_loc, SEEK_SET);
-        fread(res_str + (size_t)chars_left * 3, sizeof(uint8_t), (size_t)match_num * 3, fp);
+        code_table_get(st, idx, mid, codex->code_table_num[mid] - match_num, match_num, res_str + (size_t)chars_left * 3);
     }
 
     if (chars_left > 0 && v_br > 0) {
@@ -784,10 +2078,7 @@ uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t
             match_num = __min(match_num, match_depth);
             chars_left -= match_num; br_read += match_num;
             
-            uint32_t read_loc = codex->char_start + codex->code_offset[index] + 3 * (codex->code_table_num[index] - match_num);
-            uint16_t read_length = 3 * (match_num);
-            fseek(fp, (long)read_loc, SEEK_SET);
-            fread(res_str + 3 * chars_left, sizeof(uint8_t), read_length, fp);
+            code_table_get(st, idx, index, codex->code_table_num[index] - match_num, match_num, res_str + 3 * chars_left);
         }
     }
 
@@ -796,43 +2087,67 @@ uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t
         uint8_t match_num = __min(codex->code_table_num[mid] - ZH_VAGUE_MATCH_HEAD_DEPTH, chars_left);
         chars_left -= match_num; br_read += match_num;
         
-        uint32_t read_loc = codex->char_start + codex->code_offset[mid] + 3 * (codex->code_table_num[mid] - ZH_VAGUE_MATCH_HEAD_DEPTH - match_num);
-        uint16_t read_length = 3 * (match_num);
-        fseek(fp, (long)read_loc, SEEK_SET);
-        fread(res_str + 3 * chars_left, sizeof(uint8_t), read_length, fp);
+        code_table_get(st, idx, mid, codex->code_table_num[mid] - ZH_VAGUE_MATCH_HEAD_DEPTH - match_num, match_num, res_str + 3 * chars_left);
     }
-    zh_buffer_free(v_idx);
+    query_free(dec, v_idx);
     if (br!= NULL) (*br) = br_read;
-    fclose(fp);
+    code_table_close(dec, st);
     if (chars_left > 0){
         memmove(res_str, res_str + 3 * chars_left, 3 * br_read + 1);
     }
+#if (USE_ZH_RESULT_CACHE == 1)
+    uint8_t* v = zh_result_cache_insert(&dec->cache, ZH_RESULT_KIND_VAGUE, num, str, (uint8_t)strlen(str), 3 * br_read);
+    if (v != NULL) memcpy(v, res_str, 3 * br_read);
+#endif
+    return 0;
+}
+
+/**
+ * @brief       vague match for the input pinyin code
+ * @param       dec : decoder context
+ * @param       str : string to match
+ * @param       res_str : result string (must pre-malloc size at least 3 * num bytes + 1(MAX_CODE_BUFF_SZ is recommended)
+ * @param       num : number of zh Character to read (set to ZH_VAGUE_MAX_LENGTH if want all)
+ * @param       br : number of zh Character readed
+ * @return      0: match succeed , 1: read error or nothing to match
+ * @note        the most frequent character is the last, characters committed by user (zh_commit) are moved after the others
+ * @bug         when str starts with '0' may cause fault 
+ */
+uint8_t zh_match_code_vague_r(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br) {
+    if (code_match_vague(dec, str, res_str, num, br)) return 1;
+#if (USE_ZH_LEARN == 1)
+    learn_rerank_codes(str, res_str, (uint8_t)(strlen(res_str) / 3), 1);
+#endif
     return 0;
 }
 
 /**
  * @brief get split method object in a mixed pinyin string (not filtered)
+ * @param dec decoder context
  * @param str string to get 
  * @return NULL if no match found
  */
-__split_method_list_t* zh_pinyin_get_split(const char* str) {
-    if (chk_valid_string(str)) return NULL;
-    __split_method_list_t* m_list = mlist_init();
-    if (m_list == NULL) return NULL;
-
-    g_word_match_number = 0;
-    uint8_t spm[MAX_WORD_LENGTH] = { 0, 0, 0, 0 };
-    if (pinyin_dfs(m_list, str, spm, 0, 0) || m_list->head == NULL) return NULL;
-    return m_list;
+__split_method_list_t* zh_pinyin_get_split_r(zh_decoder_t* dec, const char* str) {
+    if (dec == NULL || chk_valid_string(str)) return NULL;
+    uint8_t len = strlen(str);
+    pinyin_lattice_build(&dec->lattice, str, len);
+    return pinyin_lattice_list(dec, &dec->lattice, str, len);
 }
 
 /**
  * @brief filter the split method list (remove repeat vague split method)
- * @note  it can filter the method that have the same splitting method but different weight
+ * @note  it can filter the method that have the same splitting method but different weight,
+ *        the method kept takes the vague flag of each piece from the removed one, since a vague
+ *        piece also matches the syllable equal to it (e.g. "xi|chen" keeps vague "xi", not precise).
+ *        the kept method stays at the position of its most precise form, so after filtering the list
+ *        is ordered by length, then by that position (not by wt). word search gives a key to the first
+ *        method matches it, which only decides the method counted (and the abbreviation tier), the
+ *        same words are copied for every method of the same length.
+ * @param dec    decoder context
  * @param m_list split method list
  * @return 0: success, 1: fail
  */
-uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
+uint8_t zh_pinyin_filter_split_r(zh_decoder_t* dec, __split_method_list_t* m_list) {
     if (m_list == NULL || m_list->num == 0) return 1;
     __split_method_t* m1 = m_list->head, * m2 = m1->next;
     uint8_t num = 1;   /*  since m1 is head -> alerady 1 method */
@@ -840,6 +2155,7 @@ uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
         uint8_t rep = 0;
         for (__split_method_t* mt = m_list->head; mt != m2; mt = mt->next) {
             if (mt->length == m2->length && memcmp(mt->spm, m2->spm, mt->length - 1) == 0) {
+                if (mt->length > 1) mt->wt &= m2->wt;   /* single piece gives precise and vague codes anyway */
                 rep = 1;
                 break;
             }
@@ -848,7 +2164,7 @@ uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
             __split_method_t* m = m2;
             m2 = m2->next;
             m1->next = m2;
-            zh_buffer_free(m);
+            query_free(dec, m);
             m_list->num--;
         }
         else { /* not repeat */
@@ -863,7 +2179,7 @@ uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
     while (m != NULL) {
         __split_method_t* tmp = m;
         m = m->next;
-        zh_buffer_free(tmp);
+        query_free(dec, tmp);
         m_list->num--;
     }
     return 0;
@@ -872,34 +2188,280 @@ uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
 /**
  * @brief free the split method object
  */
-void zh_pinyin_free_split(__split_method_list_t* m_list) {
-    if (m_list != NULL) mlist_destroy(m_list);
-    m_list = NULL;
+void zh_pinyin_free_split_r(zh_decoder_t* dec, __split_method_list_t* m_list) {
+    if (dec == NULL || m_list == NULL) return;
+    mlist_destroy(dec, m_list);
+    query_end(dec);
 }
 
+#if (USE_ZH_RESULT_CACHE == 1)
+
+/**
+ * @brief remove all the results kept in the cache of context (call it after the dictionary is changed)
+ */
+void zh_result_cache_clear_r(zh_decoder_t* dec) {
+    if (dec == NULL) return;
+    zh_result_cache_reset(&dec->cache);
+}
+
+/**
+ * @brief get the statistics of result cache
+ * @param hit   number of queries found in cache (NULL if not needed)
+ * @param miss  number of queries not found in cache (NULL if not needed)
+ * @param used  bytes used in cache (NULL if not needed)
+ */
+void zh_result_cache_stat_r(zh_decoder_t* dec, uint32_t* hit, uint32_t* miss, uint16_t* used) {
+    if (dec == NULL) return;
+    if (hit)  *hit = dec->cache.hit;
+    if (miss) *miss = dec->cache.miss;
+    if (used) *used = dec->cache.used;
+}
+
+#endif
+
 #if (USE_ZH_WORD_MATCH == 1)
 
 /// @brief match the word in a mixed pinyin string
+/// @param dec      decoder context
 /// @param str 
 /// @param num      maximum number of words and codes for read (MAX_WORD_MATCH_NUM is recommended)
 /// @param sp       prior split method for str (transfer an object for return result)
 /// @return 
-__word_block_t* zh_match_word(const char* str, __split_method_t *sp) {
-    if (chk_valid_string(str)) return NULL;
-    uint8_t res = 0;
+__word_block_t* zh_match_word_r(zh_decoder_t* dec, const char* str, __split_method_t *sp) {
+    if (dec == NULL || chk_valid_string(str)) return NULL;
 
+    query_begin(dec);   /* word blocks are kept after the split list is freed */
+#if (USE_ZH_RESULT_CACHE == 1)
+    __word_block_t* w_hit = word_cache_get(dec, str, sp);
+    if (w_hit != NULL) return w_hit;
+#endif
     /* split pinyin */
-    __split_method_list_t* m_list = zh_pinyin_get_split(str);
-    if (zh_pinyin_filter_split(m_list)) return NULL;   /* filter the split string method */
+    __split_method_list_t* m_list = zh_pinyin_get_split_r(dec, str);
+    if (zh_pinyin_filter_split_r(dec, m_list)) {   /* filter the split string method */
+        query_end(dec);
+        return NULL;
+    }
     
-    if (sp != NULL) memcpy(sp, m_list->head, sizeof(__split_method_t));
-    __word_block_t *w = word_dict_search(str, m_list);
-    zh_pinyin_free_split(m_list);
+    __split_method_t head;
+    memcpy(&head, m_list->head, sizeof(__split_method_t));
+    if (sp != NULL) memcpy(sp, &head, sizeof(__split_method_t));
+    __word_block_t *w = word_dict_search(dec, str, m_list);
+    zh_pinyin_free_split_r(dec, m_list);
+    if (w == NULL) query_end(dec);
+#if (USE_ZH_RESULT_CACHE == 1)
+    else word_cache_put(dec, str, &head, w);
+#endif
     return w;
 }
 
-void zh_word_free_match(__word_block_t* blk){
-    wordblock_destroy(blk);
+/**
+ * @brief free the result of zh_match_word_r (must be the same context)
+ */
+void zh_word_free_match_r(zh_decoder_t* dec, __word_block_t* blk){
+    if (dec == NULL || blk == NULL) return;
+    wordblock_destroy(dec, blk);
+    query_end(dec);
+}
+
+/**
+ * @brief match the words and codes in a mixed pinyin string, and fill a flat candidate list
+ * @note  same result and order as zh_match_word_r, but no word block is allocated : codes and 
+ *        words are written to list->text directly, and each candidate is a record in list->cand.
+ * @param dec      decoder context
+ * @param str      input string
+ * @param sp       prior split method for str (NULL if not needed)
+ * @param list     candidate list to fill (caller owned)
+ * @return 0: success, 1: nothing matched or read error (list->num is 0)
+ */
+uint8_t zh_match_cand_r(zh_decoder_t* dec, const char* str, __split_method_t* sp, __zh_cand_list_t* list) {
+    if (list == NULL) return 1;
+    list->num = 0;
+    if (dec == NULL || chk_valid_string(str)) return 1;
+
+#if (USE_ZH_RESULT_CACHE == 1)
+    if (cand_cache_get(dec, str, sp, list) == 0) return 0;
+#endif
+    __split_method_list_t* m_list = zh_pinyin_get_split_r(dec, str);
+    if (zh_pinyin_filter_split_r(dec, m_list)) return 1;
+    __split_method_t head;
+    memcpy(&head, m_list->head, sizeof(__split_method_t));
+    if (sp != NULL) memcpy(sp, &head, sizeof(__split_method_t));
+    if (cand_fill(dec, str, m_list, list, NULL)) return 1;
+#if (USE_ZH_RESULT_CACHE == 1)
+    cand_cache_put(dec, str, &head, list);
+#endif
+    return 0;
+}
+
+#if (USE_ZH_LEARN == 1)
+
+/**
+ * @brief count a candidate of list as committed by user, it's put before the others in later matches 
+ *        of the same pinyin (a word covers the whole input, a code covers the first piece of sp)
+ * @param str   input string the list is matched with
+ * @param sp    split method given by zh_match_cand_r
+ * @param idx   index of candidate in list
+ * @return 0: success, 1: invalid parameter
+ */
+uint8_t zh_commit_cand(const char* str, const __split_method_t* sp, const __zh_cand_list_t* list, uint16_t idx) {
+    if (str == NULL || sp == NULL || list == NULL || idx >= list->num) return 1;
+    const __zh_cand_t* cd = &list->cand[idx];
+    size_t n = cd->kind == CAND_KIND_WORD ? strlen(str) : sp->spm[0];
+    if (n > strlen(str)) n = strlen(str);
+    return zh_commit(str, (uint8_t)n, list->text + cd->utf8_offset, cd->utf8_len);
+}
+
+#endif
+
+#if (USE_ZH_SESSION == 1)
+
+/* recompute the candidates of session input from its lattice */
+static void session_update_cand(zh_session_t* ses) {
+    ses->cand.num = 0;
+    if (ses->len == 0) return;
+#if (USE_ZH_RESULT_CACHE == 1)
+    if (cand_cache_get(ses->dec, ses->str, &ses->sp, &ses->cand) == 0) return;
+#endif
+    __split_method_list_t* m_list = pinyin_lattice_list(ses->dec, &ses->lattice, ses->str, ses->len);
+    if (zh_pinyin_filter_split_r(ses->dec, m_list)) return;
+    memcpy(&ses->sp, m_list->head, sizeof(__split_method_t));
+    if (cand_fill(ses->dec, ses->str, m_list, &ses->cand, &ses->cache)) return;
+#if (USE_ZH_RESULT_CACHE == 1)
+    cand_cache_put(ses->dec, ses->str, &ses->sp, &ses->cand);
+#endif
+}
+
+/**
+ * @brief initialize a keystroke session
+ * @param dec  decoder context used by session (NULL : the default context)
+ */
+void zh_session_init(zh_session_t* ses, zh_decoder_t* dec) {
+    if (ses == NULL) return;
+    memset(ses, 0, sizeof(zh_session_t));
+    ses->dec = dec ? dec : &g_decoder;
+}
+
+/* clear the input, committed text and cache of session (decoder context is kept) */
+void zh_session_reset(zh_session_t* ses) {
+    if (ses == NULL) return;
+    zh_session_init(ses, ses->dec);
+}
+
+/**
+ * @brief append a letter to session input and update the candidates
+ * @note  only the lattice rows which can reach the new letter are rebuilt, and the codes of 
+ *        first piece and the dictionary key ranges of input prefixes are reused.
+ * @return 0: success, 1: invalid letter or input is full (input not changed)
+ */
+uint8_t zh_session_push_char(zh_session_t* ses, char c) {
+    if (ses == NULL || c < 'a' || c > 'z' || ses->len >= ZH_MAX_STRING_LENGTH) return 1;
+    uint8_t from = ses->len > MAX_WORD_CODE_LENGTH ? ses->len - MAX_WORD_CODE_LENGTH : 0;
+    ses->str[ses->len++] = c;
+    ses->str[ses->len] = '\0';
+    pinyin_lattice_update(&ses->lattice, ses->str, ses->len, from);
+    session_update_cand(ses);
+    return 0;
+}
+
+/**
+ * @brief remove the last letter of session input and update the candidates
+ * @return 0: success, 1: input is empty
+ */
+uint8_t zh_session_pop_char(zh_session_t* ses) {
+    if (ses == NULL || ses->len == 0) return 1;
+    ses->str[--ses->len] = '\0';
+#if (USE_ZH_WORD_DICT_BIN == 1)
+    if (ses->cache.range_num > ses->len) ses->cache.range_num = ses->len;
+#endif
+    uint8_t from = ses->len > MAX_WORD_CODE_LENGTH ? ses->len - MAX_WORD_CODE_LENGTH : 0;
+    pinyin_lattice_update(&ses->lattice, ses->str, ses->len, from);
+    session_update_cand(ses);
+    return 0;
+}
+
+/**
+ * @brief select a candidate : its text is appended to ses->commit, and the letters it covers are 
+ *        removed from input (a word covers the whole input, a code covers the first piece of ses->sp).
+ *        the candidate is also counted by zh_commit_cand when learning is enabled
+ * @param idx  index of candidate in ses->cand
+ * @return 0: success, 1: invalid index or commit buffer is full
+ */
+uint8_t zh_session_select_candidate(zh_session_t* ses, uint16_t idx) {
+    if (ses == NULL || idx >= ses->cand.num) return 1;
+    const __zh_cand_t* cd = &ses->cand.cand[idx];
+    if (ses->commit_len + cd->utf8_len >= ZH_SESSION_COMMIT_SZ) return 1;
+#if (USE_ZH_LEARN == 1)
+    zh_commit_cand(ses->str, &ses->sp, &ses->cand, idx);
+#endif
+    memcpy(ses->commit + ses->commit_len, ses->cand.text + cd->utf8_offset, cd->utf8_len);
+    ses->commit_len += cd->utf8_len;
+    ses->commit[ses->commit_len] = '\0';
+
+    uint8_t n = cd->kind == CAND_KIND_WORD ? ses->len : ses->sp.spm[0];
+    if (n > ses->len) n = ses->len;
+    ses->len -= n;
+    memmove(ses->str, ses->str + n, ses->len + 1);
+    /* rows of lattice only depend on the letters after it, so they are moved with the input */
+    memmove(ses->lattice.edge[0], ses->lattice.edge[n], sizeof(ses->lattice.edge[0]) * ses->len);
+    pinyin_lattice_update(&ses->lattice, ses->str, ses->len, ses->len);
+#if (USE_ZH_WORD_DICT_BIN == 1)
+    ses->cache.range_num = 0;
+#endif
+    session_update_cand(ses);
+    return 0;
+}
+
+#endif
+
+#endif
+
+/******************************* default context functions *********************************/
+/* functions below use the shared default context, they are kept for single thread use */
+
+uint8_t zh_match_code_prec(const char* str, char* res_str, uint8_t num, uint8_t* br) {
+    return zh_match_code_prec_r(&g_decoder, str, res_str, num, br);
+}
+
+uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t* br) {
+    return zh_match_code_vague_r(&g_decoder, str, res_str, num, br);
+}
+
+__split_method_list_t* zh_pinyin_get_split(const char* str) {
+    return zh_pinyin_get_split_r(&g_decoder, str);
+}
+
+uint8_t zh_pinyin_filter_split(__split_method_list_t* m_list) {
+    return zh_pinyin_filter_split_r(&g_decoder, m_list);
+}
+
+void zh_pinyin_free_split(__split_method_list_t* m_list) {
+    zh_pinyin_free_split_r(&g_decoder, m_list);
+}
+
+#if (USE_ZH_WORD_MATCH == 1)
+
+__word_block_t* zh_match_word(const char* str, __split_method_t* sp) {
+    return zh_match_word_r(&g_decoder, str, sp);
+}
+
+void zh_word_free_match(__word_block_t* blk) {
+    zh_word_free_match_r(&g_decoder, blk);
+}
+
+uint8_t zh_match_cand(const char* str, __split_method_t* sp, __zh_cand_list_t* list) {
+    return zh_match_cand_r(&g_decoder, str, sp, list);
+}
+
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+void zh_result_cache_clear(void) {
+    zh_result_cache_clear_r(&g_decoder);
+}
+
+void zh_result_cache_stat(uint32_t* hit, uint32_t* miss, uint16_t* used) {
+    zh_result_cache_stat_r(&g_decoder, hit, miss, used);
 }
 
 #endif
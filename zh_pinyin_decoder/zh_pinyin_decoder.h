@@ -24,22 +24,76 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include "zh_storage.h"
+
+#ifndef __min
+#define __min(a, b)  (((a) < (b)) ? (a) : (b))     /* msvc provides it in stdlib.h */
+#endif
 
 /********************************** Basic Settings *********************************/
 
 #define USE_ZH_WORD_MATCH           1   /* use match word support option  */
 #define USE_ZH_HASH_BOOST           1   /* use the hash table method (search faster but take more ROM)  */
+#define USE_ZH_WORD_DICT_BIN        1   /* use compiled binary dictionary (zh_word_dict.bin) instead of parsing json */
+#define USE_ZH_WORD_JSON_INDEX      1   /* json dictionary only : build sidecar index file, 0 : binary search json file directly */
+#define USE_ZH_JSON_SIMD            1   /* json dictionary only : mark structural characters by SSE2/AVX2/NEON if compiler enables it */
+#define USE_ZH_CODE_TABLE_RESIDENT  1   /* allow loading code table into RAM by zh_code_table_load() (take ~23kb RAM) */
+#define USE_ZH_WORD_TRIE            1   /* allow loading key trie into RAM by zh_word_trie_load() (take ~440kb RAM) */
+#define USE_ZH_WORD_ABBR            1   /* allow loading initials index into RAM by zh_word_abbr_load() (take ~120kb RAM) */
+#define USE_ZH_WORD_BOUND           1   /* allow loading max word weight of each key by zh_word_bound_load() (take ~21kb RAM) */
+#define USE_ZH_QUERY_ARENA          1   /* allocate query results from an arena in decoder context instead of heap */
+#define USE_ZH_VAGUE_TABLE          1   /* allow loading precomputed vague match table by zh_vague_table_load() (take ~40kb RAM) */
+#define USE_ZH_CHAR_ID_TABLE        1   /* allow loading 16-bit character id code table by zh_char_id_load() (take ~15kb RAM) */
+#define USE_ZH_SESSION              1   /* incremental keystroke session api zh_session_xxx (~3.5kb RAM each session) */
+#define USE_ZH_RESULT_CACHE         1   /* keep recent match results in decoder context (LRU, ZH_RESULT_CACHE_SZ RAM each context) */
+#define USE_ZH_STORAGE_CACHE        1   /* allow caching storage reads in RAM blocks by zh_storage_cache_init() (budget given at init) */
+#define USE_ZH_USER_DICT            1   /* words inserted, deleted and boosted at runtime by zh_user_dict_xxx (~12kb RAM, log file) */
+#define USE_ZH_LEARN                1   /* rank candidates committed by zh_commit() higher (~8kb RAM, snapshot file) */
+#ifndef USE_ZH_EMBED_TABLES
+#define USE_ZH_EMBED_TABLES         0   /* files are linked into binary and read by embed storage backend (set by CMake option ZH_EMBED_TABLES) */
+#endif
 
 #if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_HASH_BOOST == 0)
     #pragma message("USE_ZH_HASH_BOOST is recommended for better performance when matching word is required")
 #endif
 
+#if (USE_ZH_WORD_TRIE == 1) && ((USE_ZH_WORD_MATCH == 0) || (USE_ZH_WORD_DICT_BIN == 0))
+    #error "USE_ZH_WORD_TRIE requires USE_ZH_WORD_MATCH and USE_ZH_WORD_DICT_BIN"
+#endif
+
+#if (USE_ZH_WORD_ABBR == 1) && ((USE_ZH_WORD_MATCH == 0) || (USE_ZH_WORD_DICT_BIN == 0))
+    #error "USE_ZH_WORD_ABBR requires USE_ZH_WORD_MATCH and USE_ZH_WORD_DICT_BIN"
+#endif
+
+#if (USE_ZH_WORD_BOUND == 1) && ((USE_ZH_WORD_MATCH == 0) || (USE_ZH_WORD_DICT_BIN == 0))
+    #error "USE_ZH_WORD_BOUND requires USE_ZH_WORD_MATCH and USE_ZH_WORD_DICT_BIN"
+#endif
+
+#if (USE_ZH_USER_DICT == 1) && (USE_ZH_WORD_MATCH == 0)
+    #error "USE_ZH_USER_DICT requires USE_ZH_WORD_MATCH"
+#endif
+
+#if (USE_ZH_SESSION == 1) && (USE_ZH_WORD_MATCH == 0)
+    #error "USE_ZH_SESSION requires USE_ZH_WORD_MATCH"
+#endif
+
 #define ZH_CODE_TABLE_FILE_NAME      "zh_pinyin_decoder/bin/zh_pinyin.bin"      // code table file name
 #define ZH_WORD_DICTIONARY_FILE_NAME "zh_pinyin_decoder/bin/zh_word_dict.json"  // dictionary json file name 
+#define ZH_WORD_DICT_BIN_FILE_NAME   "zh_pinyin_decoder/bin/zh_word_dict.bin"   // compiled dictionary file name (tools/zh_dict_compile.c)
+#define ZH_WORD_DICT_INDEX_FILE_NAME "zh_pinyin_decoder/bin/zh_word_dict.idx"   // sparse key index of json dictionary (built when json is used)
+#define ZH_VAGUE_TABLE_FILE_NAME     "zh_pinyin_decoder/bin/zh_vague.bin"       // precomputed vague match table (tools/zh_vague_compile.c)
+#define ZH_CHAR_ID_FILE_NAME         "zh_pinyin_decoder/bin/zh_pinyin_id.bin"   // 16-bit character id code table (tools/zh_char_id_compile.c)
+#define ZH_USER_DICT_FILE_NAME       "zh_pinyin_decoder/bin/zh_user_dict.log"   // edit log of user dictionary (written at runtime)
+#define ZH_LEARN_FILE_NAME           "zh_pinyin_decoder/bin/zh_learn.bin"       // snapshot of learned counters (written by zh_learn_save)
 
 #define zh_buffer_malloc  malloc
 #define zh_buffer_free    free
 
+#define ZH_QUERY_ARENA_SZ    3 * 1024   /* arena size of each context, ~2.3kb at most for word match (heap is used when it's full) */
+#define ZH_RESULT_CACHE_SZ   32 * 1024  /* result cache size of each context (< 64kb), a word or candidate result takes 0.1 ~ 2kb */
+#define ZH_STORAGE_CACHE_BLOCK_SZ  256  /* block size of storage cache (aligned in file), budget should be > 2 * ZH_WORD_DICT_BUFFER_SZ */
+
 /********************************** LOG Setttings *********************************/
 
 #define ZH_USE_LOG        1 
@@ -67,13 +121,12 @@
 #define ZH_VAGUE_SEARCH_TYPES        10      // most 10 types of other vague search
 #define ZH_VAGUE_SEARCH_DEPTH        3       // 2 search depth for vague match 
 
-#define ZH_PINYIN_MAX_SPLIT_METHODS     100    // maximum possible split methods number (used for truncate bfs)
 #define ZH_PINYIN_MAX_FILTER_TYPES      3         // maximum word match types for filter
 #define ZH_PINYIN_SIGNLE_SEARCH_DEPTH   10     // maximum search depth for single word search
 
 #if (USE_ZH_WORD_MATCH  == 1)
 
-#define ZH_WORD_DICT_BUFFER_SZ        4 * 1024  // 4kb buffer for json parse
+#define ZH_WORD_DICT_BUFFER_SZ        4 * 1024  // 4kb buffer for json parse (or binary dictionary read)
 
 #define ZH_WORD_MAX_BUFFER_READ       1500      // search buffer depth after the first read (100 later)
 #define ZH_WORD_MAX_MATCH_LENGTH      25        // maximum numbfer of words in result
@@ -99,6 +152,8 @@
 #define MAX_WORD_BLK_WORD_NUM       20                  /** max number of words in one block */
 #define MAX_WORD_MATCH_NUM          160                 /** max number for  */
 
+#define ZH_SESSION_COMMIT_SZ        (6 * ZH_MAX_STRING_LENGTH + 1)   /** buffer size of committed text in session */
+
 #endif
 
 /************************** PUBLIC TYPEDEFS *******************************************/
@@ -113,10 +168,23 @@ typedef struct match_case_node_t {
 
 /* single link list for store match case */
 typedef struct match_case_list_t {
-    uint8_t num;
+    uint16_t num;
+    uint8_t  syl;                    /* 1: string splits fully into syllables (it's not abbreviated) */
     struct  match_case_node_t* head;
 }__split_method_list_t;
 
+/**
+* @defgroup pinyin_edge_flag
+*/
+#define ZH_PINYIN_EDGE_PREC        0x01     /** piece is a whole syllable */
+#define ZH_PINYIN_EDGE_VAGUE       0x02     /** piece is the prefix of a longer syllable */
+
+/* syllable lattice over the character positions of input string */
+typedef struct pinyin_lattice_t {
+    uint8_t edge[ZH_MAX_STRING_LENGTH][MAX_WORD_CODE_LENGTH + 1];  /* edge[p][l] : flag of piece str[p, p + l) */
+    uint8_t reach[ZH_MAX_STRING_LENGTH + 1];  /* bit k set : string end is reachable from p by k pieces */
+}__pinyin_lattice_t;
+
 
 #if (USE_ZH_WORD_MATCH == 1)
 
@@ -144,10 +212,211 @@ typedef struct word_dict_search_result_t{
 #define WORD_SEARCH_STATE_CODE_VAGUE_MATCH   1
 #define WORD_SEARCH_STATE_CODE_PREC_MATCH    2
 
+/**
+* @defgroup cand_kind
+*/
+#define CAND_KIND_CODE            0     /** single zh character */
+#define CAND_KIND_WORD            1     /** word in dictionary  */
+
+#define ZH_CAND_MAX_NUM           (MAX_CODE_SEARCH_TYPES + MAX_WORD_BLK_WORD_NUM)    /** max candidates of a match */
+#define ZH_CAND_TEXT_SZ           (3 * MAX_CODE_SEARCH_TYPES + 3 * MAX_WORD_BLK_WORD_NUM * MAX_WORD_LENGTH + 1)
+
+/* candidate record, text is list->text[utf8_offset, utf8_offset + utf8_len) (not terminated) */
+typedef struct zh_cand_t {
+    uint16_t utf8_offset;            /* offset of utf-8 text in list->text */
+    uint8_t  utf8_len;               /* bytes of utf-8 text */
+    uint8_t  char_count;             /* number of zh characters */
+    uint8_t  kind;                   /* refer to @defgroup cand_kind */
+    uint16_t score;                  /* rank score, candidates are in decreasing score order */
+}__zh_cand_t;
+
+/* flat candidate list filled by zh_match_cand (caller owned, no pointer inside, can be copied directly) */
+typedef struct zh_cand_list_t {
+    uint16_t    num;                 /* number of candidates */
+    __zh_cand_t cand[ZH_CAND_MAX_NUM];
+    char        text[ZH_CAND_TEXT_SZ];
+}__zh_cand_list_t;
+
+/* range [lo, hi) of dictionary keys */
+typedef struct zh_key_range_t {
+    uint32_t lo;
+    uint32_t hi;
+}__zh_key_range_t;
+
+/* results kept between the queries of a growing input (keystrokes of a session) */
+typedef struct zh_match_cache_t {
+    char     code_key[MAX_WORD_CODE_LENGTH + 1];  /* first piece of the last code match ("" : none) */
+    uint8_t  code_br;                /* number of codes in code_buf */
+    char     code_buf[MAX_CODE_BUFF_SZ];          /* codes of code_key (most frequent first) */
+#if (USE_ZH_WORD_DICT_BIN == 1)
+    uint8_t  range_num;              /* range[k] is the key range of input prefix str[0, k + 1) for k < range_num */
+    __zh_key_range_t range[MAX_WORD_CODE_LENGTH];
+#endif
+}__zh_match_cache_t;
+
 #endif 
 
+#if (USE_ZH_QUERY_ARENA == 1)
+
+/* bump allocator for the results of a query, released at once when all results are freed */
+typedef struct zh_arena_t {
+    void*    buf[ZH_QUERY_ARENA_SZ / sizeof(void*)];   /* arena memory (pointer aligned) */
+    uint16_t used;                   /* bytes allocated */
+    uint16_t last;                   /* offset of the last allocation (it can be given back when freed) */
+    uint16_t peak;                   /* max bytes allocated (for tuning ZH_QUERY_ARENA_SZ) */
+    uint8_t  refs;                   /* number of results not freed */
+}__zh_arena_t;
+
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+#if (ZH_RESULT_CACHE_SZ > 65535)
+    #error "ZH_RESULT_CACHE_SZ must be less than 64kb"
+#endif
+
+/* byte-bounded LRU cache of match results, entries are packed in buf (refer to zh_result_cache.h) */
+typedef struct zh_result_cache_t {
+    uint8_t  buf[ZH_RESULT_CACHE_SZ];  /* entries */
+    uint16_t used;                   /* bytes of entries */
+    uint16_t num;                    /* number of entries */
+    uint32_t clock;                  /* stamp of the last used entry */
+    uint32_t hit;                    /* number of queries found in cache */
+    uint32_t miss;                   /* number of queries not found in cache */
+    uint32_t evict;                  /* number of entries evicted */
+}__zh_result_cache_t;
+
+#endif
+
+/**
+* @brief decoder context, holds all the per-query states (scratch buffers, opened files, lattice)
+* @note  functions with "_r" suffix take a context, each thread should own its context then 
+*        decode concurrently without locking. functions without "_r" use a shared default context.
+*/
+typedef struct zh_decoder_ctx_t {
+    zh_storage_t code_st;            /* opened code table file (not opened: open on each call) */
+#if (USE_ZH_WORD_MATCH == 1)
+    zh_storage_t dict_st;            /* opened word dictionary file (not opened: open on each call) */
+    uint8_t  dict_buf[ZH_WORD_DICT_BUFFER_SZ];  /* buffer for json parse */
+#endif
+    __pinyin_lattice_t lattice;      /* syllable lattice of current split query */
+#if (USE_ZH_QUERY_ARENA == 1)
+    __zh_arena_t arena;              /* memory of split lists and word blocks returned */
+#endif
+#if (USE_ZH_RESULT_CACHE == 1)
+    __zh_result_cache_t cache;       /* recent results of zh_match_code_vague, zh_match_word and zh_match_cand */
+    uint32_t gen;                    /* generation of tables, user dictionary and learned counters the cached results are matched with */
+#endif
+}zh_decoder_t;
+
+#if (USE_ZH_SESSION == 1)
+
+/**
+* @brief keystroke session of an input method, the lattice and the match cache are kept between 
+*        keystrokes, so that each keystroke only updates the lattice rows near the input end.
+* @note  candidates of current input are in cand, text selected is appended to commit.
+*/
+typedef struct zh_session_t {
+    zh_decoder_t*  dec;              /* decoder context used by session */
+    char     str[ZH_MAX_STRING_LENGTH + 1];       /* pinyin input not selected yet */
+    uint8_t  len;                    /* length of str */
+    __pinyin_lattice_t lattice;      /* lattice of str */
+    __split_method_t sp;             /* first split method of current candidates */
+    __zh_match_cache_t cache;        /* code and dictionary results reused by next keystroke */
+    char     commit[ZH_SESSION_COMMIT_SZ];        /* text of selected candidates */
+    uint16_t commit_len;             /* bytes of commit */
+    __zh_cand_list_t cand;           /* candidates of current input */
+}zh_session_t;
+
+#endif
+
 /************************** PUBLIC FUNCTIONS *******************************************/
 
+uint8_t zh_decoder_init(zh_decoder_t* dec);
+void zh_decoder_deinit(zh_decoder_t* dec);
+
+uint8_t zh_match_code_prec_r(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br);
+uint8_t zh_match_code_vague_r(zh_decoder_t* dec, const char* str, char* res_str, uint8_t num, uint8_t* br);
+
+__split_method_list_t* zh_pinyin_get_split_r(zh_decoder_t* dec, const char* str);
+uint8_t zh_pinyin_filter_split_r(zh_decoder_t* dec, __split_method_list_t* m_list);
+void zh_pinyin_free_split_r(zh_decoder_t* dec, __split_method_list_t* m_list);
+
+#if (USE_ZH_WORD_MATCH == 1)
+
+__word_block_t* zh_match_word_r(zh_decoder_t* dec, const char* str, __split_method_t* sp);
+void zh_word_free_match_r(zh_decoder_t* dec, __word_block_t* blk);
+uint8_t zh_match_cand_r(zh_decoder_t* dec, const char* str, __split_method_t* sp, __zh_cand_list_t* list);
+
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+void zh_result_cache_clear_r(zh_decoder_t* dec);
+void zh_result_cache_stat_r(zh_decoder_t* dec, uint32_t* hit, uint32_t* miss, uint16_t* used);
+
+#endif
+
+#if (USE_ZH_SESSION == 1)
+
+void zh_session_init(zh_session_t* ses, zh_decoder_t* dec);
+void zh_session_reset(zh_session_t* ses);
+uint8_t zh_session_push_char(zh_session_t* ses, char c);
+uint8_t zh_session_pop_char(zh_session_t* ses);
+uint8_t zh_session_select_candidate(zh_session_t* ses, uint16_t idx);
+
+#endif
+
+
+#if (USE_ZH_CODE_TABLE_RESIDENT == 1)
+
+uint8_t zh_code_table_load(void);
+void zh_code_table_unload(void);
+
+#endif
+
+#if (USE_ZH_WORD_TRIE == 1)
+
+uint8_t zh_word_trie_load(void);
+void zh_word_trie_unload(void);
+
+#endif
+
+#if (USE_ZH_WORD_ABBR == 1)
+
+uint8_t zh_word_abbr_load(void);
+void zh_word_abbr_unload(void);
+
+#endif
+
+#if (USE_ZH_WORD_BOUND == 1)
+
+uint8_t zh_word_bound_load(void);
+void zh_word_bound_unload(void);
+
+#endif
+
+#if (USE_ZH_WORD_MATCH == 1) && (USE_ZH_WORD_DICT_BIN == 0) && (USE_ZH_WORD_JSON_INDEX == 1)
+
+uint8_t zh_word_json_index_load(void);
+void zh_word_json_index_unload(void);
+
+#endif
+
+#if (USE_ZH_VAGUE_TABLE == 1)
+
+uint8_t zh_vague_table_load(void);
+void zh_vague_table_unload(void);
+
+#endif
+
+#if (USE_ZH_CHAR_ID_TABLE == 1)
+
+uint8_t zh_char_id_load(void);
+void zh_char_id_unload(void);
+
+#endif
+
 uint8_t zh_match_code_prec(const char* str, char* res_str, uint8_t num, uint8_t* br);
 uint8_t zh_match_code_vague(const char* str, char* res_str, uint8_t num, uint8_t* br);
 
@@ -160,7 +429,20 @@ void zh_pinyin_free_split(__split_method_list_t* m_list);
 
 __word_block_t* zh_match_word(const char* str, __split_method_t* sp);
 void zh_word_free_match(__word_block_t* blk);
+uint8_t zh_match_cand(const char* str, __split_method_t* sp, __zh_cand_list_t* list);
+
+#if (USE_ZH_LEARN == 1)
+
+uint8_t zh_commit_cand(const char* str, const __split_method_t* sp, const __zh_cand_list_t* list, uint16_t idx);
+
+#endif
+
+#endif
+
+#if (USE_ZH_RESULT_CACHE == 1)
 
+void zh_result_cache_clear(void);
+void zh_result_cache_stat(uint32_t* hit, uint32_t* miss, uint16_t* used);
 
 #endif
 
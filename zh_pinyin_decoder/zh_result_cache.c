@@ -0,0 +1,98 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_result_cache.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-08  (last modified)
+ * @brief          : memory-bounded LRU cache of query results
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the cache only holds a few dozens of entries, so it's searched linearly,
+ * which is much cheaper than the file read and dictionary scan it saves.
+ * a hit only updates the stamp of entry, entries are moved only when the
+ * least recently used one is evicted by an insert (a missed query).
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_result_cache.h"
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+/************************   private functions   *********************************/
+
+static uint16_t entry_size(const uint8_t* e) {
+    return (uint16_t)(e[0] | (e[1] << 8));
+}
+
+static uint32_t entry_stamp(const uint8_t* e) {
+    return (uint32_t)e[5] | ((uint32_t)e[6] << 8) | ((uint32_t)e[7] << 16) | ((uint32_t)e[8] << 24);
+}
+
+static void entry_touch(__zh_result_cache_t* c, uint8_t* e) {
+    uint32_t t = ++c->clock;
+    e[5] = (uint8_t)t; e[6] = (uint8_t)(t >> 8); e[7] = (uint8_t)(t >> 16); e[8] = (uint8_t)(t >> 24);
+}
+
+/* remove the least recently used entry, entries after it are moved forward */
+static void evict_lru(__zh_result_cache_t* c) {
+    uint16_t lru = 0;
+    for (uint16_t off = 0; off < c->used; off += entry_size(c->buf + off)) {
+        if (entry_stamp(c->buf + off) - entry_stamp(c->buf + lru) > UINT32_MAX / 2) lru = off;
+    }
+    uint16_t sz = entry_size(c->buf + lru);
+    memmove(c->buf + lru, c->buf + lru + sz, c->used - lru - sz);
+    c->used -= sz;
+    c->num--;
+    c->evict++;
+}
+
+/************************   public functions   *********************************/
+
+/* remove all the entries (counters are kept) */
+void zh_result_cache_reset(__zh_result_cache_t* c) {
+    c->used = 0;
+    c->num = 0;
+}
+
+/**
+ * @brief find the entry of (kind, param, key), a hit entry becomes the most recently used
+ * @param val_len  bytes of value
+ * @return value of entry (valid until next insert), NULL if not found
+ */
+const uint8_t* zh_result_cache_find(__zh_result_cache_t* c, uint8_t kind, uint8_t param, const char* key, uint8_t key_len, uint16_t* val_len) {
+    for (uint16_t off = 0; off < c->used; off += entry_size(c->buf + off)) {
+        uint8_t* e = c->buf + off;
+        if (e[2] != kind || e[3] != param || e[4] != key_len ||
+            memcmp(e + ZH_RESULT_ENTRY_HDR_SZ, key, key_len) != 0) continue;
+        entry_touch(c, e);
+        c->hit++;
+        *val_len = entry_size(e) - ZH_RESULT_ENTRY_HDR_SZ - key_len;
+        return e + ZH_RESULT_ENTRY_HDR_SZ + key_len;
+    }
+    c->miss++;
+    return NULL;
+}
+
+/**
+ * @brief add an entry as the most recently used, least recently used entries are evicted to make room
+ * @note  the key must not be in cache (insert after a missed find)
+ * @return value buffer of val_len bytes to fill, NULL if the entry is larger than the cache
+ */
+uint8_t* zh_result_cache_insert(__zh_result_cache_t* c, uint8_t kind, uint8_t param, const char* key, uint8_t key_len, uint16_t val_len) {
+    uint32_t sz = ZH_RESULT_ENTRY_HDR_SZ + (uint32_t)key_len + val_len;
+    if (sz > ZH_RESULT_CACHE_SZ) return NULL;
+    while (c->used + sz > ZH_RESULT_CACHE_SZ) evict_lru(c);
+
+    uint8_t* e = c->buf + c->used;
+    e[0] = (uint8_t)sz; e[1] = (uint8_t)(sz >> 8);
+    e[2] = kind; e[3] = param; e[4] = key_len;
+    entry_touch(c, e);
+    memcpy(e + ZH_RESULT_ENTRY_HDR_SZ, key, key_len);
+    c->used += (uint16_t)sz;
+    c->num++;
+    return e + ZH_RESULT_ENTRY_HDR_SZ + key_len;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_result_cache.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : memory-bounded LRU cache of query results
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_RESULT_CACHE is set to 1. the cache
+ * (__zh_result_cache_t in zh_pinyin_decoder.h) is a part of decoder context,
+ * its entries are packed in one buffer of ZH_RESULT_CACHE_SZ bytes :
+ *
+ *   entry : size(2) | kind(1) | param(1) | key_len(1) | stamp(4) | key | value
+ *
+ * stamp is the clock of the last use of entry. the entry with the smallest
+ * stamp is evicted when a new entry doesn't fit, so the byte budget is never
+ * exceeded and no memory is allocated. the value is copied by the caller,
+ * it's only valid until the next insert.
+ *****************************************************************************
+ */
+#ifndef __ZH_RESULT_CACHE_H
+#define __ZH_RESULT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+
+#if (USE_ZH_RESULT_CACHE == 1)
+
+#define ZH_RESULT_ENTRY_HDR_SZ      9       /* size(2) | kind(1) | param(1) | key_len(1) | stamp(4) */
+
+/**
+* @defgroup result_cache_kind
+*/
+#define ZH_RESULT_KIND_VAGUE        0       /** zh_match_code_vague result (param : num) */
+#define ZH_RESULT_KIND_WORD         1       /** zh_match_word result */
+#define ZH_RESULT_KIND_CAND         2       /** zh_match_cand result */
+
+void zh_result_cache_reset(__zh_result_cache_t* c);
+const uint8_t* zh_result_cache_find(__zh_result_cache_t* c, uint8_t kind, uint8_t param, const char* key, uint8_t key_len, uint16_t* val_len);
+uint8_t* zh_result_cache_insert(__zh_result_cache_t* c, uint8_t kind, uint8_t param, const char* key, uint8_t key_len, uint16_t val_len);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
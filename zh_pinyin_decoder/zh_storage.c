@@ -0,0 +1,373 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_storage.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-13  (last modified)
+ * @brief          : storage backends of table and dictionary files
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the backend used by zh_storage_open() is global, set it once at init (before
+ * decoder contexts are inited and tables are loaded). it's stdio by default,
+ * or embed when the tables are linked into binary (USE_ZH_EMBED_TABLES). the statistics of reads
+ * and flash backend are not locked, they are approximate when contexts decode
+ * concurrently.
+ *****************************************************************************
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "zh_storage.h"
+#include "zh_pinyin_decoder.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define ZH_STORAGE_POSIX_MMAP
+#endif
+
+typedef struct {
+    const char*    path;
+    const uint8_t* data;
+    uint32_t       size;
+}__ram_blob_t;
+
+/************************   private functions   *********************************/
+
+static uint8_t  stdio_open(zh_storage_t* st, const char* path);
+static uint32_t stdio_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);
+static void     stdio_close(zh_storage_t* st);
+static uint8_t  mmap_open(zh_storage_t* st, const char* path);
+static uint32_t mem_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);
+static void     mmap_close(zh_storage_t* st);
+static uint8_t  ram_open(zh_storage_t* st, const char* path);
+static void     ram_close(zh_storage_t* st);
+static uint8_t  flash_open(zh_storage_t* st, const char* path);
+static uint32_t flash_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);
+static void     flash_close(zh_storage_t* st);
+#if (USE_ZH_EMBED_TABLES == 1)
+static uint8_t  embed_open(zh_storage_t* st, const char* path);
+#endif
+
+const zh_storage_backend_t zh_storage_stdio = { "stdio", stdio_open, stdio_read_at, stdio_close };
+const zh_storage_backend_t zh_storage_mmap  = { "mmap",  mmap_open,  mem_read_at,   mmap_close };
+const zh_storage_backend_t zh_storage_ram   = { "ram",   ram_open,   mem_read_at,   ram_close };
+const zh_storage_backend_t zh_storage_flash = { "flash", flash_open, flash_read_at, flash_close };
+
+#if (USE_ZH_EMBED_TABLES == 1)
+const zh_storage_backend_t zh_storage_embed = { "embed", embed_open, mem_read_at,   ram_close };
+#define STORAGE_DEFAULT_BACKEND     (&zh_storage_embed)
+
+/* generated by tools/zh_embed_gen.c */
+extern const zh_storage_embed_file_t zh_storage_embed_files[];
+extern const uint16_t zh_storage_embed_file_num;
+#else
+#define STORAGE_DEFAULT_BACKEND     (&zh_storage_stdio)
+#endif
+
+static const zh_storage_backend_t* storage_backend = STORAGE_DEFAULT_BACKEND;
+static uint32_t storage_reads = 0, storage_bytes = 0;   /* reads passed to backends (not mapped) */
+
+static __ram_blob_t ram_blob[ZH_STORAGE_RAM_BLOB_NUM];
+static uint8_t      ram_blob_num = 0;
+
+/* flash simulation : backend under it, latency of each read and transfer speed */
+static const zh_storage_backend_t* flash_lower = &zh_storage_stdio;
+static uint32_t flash_latency_us   = 50;
+static uint32_t flash_bytes_per_us = 4;
+static uint32_t flash_reads = 0, flash_bytes = 0, flash_wait_us = 0;
+
+static uint8_t stdio_open(zh_storage_t* st, const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return 1;
+    long sz = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) sz = ftell(fp);
+    if (sz < 0) {
+        fclose(fp);
+        return 1;
+    }
+    st->handle = fp;
+    st->data = NULL;
+    st->size = (uint32_t)sz;
+    return 0;
+}
+
+static uint32_t stdio_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len) {
+    FILE* fp = (FILE*)st->handle;
+    if (fseek(fp, (long)offset, SEEK_SET)) return 0;
+    return (uint32_t)fread(buf, sizeof(uint8_t), len, fp);
+}
+
+static void stdio_close(zh_storage_t* st) {
+    fclose((FILE*)st->handle);
+}
+
+/* read of mapped file and RAM blob, handle is the address of file content */
+static uint32_t mem_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len) {
+    memcpy(buf, (const uint8_t*)st->handle + offset, len);
+    return len;
+}
+
+static uint8_t mmap_open(zh_storage_t* st, const char* path) {
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return 1;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0 || sz.QuadPart > UINT32_MAX) {
+        CloseHandle(f);
+        return 1;
+    }
+    /* the view keeps the mapping and file opened */
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);
+    void* p = (m != NULL) ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (m != NULL) CloseHandle(m);
+    if (p == NULL) return 1;
+    st->size = (uint32_t)sz.QuadPart;
+#elif defined(ZH_STORAGE_POSIX_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 1;
+    struct stat s;
+    if (fstat(fd, &s) != 0 || s.st_size == 0 || (uint64_t)s.st_size > UINT32_MAX) {
+        close(fd);
+        return 1;
+    }
+    void* p = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return 1;
+    st->size = (uint32_t)s.st_size;
+#else
+    (void)path;
+    ZH_LOG_WARNING("mmap storage is not supported on this platform");
+    return 1;
+#endif
+    st->handle = p;
+    st->data = (const uint8_t*)p;
+    return 0;
+}
+
+static void mmap_close(zh_storage_t* st) {
+#if defined(_WIN32)
+    UnmapViewOfFile(st->handle);
+#elif defined(ZH_STORAGE_POSIX_MMAP)
+    munmap(st->handle, st->size);
+#else
+    (void)st;
+#endif
+}
+
+static uint8_t ram_open(zh_storage_t* st, const char* path) {
+    for (uint8_t i = 0; i < ram_blob_num; i++) {
+        if (strcmp(ram_blob[i].path, path) != 0) continue;
+        st->handle = (void*)ram_blob[i].data;
+        st->data = ram_blob[i].data;
+        st->size = ram_blob[i].size;
+        return 0;
+    }
+    return 1;
+}
+
+static void ram_close(zh_storage_t* st) {
+    (void)st;  /* blob is owned by the one registered it */
+}
+
+#if (USE_ZH_EMBED_TABLES == 1)
+/* files not linked into binary are not opened, there's no file system behind it */
+static uint8_t embed_open(zh_storage_t* st, const char* path) {
+    for (uint16_t i = 0; i < zh_storage_embed_file_num; i++) {
+        if (strcmp(zh_storage_embed_files[i].path, path) != 0) continue;
+        st->handle = (void*)zh_storage_embed_files[i].data;
+        st->data = zh_storage_embed_files[i].data;
+        st->size = zh_storage_embed_files[i].size;
+        return 0;
+    }
+    return 1;
+}
+#endif
+
+/* the file is opened by lower backend, and never mapped so that all reads pass the flash */
+static uint8_t flash_open(zh_storage_t* st, const char* path) {
+    if (flash_lower == NULL || flash_lower == &zh_storage_flash || flash_lower->open(st, path)) return 1;
+    st->data = NULL;
+    return 0;
+}
+
+static uint32_t flash_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len) {
+    uint32_t n = flash_lower->read_at(st, offset, buf, len);
+    uint32_t us = flash_latency_us + (flash_bytes_per_us ? n / flash_bytes_per_us : 0);
+    flash_reads++;
+    flash_bytes += n;
+    flash_wait_us += us;
+    /* busy wait, resolution is limited by clock() of platform */
+    clock_t end = clock() + (clock_t)((double)us * CLOCKS_PER_SEC / 1000000.0);
+    while (clock() < end);
+    return n;
+}
+
+static void flash_close(zh_storage_t* st) {
+    flash_lower->close(st);
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief set the backend used by zh_storage_open() (NULL restores the default : stdio, or embed)
+ * @note  set it before decoder contexts are inited and tables are loaded
+ */
+void zh_storage_set_backend(const zh_storage_backend_t* be) {
+    storage_backend = (be != NULL) ? be : STORAGE_DEFAULT_BACKEND;
+}
+
+/* get the backend used by zh_storage_open() */
+const zh_storage_backend_t* zh_storage_get_backend(void) {
+    return storage_backend;
+}
+
+/**
+ * @brief open file by the backend set by zh_storage_set_backend()
+ * @return 0: success, 1: file not exist
+ */
+uint8_t zh_storage_open(zh_storage_t* st, const char* path) {
+    return zh_storage_open_with(st, storage_backend, path);
+}
+
+/**
+ * @brief open file by the backend given
+ * @return 0: success, 1: file not exist
+ */
+uint8_t zh_storage_open_with(zh_storage_t* st, const zh_storage_backend_t* be, const char* path) {
+    if (st == NULL) return 1;
+    st->be = NULL;
+    st->handle = NULL;
+    st->data = NULL;
+    st->size = 0;
+    st->tag = 0;
+    if (be == NULL || path == NULL || be->open(st, path)) return 1;
+    st->be = be;
+    return 0;
+}
+
+/**
+ * @brief read len bytes at offset of file (the part out of file is not read)
+ * @return number of bytes read
+ */
+uint32_t zh_storage_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len) {
+    if (st == NULL || st->be == NULL || offset >= st->size) return 0;
+    if (len > st->size - offset) len = st->size - offset;
+    if (st->data != NULL) {
+        memcpy(buf, st->data + offset, len);
+        return len;
+    }
+    storage_reads++;
+    storage_bytes += len;
+    return st->be->read_at(st, offset, buf, len);
+}
+
+/**
+ * @brief get the whole file content if the backend maps it
+ * @return address of file content, NULL if it can only be read by zh_storage_read_at()
+ */
+const uint8_t* zh_storage_map(const zh_storage_t* st) {
+    return (st != NULL) ? st->data : NULL;
+}
+
+/* close the file, st can be opened again */
+void zh_storage_close(zh_storage_t* st) {
+    if (st == NULL || st->be == NULL) return;
+    st->be->close(st);
+    st->be = NULL;
+    st->handle = NULL;
+    st->data = NULL;
+    st->size = 0;
+}
+
+/**
+ * @brief get the statistics of reads since last zh_storage_stat_reset()
+ * @param reads  number of reads passed to backends (reads of mapped files are not counted)
+ * @param bytes  bytes requested by these reads
+ */
+void zh_storage_stat(uint32_t* reads, uint32_t* bytes) {
+    if (reads) *reads = storage_reads;
+    if (bytes) *bytes = storage_bytes;
+}
+
+/* clear the statistics of reads */
+void zh_storage_stat_reset(void) {
+    storage_reads = storage_bytes = 0;
+}
+
+/**
+ * @brief read the whole file into a buffer allocated by zh_buffer_malloc
+ * @param data  buffer of file content, free it by zh_buffer_free
+ * @return 0: success, 1: file not exist, empty or malloc failed
+ */
+uint8_t zh_storage_load(const char* path, uint8_t** data, uint32_t* size) {
+    zh_storage_t st;
+    *data = NULL;
+    if (zh_storage_open(&st, path)) return 1;
+    uint8_t* buf = (st.size > 0) ? zh_buffer_malloc(st.size) : NULL;
+    if (buf == NULL || zh_storage_read_at(&st, 0, buf, st.size) != st.size) {
+        if (buf) zh_buffer_free(buf);
+        zh_storage_close(&st);
+        return 1;
+    }
+    *data = buf;
+    *size = st.size;
+    zh_storage_close(&st);
+    return 0;
+}
+
+/**
+ * @brief register a blob (in RAM or ROM) as the content of path for RAM backend
+ * @note  path and data are not copied, they must be valid until zh_storage_ram_clear().
+ *        registering the same path again replaces the blob
+ * @return 0: success, 1: too many blobs
+ */
+uint8_t zh_storage_ram_add(const char* path, const uint8_t* data, uint32_t size) {
+    if (path == NULL || data == NULL) return 1;
+    for (uint8_t i = 0; i < ram_blob_num; i++) {
+        if (strcmp(ram_blob[i].path, path) == 0) {
+            ram_blob[i].data = data;
+            ram_blob[i].size = size;
+            return 0;
+        }
+    }
+    if (ram_blob_num >= ZH_STORAGE_RAM_BLOB_NUM) return 1;
+    ram_blob[ram_blob_num++] = (__ram_blob_t){ path, data, size };
+    return 0;
+}
+
+/* remove all blobs of RAM backend (close the files opened from them before) */
+void zh_storage_ram_clear(void) {
+    ram_blob_num = 0;
+}
+
+/**
+ * @brief set the simulated flash, each read waits latency_us + len / bytes_per_us microseconds
+ * @param lower        backend that holds the files (NULL: stdio)
+ * @param bytes_per_us transfer speed (0: no transfer time)
+ * @note  statistics are cleared
+ */
+void zh_storage_flash_config(const zh_storage_backend_t* lower, uint32_t latency_us, uint32_t bytes_per_us) {
+    flash_lower = (lower != NULL && lower != &zh_storage_flash) ? lower : &zh_storage_stdio;
+    flash_latency_us = latency_us;
+    flash_bytes_per_us = bytes_per_us;
+    flash_reads = flash_bytes = flash_wait_us = 0;
+}
+
+/**
+ * @brief get the statistics of simulated flash since last zh_storage_flash_config()
+ * @param reads   number of reads
+ * @param bytes   bytes transferred
+ * @param wait_us simulated time of all reads
+ */
+void zh_storage_flash_stat(uint32_t* reads, uint32_t* bytes, uint32_t* wait_us) {
+    if (reads) *reads = flash_reads;
+    if (bytes) *bytes = flash_bytes;
+    if (wait_us) *wait_us = flash_wait_us;
+}
@@ -0,0 +1,99 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_storage.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-13  (last modified)
+ * @brief          : storage backend interface of table and dictionary files
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * all files of decoder (code table, dictionary, resident tables) are read by
+ * path through a storage backend, which gives read_at(offset, len) and may
+ * also map the whole file into address space (st->data is not NULL), then
+ * readers use the mapped bytes directly instead of copying them.
+ *
+ * shipped backends :
+ *   zh_storage_stdio  : fopen / fseek / fread (default)
+ *   zh_storage_mmap   : mmap (posix) or file mapping (windows) of the file
+ *   zh_storage_ram    : blobs in RAM or ROM, registered by zh_storage_ram_add()
+ *   zh_storage_flash  : simulated slow flash, forwards reads to another backend
+ *                       and waits for the latency and transfer time of each read
+ *   zh_storage_embed  : files linked into binary as const arrays (build option
+ *                       ZH_EMBED_TABLES, USE_ZH_EMBED_TABLES), default backend
+ *                       when enabled, no file system is needed
+ *
+ * reads of backends without mapping can be cached in RAM blocks by the
+ * cache backend (zh_storage_cache.h, option USE_ZH_STORAGE_CACHE).
+ *
+ * for other file systems (FATFS etc.), define a zh_storage_backend_t with
+ * open / read_at / close and pass it to zh_storage_set_backend() before the
+ * decoder is used, no decoder function needs to be changed.
+ *****************************************************************************
+ */
+#ifndef __ZH_STORAGE_H
+#define __ZH_STORAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+
+#define ZH_STORAGE_RAM_BLOB_NUM     8       /* max number of blobs registered to RAM backend */
+
+struct zh_storage_backend_t;
+
+/* opened file of a storage backend */
+typedef struct zh_storage_t {
+    const struct zh_storage_backend_t* be;  /* backend opened the file (NULL: not opened) */
+    void*          handle;                  /* file handle of backend */
+    const uint8_t* data;                    /* whole file mapped in address space (NULL: use read_at) */
+    uint32_t       size;                    /* size of file */
+    uint16_t       tag;                     /* file id of the cache backend (0: not cached) */
+}zh_storage_t;
+
+/* file linked into binary, the table is generated by tools/zh_embed_gen.c */
+typedef struct {
+    const char*    path;                    /* path the decoder opens it by */
+    const uint8_t* data;
+    uint32_t       size;
+}zh_storage_embed_file_t;
+
+/* storage backend, open() fills handle, data and size of st */
+typedef struct zh_storage_backend_t {
+    const char* name;
+    uint8_t  (*open)(zh_storage_t* st, const char* path);                            /* 0: success, 1: fail */
+    uint32_t (*read_at)(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);  /* bytes read */
+    void     (*close)(zh_storage_t* st);
+}zh_storage_backend_t;
+
+extern const zh_storage_backend_t zh_storage_stdio;
+extern const zh_storage_backend_t zh_storage_mmap;
+extern const zh_storage_backend_t zh_storage_ram;
+extern const zh_storage_backend_t zh_storage_flash;
+extern const zh_storage_backend_t zh_storage_embed;    /* only when USE_ZH_EMBED_TABLES is 1 */
+
+void zh_storage_set_backend(const zh_storage_backend_t* be);
+const zh_storage_backend_t* zh_storage_get_backend(void);
+
+uint8_t  zh_storage_open(zh_storage_t* st, const char* path);
+uint8_t  zh_storage_open_with(zh_storage_t* st, const zh_storage_backend_t* be, const char* path);
+uint32_t zh_storage_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);
+const uint8_t* zh_storage_map(const zh_storage_t* st);
+void     zh_storage_close(zh_storage_t* st);
+void     zh_storage_stat(uint32_t* reads, uint32_t* bytes);
+void     zh_storage_stat_reset(void);
+uint8_t  zh_storage_load(const char* path, uint8_t** data, uint32_t* size);
+
+uint8_t  zh_storage_ram_add(const char* path, const uint8_t* data, uint32_t size);
+void     zh_storage_ram_clear(void);
+
+void     zh_storage_flash_config(const zh_storage_backend_t* lower, uint32_t latency_us, uint32_t bytes_per_us);
+void     zh_storage_flash_stat(uint32_t* reads, uint32_t* bytes, uint32_t* wait_us);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
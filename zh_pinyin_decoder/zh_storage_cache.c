@@ -0,0 +1,273 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_storage_cache.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-14  (last modified)
+ * @brief          : block cache of storage reads
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the pool is one buffer of the budget : block data, block states, then the
+ * hash buckets of (file, block number). blocks of a bucket are chained by
+ * index, so finding a block is one hash and a short chain walk. for LRU the
+ * blocks are also in a list ordered by use (a hit moves the block to the
+ * newest end, the oldest one is evicted). for CLOCK a hit only sets the
+ * referenced bit, and the hand gives referenced blocks a second chance.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_storage_cache.h"
+
+#if (USE_ZH_STORAGE_CACHE == 1)
+
+#define CACHE_NONE      0xFFFF
+
+typedef struct {
+    uint32_t block;     /* block number in file */
+    uint16_t len;       /* valid bytes of block (shorter at the end of file) */
+    uint16_t next;      /* next block of the same bucket (CACHE_NONE : end) */
+    uint16_t newer;     /* LRU list : block used after this one (CACHE_NONE : the newest) */
+    uint16_t older;     /* LRU list : block used before this one (CACHE_NONE : the oldest) */
+    uint8_t  file;      /* tag of file (0 : empty block) */
+    uint8_t  ref;       /* referenced since last pass of clock hand (CLOCK) */
+}__cache_block_t;
+
+/************************   private functions   *********************************/
+
+static uint8_t  cache_open(zh_storage_t* st, const char* path);
+static uint32_t cache_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len);
+static void     cache_close(zh_storage_t* st);
+
+const zh_storage_backend_t zh_storage_cache = { "cache", cache_open, cache_read_at, cache_close };
+
+static const zh_storage_backend_t* cache_lower = &zh_storage_stdio;
+static uint8_t*         cache_pool = NULL;     /* the whole budget */
+static uint8_t*         cache_data = NULL;     /* data of blocks */
+static __cache_block_t* cache_blk = NULL;
+static uint16_t*        cache_bucket = NULL;
+static uint16_t         cache_num = 0;         /* number of blocks */
+static uint8_t          cache_bits = 0;        /* number of buckets is (1 << cache_bits) */
+static uint8_t          cache_policy = ZH_STORAGE_CACHE_LRU;
+static uint16_t         cache_used = 0;        /* blocks [0, cache_used) have been filled since clear */
+static uint16_t         cache_hand = 0;        /* clock hand */
+static uint16_t         cache_newest = CACHE_NONE, cache_oldest = CACHE_NONE;  /* ends of LRU list */
+static uint32_t         cache_hit = 0, cache_miss = 0, cache_fetched = 0;
+
+static const char*      cache_path[ZH_STORAGE_CACHE_FILE_NUM];   /* path of file tag (i + 1) */
+static uint8_t          cache_path_num = 0;
+
+static uint32_t cache_hash(uint8_t file, uint32_t block) {
+    return ((block ^ ((uint32_t)file << 24)) * 2654435761u) >> (32 - cache_bits);
+}
+
+/* remove block i from its bucket */
+static void cache_unlink(uint16_t i) {
+    uint16_t* p = &cache_bucket[cache_hash(cache_blk[i].file, cache_blk[i].block)];
+    while (*p != i) p = &cache_blk[*p].next;
+    *p = cache_blk[i].next;
+    cache_blk[i].file = 0;
+}
+
+/* remove block i from LRU list */
+static void lru_remove(uint16_t i) {
+    __cache_block_t* b = &cache_blk[i];
+    if (b->newer != CACHE_NONE) cache_blk[b->newer].older = b->older;
+    else cache_newest = b->older;
+    if (b->older != CACHE_NONE) cache_blk[b->older].newer = b->newer;
+    else cache_oldest = b->newer;
+}
+
+/* insert block i at the newest end of LRU list */
+static void lru_push(uint16_t i) {
+    cache_blk[i].newer = CACHE_NONE;
+    cache_blk[i].older = cache_newest;
+    if (cache_newest != CACHE_NONE) cache_blk[cache_newest].newer = i;
+    else cache_oldest = i;
+    cache_newest = i;
+}
+
+/* get the block to replace (taken out of its bucket and LRU list) : an unused block, or by the eviction policy */
+static uint16_t cache_victim(void) {
+    uint16_t i;
+    if (cache_used < cache_num) return cache_used++;
+    if (cache_policy == ZH_STORAGE_CACHE_CLOCK) {
+        for (;;) {
+            i = cache_hand;
+            cache_hand = (cache_hand + 1 == cache_num) ? 0 : cache_hand + 1;
+            if (cache_blk[i].file == 0 || cache_blk[i].ref == 0) break;
+            cache_blk[i].ref = 0;    /* second chance */
+        }
+    }
+    else {
+        i = cache_oldest;
+        lru_remove(i);
+    }
+    if (cache_blk[i].file != 0) cache_unlink(i);
+    return i;
+}
+
+/**
+ * @brief get the cached block of file, fetch it from lower backend if missed
+ * @param len  valid bytes of block
+ * @return data of block, NULL if read error
+ */
+static const uint8_t* cache_get(zh_storage_t* st, uint32_t block, uint16_t* len) {
+    uint8_t  file = (uint8_t)st->tag;
+    uint32_t h = cache_hash(file, block);
+    uint16_t i = cache_bucket[h];
+    while (i != CACHE_NONE && (cache_blk[i].file != file || cache_blk[i].block != block)) i = cache_blk[i].next;
+    if (i != CACHE_NONE) {
+        cache_hit++;
+        cache_blk[i].ref = 1;
+        if (cache_policy == ZH_STORAGE_CACHE_LRU && cache_newest != i) {
+            lru_remove(i);
+            lru_push(i);
+        }
+        *len = cache_blk[i].len;
+        return cache_data + (uint32_t)i * ZH_STORAGE_CACHE_BLOCK_SZ;
+    }
+    cache_miss++;
+    i = cache_victim();
+    uint32_t pos = block * ZH_STORAGE_CACHE_BLOCK_SZ;
+    uint32_t n = st->size - pos;
+    if (n > ZH_STORAGE_CACHE_BLOCK_SZ) n = ZH_STORAGE_CACHE_BLOCK_SZ;
+    uint8_t* data = cache_data + (uint32_t)i * ZH_STORAGE_CACHE_BLOCK_SZ;
+    n = cache_lower->read_at(st, pos, data, n);
+    cache_fetched += n;
+    cache_blk[i].file = 0;
+    if (cache_policy == ZH_STORAGE_CACHE_LRU) lru_push(i);
+    if (n == 0) return NULL;   /* the empty block is kept in LRU list, it's replaced later */
+    cache_blk[i].block = block;
+    cache_blk[i].len = (uint16_t)n;
+    cache_blk[i].next = cache_bucket[h];
+    cache_blk[i].file = file;
+    cache_blk[i].ref = 1;
+    cache_bucket[h] = i;
+    *len = (uint16_t)n;
+    return data;
+}
+
+/* the file is opened by lower backend, and tagged by path if lower backend doesn't map it */
+static uint8_t cache_open(zh_storage_t* st, const char* path) {
+    if (cache_lower->open(st, path)) return 1;
+    if (st->data != NULL) return 0;
+    ZH_STORAGE_CACHE_LOCK();
+    uint8_t i = 0;
+    while (i < cache_path_num && strcmp(cache_path[i], path) != 0) i++;
+    if (i == cache_path_num && cache_path_num < ZH_STORAGE_CACHE_FILE_NUM) cache_path[cache_path_num++] = path;
+    st->tag = (i < cache_path_num) ? i + 1 : 0;    /* too many files : not cached */
+    ZH_STORAGE_CACHE_UNLOCK();
+    return 0;
+}
+
+static uint32_t cache_read_at(zh_storage_t* st, uint32_t offset, void* buf, uint32_t len) {
+    uint32_t done = 0;
+    ZH_STORAGE_CACHE_LOCK();
+    if (st->tag == 0 || cache_num == 0 || len > (uint32_t)cache_num * ZH_STORAGE_CACHE_BLOCK_SZ / 2) {
+        done = cache_lower->read_at(st, offset, buf, len);
+        cache_fetched += done;
+    }
+    else while (done < len) {
+        uint32_t pos = offset + done;
+        uint16_t in = pos % ZH_STORAGE_CACHE_BLOCK_SZ, blen;
+        const uint8_t* p = cache_get(st, pos / ZH_STORAGE_CACHE_BLOCK_SZ, &blen);
+        if (p == NULL || in >= blen) break;
+        uint32_t n = __min((uint32_t)(blen - in), len - done);
+        memcpy((uint8_t*)buf + done, p + in, n);
+        done += n;
+    }
+    ZH_STORAGE_CACHE_UNLOCK();
+    return done;
+}
+
+static void cache_close(zh_storage_t* st) {
+    cache_lower->close(st);
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief allocate the block pool and set the backend under the cache
+ * @note  call it at init before zh_storage_set_backend(&zh_storage_cache), the pool is allocated
+ *        by zh_buffer_malloc. a block takes ZH_STORAGE_CACHE_BLOCK_SZ + 16 bytes of budget
+ * @param lower   backend holding the files (NULL: stdio)
+ * @param budget  RAM of the whole pool in bytes
+ * @param policy  eviction policy (ZH_STORAGE_CACHE_LRU or ZH_STORAGE_CACHE_CLOCK)
+ * @return 0: success, 1: budget is smaller than one block or malloc failed
+ */
+uint8_t zh_storage_cache_init(const zh_storage_backend_t* lower, uint32_t budget, uint8_t policy) {
+    zh_storage_cache_deinit();
+    uint32_t cost = ZH_STORAGE_CACHE_BLOCK_SZ + sizeof(__cache_block_t) + 2 * sizeof(uint16_t);
+    uint32_t num = __min(budget / cost, (uint32_t)CACHE_NONE - 1);
+    if (num == 0) return 1;
+    uint8_t bits = 1;
+    while ((1u << bits) < num) bits++;
+    uint8_t* pool = zh_buffer_malloc(num * (ZH_STORAGE_CACHE_BLOCK_SZ + sizeof(__cache_block_t)) + (sizeof(uint16_t) << bits));
+    if (pool == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        return 1;
+    }
+    ZH_STORAGE_CACHE_LOCK();
+    cache_lower = (lower != NULL && lower != &zh_storage_cache) ? lower : &zh_storage_stdio;
+    cache_policy = policy;
+    cache_pool = pool;
+    cache_data = pool;
+    cache_blk = (__cache_block_t*)(pool + num * ZH_STORAGE_CACHE_BLOCK_SZ);
+    cache_bucket = (uint16_t*)(cache_blk + num);
+    cache_num = (uint16_t)num;
+    cache_bits = bits;
+    cache_path_num = 0;
+    ZH_STORAGE_CACHE_UNLOCK();
+    zh_storage_cache_clear();
+    zh_storage_cache_stat_reset();
+    return 0;
+}
+
+/**
+ * @brief free the block pool, files opened by the cache backend read the lower backend directly
+ * @note  the files must be closed before, if the lower backend is changed by next zh_storage_cache_init()
+ */
+void zh_storage_cache_deinit(void) {
+    ZH_STORAGE_CACHE_LOCK();
+    if (cache_pool != NULL) zh_buffer_free(cache_pool);
+    cache_pool = cache_data = NULL;
+    cache_blk = NULL;
+    cache_bucket = NULL;
+    cache_num = 0;
+    ZH_STORAGE_CACHE_UNLOCK();
+}
+
+/**
+ * @brief drop all cached blocks (call it after the files are modified)
+ */
+void zh_storage_cache_clear(void) {
+    ZH_STORAGE_CACHE_LOCK();
+    if (cache_num > 0) {
+        memset(cache_blk, 0, sizeof(__cache_block_t) * cache_num);
+        memset(cache_bucket, 0xFF, sizeof(uint16_t) << cache_bits);
+    }
+    cache_used = 0;
+    cache_hand = 0;
+    cache_newest = cache_oldest = CACHE_NONE;
+    ZH_STORAGE_CACHE_UNLOCK();
+}
+
+/**
+ * @brief get the statistics since last zh_storage_cache_stat_reset() (or zh_storage_cache_init)
+ * @param hit      number of block lookups found in cache
+ * @param miss     number of block lookups fetched from lower backend
+ * @param fetched  bytes read from lower backend (missed blocks and bypassed reads)
+ */
+void zh_storage_cache_stat(uint32_t* hit, uint32_t* miss, uint32_t* fetched) {
+    if (hit) *hit = cache_hit;
+    if (miss) *miss = cache_miss;
+    if (fetched) *fetched = cache_fetched;
+}
+
+/* clear the statistics of cache */
+void zh_storage_cache_stat_reset(void) {
+    cache_hit = cache_miss = cache_fetched = 0;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_storage_cache.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-14  (last modified)
+ * @brief          : block cache of storage reads
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_STORAGE_CACHE is set to 1. the cache
+ * is a storage backend over another one (the lower backend, e.g. a slow flash),
+ * files are split into aligned blocks of ZH_STORAGE_CACHE_BLOCK_SZ bytes, and
+ * each read is served from the cached blocks, only the missed blocks are
+ * fetched from the lower backend. all files opened by the cache share one pool
+ * of blocks, so the code table and dictionary compete for the same RAM budget.
+ *
+ *   zh_storage_cache_init(&zh_storage_flash, 8 * 1024, ZH_STORAGE_CACHE_LRU);
+ *   zh_storage_set_backend(&zh_storage_cache);
+ *
+ * files are identified by path (the path string must be kept valid), so a
+ * file opened again (each call of a decoder function without kept context)
+ * still hits its blocks. reads larger than half of the pool bypass the cache
+ * (loading resident tables doesn't flush it). files of a mapping lower backend
+ * are read in place and never cached.
+ *
+ * the pool is shared by all decoder contexts, define ZH_STORAGE_CACHE_LOCK()
+ * and ZH_STORAGE_CACHE_UNLOCK() (e.g. by a mutex of RTOS) when contexts decode
+ * concurrently.
+ *****************************************************************************
+ */
+#ifndef __ZH_STORAGE_CACHE_H
+#define __ZH_STORAGE_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_storage.h"
+
+#if (USE_ZH_STORAGE_CACHE == 1)
+
+#define ZH_STORAGE_CACHE_FILE_NUM   8       /* max number of different files cached */
+
+/**
+* @defgroup storage_cache_policy
+*/
+#define ZH_STORAGE_CACHE_LRU        0       /** evict the least recently used block */
+#define ZH_STORAGE_CACHE_CLOCK      1       /** evict by clock (second chance), no stamp update on hit */
+
+#ifndef ZH_STORAGE_CACHE_LOCK
+#define ZH_STORAGE_CACHE_LOCK()     do{}while(0)
+#define ZH_STORAGE_CACHE_UNLOCK()   do{}while(0)
+#endif
+
+extern const zh_storage_backend_t zh_storage_cache;
+
+uint8_t zh_storage_cache_init(const zh_storage_backend_t* lower, uint32_t budget, uint8_t policy);
+void zh_storage_cache_deinit(void);
+void zh_storage_cache_clear(void);
+void zh_storage_cache_stat(uint32_t* hit, uint32_t* miss, uint32_t* fetched);
+void zh_storage_cache_stat_reset(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -0,0 +1,451 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_user_dict.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : runtime user dictionary (sorted overlay of word dictionary)
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * an edit is applied to the overlay first, then appended to the log and
+ * flushed, so a power loss only loses the last record (a torn record at the
+ * end of log is dropped when it's opened again, and the log is rewritten).
+ * compaction writes a snapshot of the overlay to a temporary file without
+ * lock, then under lock appends the records logged meanwhile and renames it
+ * over the log.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_user_dict.h"
+
+#if (USE_ZH_USER_DICT == 1)
+
+#define USER_LOG_TMP_FILE_NAME  ZH_USER_DICT_FILE_NAME ".tmp"
+#define USER_LOG_REC_MAX_SZ     (ZH_USER_DICT_REC_HDR_SZ + ZH_WORD_DICT_KEY_MAX_LEN + 3 * MAX_WORD_LENGTH)
+
+/**
+* @defgroup user_log_op
+*/
+#define USER_LOG_OP_INSERT      'I'
+#define USER_LOG_OP_DELETE      'D'
+#define USER_LOG_OP_BOOST       'B'
+
+/************************   private functions   *********************************/
+
+static uint8_t  weight_add(uint8_t a, uint8_t b);
+static uint8_t  user_word_check(const char* key, const char* word);
+static int      user_word_cmp(const __user_word_t* u, const char* key, uint8_t key_len, const char* word, uint8_t word_len);
+static uint16_t user_word_find(const char* key, uint8_t key_len, const char* word, uint8_t word_len, uint8_t* found);
+static uint8_t  user_word_apply(uint8_t op, uint8_t value, const char* key, const char* word);
+static void     user_boost_update(void);
+static uint8_t  user_word_edit(uint8_t op, uint8_t value, const char* key, const char* word);
+static uint8_t  log_record(uint8_t* buf, uint8_t op, uint8_t value, const char* key, const char* word);
+static void     log_append(uint8_t op, uint8_t value, const char* key, const char* word);
+static uint32_t log_replay(FILE* fp, uint32_t* num);
+static uint32_t log_snapshot(uint8_t* buf);
+static uint8_t  log_copy_tail(FILE* fp, uint32_t from);
+
+static __user_word_t user_word[ZH_USER_DICT_MAX_WORDS];
+static uint16_t user_num = 0;
+static uint32_t user_gen = 0;          /* changed on each edit */
+static uint8_t  user_boost = 0;        /* max weight added to a word of dictionary */
+
+static FILE*    log_fp = NULL;         /* opened log (NULL : edits are kept in RAM only) */
+static uint32_t log_size = 0;          /* bytes of valid records (with header) */
+static uint32_t log_num = 0;           /* number of records */
+static uint8_t  log_torn = 0;          /* log ends with a torn record, nothing is appended until it's compacted */
+static uint8_t  log_busy = 0;          /* compaction is running */
+
+/* add a + b, saturated at 255 */
+static uint8_t weight_add(uint8_t a, uint8_t b) {
+    return (a + b > UINT8_MAX) ? UINT8_MAX : (uint8_t)(a + b);
+}
+
+/**
+ * @brief check key is 2 ~ MAX_WORD_LENGTH syllables of lower case letters seperated by single ' ',
+ *        and word has one zh character (3 bytes of utf-8) for each syllable
+ * @return 0: valid, 1: invalid
+ */
+static uint8_t user_word_check(const char* key, const char* word) {
+    if (key == NULL || word == NULL) return 1;
+    size_t kl = strlen(key), wl = strlen(word);
+    if (kl == 0 || kl > ZH_WORD_DICT_KEY_MAX_LEN) return 1;
+    uint8_t syl = 1, len = 0;
+    for (size_t i = 0; i < kl; i++) {
+        if (key[i] == ' ') {
+            if (len == 0) return 1;
+            syl++;
+            len = 0;
+        }
+        else if (key[i] >= 'a' && key[i] <= 'z') {
+            if (++len > MAX_WORD_CODE_LENGTH) return 1;
+        }
+        else return 1;
+    }
+    if (len == 0 || syl < 2 || syl > MAX_WORD_LENGTH || wl != 3 * (size_t)syl) return 1;
+    for (size_t i = 0; i < wl; i += 3) {
+        if (((uint8_t)word[i] & 0xF0) != 0xE0) return 1;
+    }
+    return 0;
+}
+
+/* compare word u with (key, word) given by length, in the order of strcmp */
+static int user_word_cmp(const __user_word_t* u, const char* key, uint8_t key_len, const char* word, uint8_t word_len) {
+    int c = strncmp(u->key, key, key_len);
+    if (c == 0) c = (u->key[key_len] != '\0');   /* key of u is longer */
+    if (c == 0) c = strncmp(u->word, word, word_len);
+    if (c == 0) c = (u->word[word_len] != '\0');
+    return c;
+}
+
+/**
+ * @brief binary search (key, word) in overlay
+ * @param found 1 : word is found at the index returned
+ * @return index of the first word not less than (key, word)
+ */
+static uint16_t user_word_find(const char* key, uint8_t key_len, const char* word, uint8_t word_len, uint8_t* found) {
+    uint16_t lo = 0, hi = user_num;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (user_word_cmp(&user_word[mid], key, key_len, word, word_len) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    *found = (lo < user_num && user_word_cmp(&user_word[lo], key, key_len, word, word_len) == 0);
+    return lo;
+}
+
+/**
+ * @brief apply an edit (refer to @defgroup user_log_op) to overlay, key and word are checked
+ * @return 0: applied, 1: overlay is full or a deleted word is boosted
+ */
+static uint8_t user_word_apply(uint8_t op, uint8_t value, const char* key, const char* word) {
+    uint8_t kl = (uint8_t)strlen(key), wl = (uint8_t)strlen(word), found;
+    uint16_t i = user_word_find(key, kl, word, wl, &found);
+    __user_word_t* u = &user_word[i];
+    if (!found) {
+        if (user_num >= ZH_USER_DICT_MAX_WORDS) {
+            ZH_LOG_WARNING("user dictionary is full");
+            return 1;
+        }
+        memmove(u + 1, u, sizeof(__user_word_t) * (user_num - i));
+        user_num++;
+        memcpy(u->key, key, kl + 1);
+        memcpy(u->word, word, wl + 1);
+        u->type = (op == USER_LOG_OP_INSERT) ? ZH_USER_WORD_ADD : (op == USER_LOG_OP_BOOST) ? ZH_USER_WORD_BOOST : ZH_USER_WORD_DEL;
+        u->value = (op == USER_LOG_OP_DELETE) ? 0 : value;
+    }
+    else if (op == USER_LOG_OP_INSERT) {
+        u->type = ZH_USER_WORD_ADD;
+        u->value = value;
+    }
+    else if (op == USER_LOG_OP_DELETE) {
+        u->type = ZH_USER_WORD_DEL;
+        u->value = 0;
+    }
+    else {
+        if (u->type == ZH_USER_WORD_DEL) return 1;
+        u->value = weight_add(u->value, value);
+    }
+    user_boost_update();
+    user_gen++;
+    return 0;
+}
+
+/* find the max weight added by boosted words */
+static void user_boost_update(void) {
+    user_boost = 0;
+    for (uint16_t i = 0; i < user_num; i++) {
+        if (user_word[i].type == ZH_USER_WORD_BOOST && user_word[i].value > user_boost) user_boost = user_word[i].value;
+    }
+}
+
+/* check and apply an edit, then append it to log */
+static uint8_t user_word_edit(uint8_t op, uint8_t value, const char* key, const char* word) {
+    if (user_word_check(key, word)) {
+        ZH_LOG_WARNING("invalid user word");
+        return 1;
+    }
+    ZH_USER_DICT_LOCK();
+    uint8_t res = user_word_apply(op, value, key, word);
+    if (res == 0) log_append(op, value, key, word);
+    ZH_USER_DICT_UNLOCK();
+    return res;
+}
+
+/* write a log record to buf, return its size */
+static uint8_t log_record(uint8_t* buf, uint8_t op, uint8_t value, const char* key, const char* word) {
+    uint8_t kl = (uint8_t)strlen(key), wl = (uint8_t)strlen(word);
+    buf[0] = op;
+    buf[1] = value;
+    buf[2] = kl;
+    buf[3] = wl;
+    memcpy(buf + ZH_USER_DICT_REC_HDR_SZ, key, kl);
+    memcpy(buf + ZH_USER_DICT_REC_HDR_SZ + kl, word, wl);
+    return ZH_USER_DICT_REC_HDR_SZ + kl + wl;
+}
+
+/* append an edit to log and flush it, the log is marked torn when it's not fully written */
+static void log_append(uint8_t op, uint8_t value, const char* key, const char* word) {
+    if (log_fp == NULL || log_torn) return;
+    uint8_t rec[USER_LOG_REC_MAX_SZ];
+    uint8_t n = log_record(rec, op, value, key, word);
+    if (fwrite(rec, 1, n, log_fp) != n || fflush(log_fp) != 0) {
+        ZH_LOG_WARNING("write user dictionary log failed");
+        log_torn = 1;
+        return;
+    }
+    log_size += n;
+    log_num++;
+}
+
+/**
+ * @brief apply the records of log (after header) to overlay
+ * @param num number of valid records
+ * @return bytes of valid records (with header), reading stops at the first torn or invalid record
+ */
+static uint32_t log_replay(FILE* fp, uint32_t* num) {
+    uint8_t rec[USER_LOG_REC_MAX_SZ];
+    char key[ZH_WORD_DICT_KEY_MAX_LEN + 1], word[3 * MAX_WORD_LENGTH + 1];
+    uint32_t size = ZH_USER_DICT_HDR_SZ;
+    *num = 0;
+    while (fread(rec, 1, ZH_USER_DICT_REC_HDR_SZ, fp) == ZH_USER_DICT_REC_HDR_SZ) {
+        uint8_t op = rec[0], kl = rec[2], wl = rec[3];
+        if (kl > ZH_WORD_DICT_KEY_MAX_LEN || wl > 3 * MAX_WORD_LENGTH) break;
+        if (fread(rec + ZH_USER_DICT_REC_HDR_SZ, 1, kl + wl, fp) != (size_t)(kl + wl)) break;
+        memcpy(key, rec + ZH_USER_DICT_REC_HDR_SZ, kl);
+        key[kl] = '\0';
+        memcpy(word, rec + ZH_USER_DICT_REC_HDR_SZ + kl, wl);
+        word[wl] = '\0';
+        if ((op != USER_LOG_OP_INSERT && op != USER_LOG_OP_DELETE && op != USER_LOG_OP_BOOST) ||
+            user_word_check(key, word)) {
+            break;
+        }
+        user_word_apply(op, rec[1], key, word);
+        size += ZH_USER_DICT_REC_HDR_SZ + kl + wl;
+        (*num)++;
+    }
+    return size;
+}
+
+/* write header and one record of each word to buf (ZH_USER_DICT_HDR_SZ + user_num * USER_LOG_REC_MAX_SZ bytes), return its size */
+static uint32_t log_snapshot(uint8_t* buf) {
+    memcpy(buf, ZH_USER_DICT_MAGIC, 4);
+    buf[4] = ZH_USER_DICT_VERSION;
+    buf[5] = buf[6] = buf[7] = 0;
+    uint32_t size = ZH_USER_DICT_HDR_SZ;
+    for (uint16_t i = 0; i < user_num; i++) {
+        const __user_word_t* u = &user_word[i];
+        uint8_t op = (u->type == ZH_USER_WORD_ADD) ? USER_LOG_OP_INSERT : (u->type == ZH_USER_WORD_BOOST) ? USER_LOG_OP_BOOST : USER_LOG_OP_DELETE;
+        size += log_record(buf + size, op, u->value, u->key, u->word);
+    }
+    return size;
+}
+
+/* append the log [from, log_size) to fp, return 0: succeed */
+static uint8_t log_copy_tail(FILE* fp, uint32_t from) {
+    FILE* in = fopen(ZH_USER_DICT_FILE_NAME, "rb");
+    if (in == NULL) return 1;
+    uint8_t buf[64], res = (fseek(in, (long)from, SEEK_SET) != 0);
+    for (uint32_t n = log_size - from; n > 0 && !res; ) {
+        size_t k = (n > sizeof(buf)) ? sizeof(buf) : n;
+        res = (fread(buf, 1, k, in) != k || fwrite(buf, 1, k, fp) != k);
+        n -= (uint32_t)k;
+    }
+    fclose(in);
+    return res;
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief open the log of user dictionary (created if not exist), the overlay is rebuilt from it
+ * @note  a torn record at the end (power loss when writing) is dropped and the log is compacted
+ * @return 0: succeed, 1: log can't be opened or is invalid (edits are kept in RAM only)
+ */
+uint8_t zh_user_dict_open(void) {
+    ZH_USER_DICT_LOCK();
+    if (log_fp != NULL) {
+        ZH_USER_DICT_UNLOCK();
+        return 0;
+    }
+    user_num = 0;
+    user_boost = 0;
+    user_gen++;
+    log_torn = 0;
+    FILE* fp = fopen(ZH_USER_DICT_FILE_NAME, "rb");
+    if (fp != NULL) {
+        uint8_t hdr[ZH_USER_DICT_HDR_SZ];
+        if (fread(hdr, 1, ZH_USER_DICT_HDR_SZ, fp) != ZH_USER_DICT_HDR_SZ ||
+            memcmp(hdr, ZH_USER_DICT_MAGIC, 4) != 0 || hdr[4] != ZH_USER_DICT_VERSION) {
+            ZH_LOG_ERROR("invalid user dictionary log file");
+            fclose(fp);
+            ZH_USER_DICT_UNLOCK();
+            return 1;
+        }
+        log_size = log_replay(fp, &log_num);
+        log_torn = (fseek(fp, 0, SEEK_END) != 0 || ftell(fp) != (long)log_size);
+        fclose(fp);
+        log_fp = fopen(ZH_USER_DICT_FILE_NAME, "ab");
+    }
+    else {
+        uint8_t hdr[ZH_USER_DICT_HDR_SZ];
+        log_fp = fopen(ZH_USER_DICT_FILE_NAME, "wb");
+        if (log_fp != NULL && (fwrite(hdr, 1, log_snapshot(hdr), log_fp) != ZH_USER_DICT_HDR_SZ || fflush(log_fp) != 0)) {
+            fclose(log_fp);
+            log_fp = NULL;
+        }
+        log_size = ZH_USER_DICT_HDR_SZ;
+        log_num = 0;
+    }
+    uint8_t torn = log_torn, res = (log_fp == NULL);
+    if (res) ZH_LOG_WARNING("open user dictionary log failed, edits are kept in RAM only");
+    ZH_USER_DICT_UNLOCK();
+    if (!res && torn) res = zh_user_dict_compact();
+    return res;
+}
+
+/* close the log, the overlay is cleared */
+void zh_user_dict_close(void) {
+    ZH_USER_DICT_LOCK();
+    if (log_fp != NULL) fclose(log_fp);
+    log_fp = NULL;
+    user_num = 0;
+    user_boost = 0;
+    user_gen++;
+    ZH_USER_DICT_UNLOCK();
+}
+
+/**
+ * @brief add a user word, or set the weight of a user word
+ * @param key    pinyin of each character seperated by ' ' ("ni hao"), 2 ~ MAX_WORD_LENGTH syllables
+ * @param word   utf-8 text ("你好")
+ * @param weight weight of word (refer to zh_word_weight(), words of dictionary weigh 0 ~ 239)
+ * @return 0: succeed, 1: invalid word or overlay is full
+ */
+uint8_t zh_user_dict_insert(const char* key, const char* word, uint8_t weight) {
+    return user_word_edit(USER_LOG_OP_INSERT, weight, key, word);
+}
+
+/**
+ * @brief delete a word, the word is hidden from both user words and dictionary
+ * @return 0: succeed, 1: invalid word or overlay is full
+ */
+uint8_t zh_user_dict_delete(const char* key, const char* word) {
+    return user_word_edit(USER_LOG_OP_DELETE, 0, key, word);
+}
+
+/**
+ * @brief add delta to the weight of a word (user word or word of dictionary), saturated at 255
+ * @return 0: succeed, 1: invalid word, overlay is full or the word is deleted
+ */
+uint8_t zh_user_dict_boost(const char* key, const char* word, uint8_t delta) {
+    return user_word_edit(USER_LOG_OP_BOOST, delta, key, word);
+}
+
+/* 1: the log is torn, or has much more records than words (call zh_user_dict_compact() when idle) */
+uint8_t zh_user_dict_need_compact(void) {
+    ZH_USER_DICT_LOCK();
+    uint8_t res = (log_fp != NULL && !log_busy && (log_torn || log_num > 2 * (uint32_t)user_num + ZH_USER_DICT_COMPACT_SLACK));
+    ZH_USER_DICT_UNLOCK();
+    return res;
+}
+
+/**
+ * @brief rewrite the log with one record of each word
+ * @note  the snapshot is written without lock (lookups and edits go on), the records logged
+ *        meanwhile are appended to it before it replaces the log. a torn log is rewritten
+ *        under lock, since nothing can be appended to it.
+ * @return 0: succeed, 1: failed (the old log is kept), or no log is opened
+ */
+uint8_t zh_user_dict_compact(void) {
+    ZH_USER_DICT_LOCK();
+    if (log_fp == NULL || log_busy) {
+        ZH_USER_DICT_UNLOCK();
+        return 1;
+    }
+    uint8_t* buf = (uint8_t*)zh_buffer_malloc(ZH_USER_DICT_HDR_SZ + (uint32_t)user_num * USER_LOG_REC_MAX_SZ);
+    if (buf == NULL) {
+        ZH_USER_DICT_UNLOCK();
+        return 1;
+    }
+    uint32_t len = log_snapshot(buf);
+    uint32_t from = log_size, from_num = log_num;
+    uint16_t num = user_num;
+    uint8_t  torn = log_torn;
+    log_busy = 1;
+    if (!torn) ZH_USER_DICT_UNLOCK();
+
+    FILE* fp = fopen(USER_LOG_TMP_FILE_NAME, "wb");
+    uint8_t res = (fp == NULL || fwrite(buf, 1, len, fp) != len);
+    zh_buffer_free(buf);
+
+    if (!torn) ZH_USER_DICT_LOCK();
+    if (!res && log_torn != torn) res = 1;   /* torn while writing snapshot */
+    if (!res && log_size > from) res = log_copy_tail(fp, from);
+    if (fp != NULL && fclose(fp) != 0) res = 1;
+    if (!res) {
+        fclose(log_fp);
+        log_fp = NULL;
+        if (rename(USER_LOG_TMP_FILE_NAME, ZH_USER_DICT_FILE_NAME) != 0) {
+            remove(ZH_USER_DICT_FILE_NAME);   /* rename doesn't replace existing file on windows */
+            res = (rename(USER_LOG_TMP_FILE_NAME, ZH_USER_DICT_FILE_NAME) != 0);
+        }
+        if (res) {
+            ZH_LOG_ERROR("replace user dictionary log failed, edits are kept in RAM only");
+        }
+        else {
+            log_fp = fopen(ZH_USER_DICT_FILE_NAME, "ab");
+            if (log_fp == NULL) ZH_LOG_WARNING("open user dictionary log failed, edits are kept in RAM only");
+            log_size = len + (log_size - from);
+            log_num = num + (log_num - from_num);
+            log_torn = 0;
+        }
+    }
+    else {
+        remove(USER_LOG_TMP_FILE_NAME);
+        ZH_LOG_WARNING("compact user dictionary log failed");
+    }
+    log_busy = 0;
+    ZH_USER_DICT_UNLOCK();
+    return res;
+}
+
+/* number of words in overlay (deleted and boosted words included) */
+uint16_t zh_user_dict_num(void) {
+    return user_num;
+}
+
+/* generation of overlay, it's changed on each edit (results matched with an older generation are stale) */
+uint32_t zh_user_dict_gen(void) {
+    return user_gen;
+}
+
+/* max weight added to a word of dictionary by boosted words (0 if no word is boosted) */
+uint8_t zh_user_dict_boost_max(void) {
+    return user_boost;
+}
+
+/* words of overlay sorted by (key, word) */
+const __user_word_t* zh_user_dict_words(uint16_t* num) {
+    *num = user_num;
+    return user_word;
+}
+
+/**
+ * @brief apply overlay to a word of dictionary (key and word are not terminated)
+ * @param wt weight of word, the delta of boosted word is added
+ * @return 1: word is deleted or replaced by user word (it should be dropped), 0: keep it
+ */
+uint8_t zh_user_dict_filter(const char* key, uint8_t key_len, const char* word, uint8_t word_len, uint8_t* wt) {
+    uint8_t found;
+    uint16_t i = user_word_find(key, key_len, word, word_len, &found);
+    if (!found) return 0;
+    if (user_word[i].type == ZH_USER_WORD_BOOST) {
+        *wt = weight_add(*wt, user_word[i].value);
+        return 0;
+    }
+    return 1;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_user_dict.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : runtime user dictionary (sorted overlay of word dictionary)
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_USER_DICT is set to 1. words inserted,
+ * deleted or boosted at runtime are kept in a small sorted array in RAM, and
+ * zh_match_word merges it with the word dictionary (which is never modified) :
+ *
+ *   user word    : word with its own weight, replaces the same word of dictionary
+ *   boosted word : weight is added to the same word of dictionary
+ *   deleted word : the same word of dictionary is hidden
+ *
+ * each edit is appended to a log file (ZH_USER_DICT_FILE_NAME) opened by
+ * zh_user_dict_open(), which replays the log at start. without log the edits
+ * are only kept in RAM. the log grows with edits, call zh_user_dict_compact()
+ * when the input method is idle (zh_user_dict_need_compact() tells when it's
+ * worth it) to rewrite it with one record per word, the file is written without
+ * lock, so decoding and edits go on while compacting.
+ *
+ *   log file : magic(4) | version(1) | reserved(3) | records
+ *   record   : op(1) | value(1) | key_len(1) | word_len(1) | key | word
+ *
+ * the overlay is shared by all decoder contexts, define ZH_USER_DICT_LOCK() and
+ * ZH_USER_DICT_UNLOCK() (e.g. by a mutex of RTOS) when words are edited while
+ * other threads decode. the decoder holds the lock only while it looks up the
+ * overlay, never across reads of the dictionary file.
+ *****************************************************************************
+ */
+#ifndef __ZH_USER_DICT_H
+#define __ZH_USER_DICT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_word_dict.h"
+
+#if (USE_ZH_USER_DICT == 1)
+
+#define ZH_USER_DICT_MAX_WORDS      256     /* max number of words in overlay (~46 bytes each) */
+#define ZH_USER_DICT_COMPACT_SLACK  64      /* compact when log has this number of records more than 2 * words */
+
+#define ZH_USER_DICT_MAGIC          "ZHUD"
+#define ZH_USER_DICT_VERSION        1
+#define ZH_USER_DICT_HDR_SZ         8
+#define ZH_USER_DICT_REC_HDR_SZ     4
+
+/**
+* @defgroup user_word_type
+*/
+#define ZH_USER_WORD_ADD            0       /** user word, value is its weight */
+#define ZH_USER_WORD_BOOST          1       /** word of dictionary, value is added to its weight */
+#define ZH_USER_WORD_DEL            2       /** word of dictionary is hidden */
+
+#ifndef ZH_USER_DICT_LOCK
+#define ZH_USER_DICT_LOCK()         do{}while(0)
+#define ZH_USER_DICT_UNLOCK()       do{}while(0)
+#endif
+
+/* word of overlay, words are sorted by (key, word) */
+typedef struct {
+    char     key[ZH_WORD_DICT_KEY_MAX_LEN + 1];  /* pinyin seperated by ' ' */
+    char     word[3 * MAX_WORD_LENGTH + 1];     /* utf-8 text */
+    uint8_t  type;                   /* refer to @defgroup user_word_type */
+    uint8_t  value;                  /* weight of user word, or weight added */
+}__user_word_t;
+
+uint8_t zh_user_dict_open(void);
+void zh_user_dict_close(void);
+uint8_t zh_user_dict_insert(const char* key, const char* word, uint8_t weight);
+uint8_t zh_user_dict_delete(const char* key, const char* word);
+uint8_t zh_user_dict_boost(const char* key, const char* word, uint8_t delta);
+uint8_t zh_user_dict_need_compact(void);
+uint8_t zh_user_dict_compact(void);
+uint16_t zh_user_dict_num(void);
+uint32_t zh_user_dict_gen(void);
+uint8_t zh_user_dict_boost_max(void);
+
+/* used by decoder, call them between ZH_USER_DICT_LOCK() and ZH_USER_DICT_UNLOCK() */
+const __user_word_t* zh_user_dict_words(uint16_t* num);
+uint8_t zh_user_dict_filter(const char* key, uint8_t key_len, const char* word, uint8_t word_len, uint8_t* wt);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
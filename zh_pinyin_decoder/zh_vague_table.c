@@ -0,0 +1,111 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_vague_table.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-03  (last modified)
+ * @brief          : precomputed vague match result table
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the whole table (about 40kb for default code table) is kept in RAM after
+ * zh_vague_table_load() in zh_pinyin_decoder.c.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_vague_table.h"
+
+/************************   private functions   *********************************/
+
+static uint16_t rd_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/************************   public functions   *********************************/
+
+/* FNV-1a hash of prefix */
+uint32_t zh_vague_hash(const char* str, uint8_t len) {
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < len; i++) {
+        h ^= (uint8_t)str[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief parse the table file content into vt (slots, entries and data are copied)
+ * @param file  content of "zh_vague.bin"
+ * @param size  size of file
+ * @return 0: success, 1: invalid file or malloc failed
+ */
+uint8_t zh_vague_table_read(const uint8_t* file, uint32_t size, __vague_table_t* vt) {
+    memset(vt, 0, sizeof(__vague_table_t));
+    if (size < ZH_VAGUE_HEADER_SZ || memcmp(file + ZH_VAGUE_HDR_MAGIC, ZH_VAGUE_MAGIC, 4) != 0 ||
+        rd_u16(file + ZH_VAGUE_HDR_VERSION) != ZH_VAGUE_VERSION) return 1;
+    uint16_t slot_num = rd_u16(file + ZH_VAGUE_HDR_SLOT_NUM);
+    uint16_t prefix_num = rd_u16(file + ZH_VAGUE_HDR_PREFIX_NUM);
+    uint32_t data_sz = rd_u32(file + ZH_VAGUE_HDR_DATA_SZ);
+    uint32_t entry_off = ZH_VAGUE_HEADER_SZ + 2 * (uint32_t)slot_num;
+    uint32_t data_off = entry_off + ZH_VAGUE_ENTRY_SZ * (uint32_t)prefix_num;
+    if (slot_num == 0 || (slot_num & (slot_num - 1)) || prefix_num >= slot_num || data_off + data_sz != size) return 1;
+
+    vt->slots = zh_buffer_malloc(sizeof(uint16_t) * slot_num);
+    vt->entries = zh_buffer_malloc(sizeof(__vague_entry_t) * prefix_num);
+    vt->data = zh_buffer_malloc(data_sz ? data_sz : 1);
+    if (vt->slots == NULL || vt->entries == NULL || vt->data == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_vague_table_free(vt);
+        return 1;
+    }
+    for (uint16_t i = 0; i < slot_num; i++) {
+        vt->slots[i] = rd_u16(file + ZH_VAGUE_HEADER_SZ + 2 * i);
+        if (vt->slots[i] > prefix_num) {
+            zh_vague_table_free(vt);
+            return 1;
+        }
+    }
+    for (uint16_t i = 0; i < prefix_num; i++) {
+        const uint8_t* e = file + entry_off + ZH_VAGUE_ENTRY_SZ * i;
+        memcpy(vt->entries[i].key, e, ZH_VAGUE_KEY_SZ);
+        vt->entries[i].count = e[ZH_VAGUE_KEY_SZ];
+        vt->entries[i].offset = rd_u32(e + ZH_VAGUE_KEY_SZ + 2);
+        if (vt->entries[i].offset + 3 * (uint32_t)vt->entries[i].count > data_sz) {
+            zh_vague_table_free(vt);
+            return 1;
+        }
+    }
+    memcpy(vt->data, file + data_off, data_sz);
+    vt->slot_num = slot_num;
+    vt->prefix_num = prefix_num;
+    vt->data_sz = data_sz;
+    return 0;
+}
+
+/* free the table read by zh_vague_table_read */
+void zh_vague_table_free(__vague_table_t* vt) {
+    if (vt->slots)   zh_buffer_free(vt->slots);
+    if (vt->entries) zh_buffer_free(vt->entries);
+    if (vt->data)    zh_buffer_free(vt->data);
+    memset(vt, 0, sizeof(__vague_table_t));
+}
+
+/**
+ * @brief find the entry of prefix str
+ * @return entry pointer, NULL if str is not a syllable prefix (or table not read)
+ */
+const __vague_entry_t* zh_vague_table_find(const __vague_table_t* vt, const char* str) {
+    size_t len = strlen(str);
+    if (vt->slots == NULL || len == 0 || len > ZH_VAGUE_KEY_SZ) return NULL;
+    uint16_t mask = vt->slot_num - 1;
+    for (uint16_t i = zh_vague_hash(str, (uint8_t)len) & mask; vt->slots[i] != 0; i = (i + 1) & mask) {
+        const __vague_entry_t* e = &vt->entries[vt->slots[i] - 1];
+        if (strncmp(e->key, str, ZH_VAGUE_KEY_SZ) == 0) return e;
+    }
+    return NULL;
+}
@@ -0,0 +1,77 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_vague_table.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-03  (last modified)
+ * @brief          : precomputed vague match result table definition header file
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_VAGUE_TABLE is set to 1. the table
+ * "zh_vague.bin" is generated by tools/zh_vague_compile.c, it keeps the whole
+ * vague match result of each syllable prefix ("s", "sh", "zho", ...), so that
+ * zh_match_code_vague is one hash lookup and one copy. all numbers are stored
+ * in little endian.
+ *
+ *   header  : ZH_VAGUE_HEADER_SZ bytes (see below)
+ *   slots   : slot_num * uint16, open addressing hash slots (entry index + 1, 0: empty)
+ *   entries : prefix_num * ZH_VAGUE_ENTRY_SZ bytes, key[6] | count(1) | reserved(1) | offset(4)
+ *   data    : utf-8 characters (3 bytes each) of all entries
+ *
+ * characters of an entry are in the layout of zh_match_code_vague result (the
+ * most frequent one is the last), and the result of num characters is just
+ * the last num characters of the entry.
+ *
+ * @warning regenerate the .bin file after modifying the code table or the
+ *          vague match settings in zh_pinyin_decoder.h
+ *****************************************************************************
+ */
+#ifndef __ZH_VAGUE_TABLE_H
+#define __ZH_VAGUE_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+
+#define ZH_VAGUE_MAGIC          "ZHVG"
+#define ZH_VAGUE_VERSION        1
+#define ZH_VAGUE_KEY_SZ         6       /* max prefix length (zhuang) */
+
+/** header layout (offset in bytes) */
+#define ZH_VAGUE_HDR_MAGIC      0       /* char[4]  magic "ZHVG"        */
+#define ZH_VAGUE_HDR_VERSION    4       /* uint16   format version      */
+#define ZH_VAGUE_HDR_SLOT_NUM   6       /* uint16   number of slots (power of 2) */
+#define ZH_VAGUE_HDR_PREFIX_NUM 8       /* uint16   number of prefixes  */
+#define ZH_VAGUE_HDR_RESERVED   10      /* uint16   reserved (0)        */
+#define ZH_VAGUE_HDR_DATA_SZ    12      /* uint32   bytes of data       */
+#define ZH_VAGUE_HEADER_SZ      16
+#define ZH_VAGUE_ENTRY_SZ       12
+
+typedef struct {
+    char     key[ZH_VAGUE_KEY_SZ];  /* prefix (zero padded) */
+    uint8_t  count;                 /* number of characters */
+    uint32_t offset;                /* offset of characters in data */
+}__vague_entry_t;
+
+typedef struct {
+    uint16_t slot_num;
+    uint16_t prefix_num;
+    uint16_t* slots;
+    __vague_entry_t* entries;
+    uint8_t* data;
+    uint32_t data_sz;
+}__vague_table_t;
+
+uint32_t zh_vague_hash(const char* str, uint8_t len);
+uint8_t zh_vague_table_read(const uint8_t* file, uint32_t size, __vague_table_t* vt);
+void zh_vague_table_free(__vague_table_t* vt);
+const __vague_entry_t* zh_vague_table_find(const __vague_table_t* vt, const char* str);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
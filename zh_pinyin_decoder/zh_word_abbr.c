@@ -0,0 +1,101 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_abbr.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-09  (last modified)
+ * @brief          : initial letters (abbreviation) index of word dictionary keys
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * for abbreviated input ("nhsj", "bjdx") every piece is a single letter, so
+ * the prefix scan would go over the whole region of the first letter. the
+ * index gives the few keys with these initials by one binary search.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_word_abbr.h"
+
+/************************   private functions   *********************************/
+
+/* read uint32 array in little endian from file, stride is the bytes between two numbers */
+static uint8_t read_u32_array(zh_storage_t* st, uint32_t loc, uint32_t stride, uint32_t* arr, uint32_t num) {
+    uint8_t tmp[256];
+    uint32_t per = sizeof(tmp) / stride;
+    for (uint32_t i = 0; i < num;) {
+        uint32_t n = num - i > per ? per : num - i;
+        if (zh_storage_read_at(st, loc + stride * i, tmp, stride * n) != stride * n) return 1;
+        for (uint32_t j = 0; j < n; j++, i++) {
+            arr[i] = zh_word_dict_u32(tmp + stride * j);
+        }
+    }
+    return 0;
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief read abbreviation index of dictionary into RAM
+ * @param st    opened dictionary file
+ * @param info  dictionary information (read by zh_word_dict_info)
+ * @param abbr  index to fill, free it by zh_word_abbr_free
+ * @return 0: success, 1: no index in file or malloc failed
+ */
+uint8_t zh_word_abbr_read(zh_storage_t* st, const __word_dict_info_t* info, __word_abbr_t* abbr) {
+    memset(abbr, 0, sizeof(__word_abbr_t));
+    if (info->abbr_num == 0 || info->abbr_key_num == 0) return 1;
+    abbr->code  = zh_buffer_malloc((size_t)info->abbr_num * sizeof(uint32_t));
+    abbr->start = zh_buffer_malloc((size_t)(info->abbr_num + 1) * sizeof(uint32_t));
+    abbr->keys  = zh_buffer_malloc((size_t)info->abbr_key_num * sizeof(uint32_t));
+    if (abbr->code == NULL || abbr->start == NULL || abbr->keys == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_word_abbr_free(abbr);
+        return 1;
+    }
+    /* groups are (code, start) pairs, then the key indexes */
+    uint32_t keys_off = info->abbr_off + 8 * info->abbr_num;
+    if (read_u32_array(st, info->abbr_off, 8, abbr->code, info->abbr_num) ||
+        read_u32_array(st, info->abbr_off + 4, 8, abbr->start, info->abbr_num) ||
+        read_u32_array(st, keys_off, 4, abbr->keys, info->abbr_key_num)) {
+        zh_word_abbr_free(abbr);
+        return 1;
+    }
+    abbr->start[info->abbr_num] = info->abbr_key_num;
+    abbr->num = info->abbr_num;
+    abbr->key_num = info->abbr_key_num;
+    return 0;
+}
+
+/* free the index read by zh_word_abbr_read */
+void zh_word_abbr_free(__word_abbr_t* abbr) {
+    if (abbr->code)  zh_buffer_free(abbr->code);
+    if (abbr->start) zh_buffer_free(abbr->start);
+    if (abbr->keys)  zh_buffer_free(abbr->keys);
+    memset(abbr, 0, sizeof(__word_abbr_t));
+}
+
+/**
+ * @brief get the keys with the initials of split method
+ * @param str  input string
+ * @param m    split method of str
+ * @param num  number of keys
+ * @return key indexes in increasing order (NULL if no key)
+ */
+const uint32_t* zh_word_abbr_find(const __word_abbr_t* abbr, const char* str, const __split_method_t* m, uint32_t* num) {
+    *num = 0;
+    if (m->length > ZH_WORD_DICT_ABBR_MAX_LEN) return NULL;
+    char initials[ZH_WORD_DICT_ABBR_MAX_LEN];
+    initials[0] = str[0];
+    for (uint8_t i = 1; i < m->length; i++) initials[i] = str[m->spm[i - 1]];
+    uint32_t code = zh_word_abbr_code(initials, m->length);
+
+    uint32_t lo = 0, hi = abbr->num;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (abbr->code[mid] < code) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == abbr->num || abbr->code[lo] != code) return NULL;
+    *num = abbr->start[lo + 1] - abbr->start[lo];
+    return abbr->keys + abbr->start[lo];
+}
@@ -0,0 +1,48 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_abbr.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-09  (last modified)
+ * @brief          : initial letters (abbreviation) index of word dictionary keys
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_WORD_ABBR is set to 1. the index is
+ * stored in "zh_word_dict.bin" (see zh_word_dict.h), and loaded into RAM
+ * by zh_word_abbr_load(), which takes about 120kb RAM for default dictionary.
+ *
+ * every key matching a split method has the first letters of the pieces as
+ * its initials ("nihsj" split as "ni'h's'j" -> "nhsj"), so one probe gives
+ * all the keys a method can match, in record order.
+ *****************************************************************************
+ */
+#ifndef __ZH_WORD_ABBR_H
+#define __ZH_WORD_ABBR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_word_dict.h"
+
+typedef struct {
+    uint32_t  num;              /* number of groups */
+    uint32_t* code;             /* code of initials of each group (sorted) */
+    uint32_t* start;            /* first key of each group in keys, start[num] = key_num */
+    uint32_t  key_num;          /* number of keys in index */
+    uint32_t* keys;             /* key indexes grouped by initials */
+}__word_abbr_t;
+
+uint8_t zh_word_abbr_read(zh_storage_t* st, const __word_dict_info_t* info, __word_abbr_t* abbr);
+void zh_word_abbr_free(__word_abbr_t* abbr);
+
+const uint32_t* zh_word_abbr_find(const __word_abbr_t* abbr, const char* str, const __split_method_t* m, uint32_t* num);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
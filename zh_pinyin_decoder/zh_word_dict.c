@@ -0,0 +1,197 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_dict.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-09-28  (last modified)
+ * @brief          : compiled binary word dictionary reader
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * only the bytes a query needs are read : header at open, O(log n) keys for
+ * locating the first candidate, then the records of candidate keys.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_word_dict.h"
+
+/************************   private functions   *********************************/
+
+/**
+ * @brief get the size of record in buffer
+ * @param rec   record start
+ * @param avail bytes available after rec
+ * @return size of the record, 0 if the record is not complete in buffer
+ */
+static uint16_t record_size(const uint8_t* rec, uint16_t avail) {
+    uint16_t sz = 1;
+    if (avail < 2) return 0;
+    sz += rec[0];                      /* key */
+    if (sz >= avail) return 0;
+    uint8_t word_num = rec[sz++];
+    for (uint8_t i = 0; i < word_num; i++) {
+        if (sz >= avail) return 0;
+        sz += 2 + rec[sz];
+    }
+    return sz <= avail ? sz : 0;
+}
+
+/* get record offset (from file start) of key index */
+static uint8_t record_loc(zh_storage_t* st, const __word_dict_info_t* info, uint32_t key_idx, uint32_t* loc) {
+    uint8_t tmp[4];
+    if (zh_storage_read_at(st, info->index_off + 4 * key_idx, tmp, 4) != 4) return 1;
+    *loc = info->record_off + zh_word_dict_u32(tmp);
+    return 0;
+}
+
+/**
+ * @brief fill the view of cursor with the records from key_idx (at file location pos)
+ * @note  mapped file is viewed without copy, otherwise at most ZH_WORD_DICT_WINDOW_KEYS records
+ *        are read, so that a slow storage doesn't transfer the whole buffer for a few records
+ * @return number of bytes in view
+ */
+static uint16_t cursor_fill(__word_dict_cursor_t* cur, uint32_t pos, uint32_t key_idx) {
+    const uint8_t* map = zh_storage_map(cur->st);
+    uint32_t len = cur->buf_sz, end;
+    cur->buf_pos = pos;
+    if (map != NULL) {
+        uint32_t left = (pos < cur->st->size) ? cur->st->size - pos : 0;
+        cur->view = map + pos;
+        cur->buf_len = (uint16_t)(left < len ? left : len);
+        return cur->buf_len;
+    }
+    if (key_idx + ZH_WORD_DICT_WINDOW_KEYS < cur->info->key_num &&
+        record_loc(cur->st, cur->info, key_idx + ZH_WORD_DICT_WINDOW_KEYS, &end) == 0 && end > pos && end - pos < len) {
+        len = end - pos;
+    }
+    cur->view = cur->buf;
+    cur->buf_len = (uint16_t)zh_storage_read_at(cur->st, pos, cur->buf, len);
+    return cur->buf_len;
+}
+
+/************************   public functions   *********************************/
+
+/* read a little endian uint32 */
+uint32_t zh_word_dict_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief read and check the header of dictionary file
+ * @param st   opened dictionary file
+ * @param info dictionary information to fill
+ * @return 0: success, 1: not a valid dictionary file
+ */
+uint8_t zh_word_dict_info(zh_storage_t* st, __word_dict_info_t* info) {
+    uint8_t hdr[ZH_WORD_DICT_HEADER_SZ];
+    if (st == NULL || info == NULL) return 1;
+    if (zh_storage_read_at(st, 0, hdr, sizeof(hdr)) != sizeof(hdr)) return 1;
+    if (memcmp(hdr + ZH_WORD_DICT_HDR_MAGIC, ZH_WORD_DICT_MAGIC, 4) != 0) return 1;
+    if ((hdr[ZH_WORD_DICT_HDR_VERSION] | (hdr[ZH_WORD_DICT_HDR_VERSION + 1] << 8)) != ZH_WORD_DICT_VERSION) return 1;
+
+    info->key_num    = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_KEY_NUM);
+    info->index_off  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_INDEX);
+    info->record_off = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_RECORD);
+    info->file_size  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_SIZE);
+    for (int i = 0; i < 27; i++) {
+        info->letter_first[i] = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_LETTER + 4 * i);
+    }
+    info->syl_off   = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_SYL);
+    info->syl_num   = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_SYL_NUM);
+    info->trie_off  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_TRIE);
+    info->trie_size = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_TRIE_SIZE);
+    info->abbr_off  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_ABBR);
+    info->abbr_num  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_ABBR_NUM);
+    info->abbr_key_num = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_ABBR_KEYS);
+    info->bound_off  = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_BOUND);
+    info->max_weight = zh_word_dict_u32(hdr + ZH_WORD_DICT_HDR_MAX_WEIGHT);
+    return 0;
+}
+
+/**
+ * @brief binary search the first key >= key in [lo, hi)
+ * @note  only the compared part of key is used, so that it can be used for finding
+ *        the first key start with a prefix.
+ * @return index of the first key (hi if all keys are smaller)
+ */
+uint32_t zh_word_dict_lower_bound(zh_storage_t* st, const __word_dict_info_t* info, const char* key, uint8_t len, uint32_t lo, uint32_t hi) {
+    uint8_t rec[ZH_WORD_DICT_KEY_MAX_LEN + 1];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2, loc;
+        if (record_loc(st, info, mid, &loc) || zh_storage_read_at(st, loc, rec, sizeof(rec)) == 0) return hi;
+        uint8_t kl = rec[0] > ZH_WORD_DICT_KEY_MAX_LEN ? ZH_WORD_DICT_KEY_MAX_LEN : rec[0];
+        int res = memcmp(rec + 1, key, kl < len ? kl : len);
+        if (res < 0 || (res == 0 && kl < len)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief binary search the first key in [lo, hi) which is larger than all keys start with key[0, len)
+ * @note  [zh_word_dict_lower_bound(), zh_word_dict_upper_bound()) is the range of keys with the prefix
+ * @return index of the first larger key (hi if no key is larger)
+ */
+uint32_t zh_word_dict_upper_bound(zh_storage_t* st, const __word_dict_info_t* info, const char* key, uint8_t len, uint32_t lo, uint32_t hi) {
+    uint8_t rec[ZH_WORD_DICT_KEY_MAX_LEN + 1];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2, loc;
+        if (record_loc(st, info, mid, &loc) || zh_storage_read_at(st, loc, rec, sizeof(rec)) == 0) return hi;
+        uint8_t kl = rec[0] > ZH_WORD_DICT_KEY_MAX_LEN ? ZH_WORD_DICT_KEY_MAX_LEN : rec[0];
+        if (memcmp(rec + 1, key, kl < len ? kl : len) <= 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief locate the cursor at record key_idx
+ * @note  cur->st, cur->info, cur->buf and cur->buf_sz must be set before
+ * @return 0: success, 1: read error
+ */
+uint8_t zh_word_dict_seek(__word_dict_cursor_t* cur, uint32_t key_idx) {
+    uint32_t loc;
+    cur->key_idx = key_idx;
+    cur->ptr = 0;
+    cur->buf_len = 0;
+    if (key_idx >= cur->info->key_num) return 0;
+    if (record_loc(cur->st, cur->info, key_idx, &loc)) return 1;
+    return cursor_fill(cur, loc, key_idx) == 0;
+}
+
+/**
+ * @brief get the next record of cursor
+ * @return record pointer (valid until next call), NULL if reach the end or read error
+ */
+const uint8_t* zh_word_dict_next(__word_dict_cursor_t* cur) {
+    if (cur->key_idx >= cur->info->key_num) return NULL;
+    uint16_t sz = record_size(cur->view + cur->ptr, cur->buf_len - cur->ptr);
+    if (sz == 0) {
+        /* record is cut by buffer end, re-read from the record start */
+        uint32_t pos = cur->buf_pos + cur->ptr;
+        cur->ptr = 0;
+        sz = record_size(cur->view, cursor_fill(cur, pos, cur->key_idx));
+        if (sz == 0) return NULL;
+    }
+    const uint8_t* rec = cur->view + cur->ptr;
+    cur->ptr += sz;
+    cur->key_idx++;
+    return rec;
+}
+
+/**
+ * @brief get the record of key_idx by cursor (random access)
+ * @note  the record is read from buffer if it's already in buffer
+ * @return record pointer (valid until next call), NULL if read error
+ */
+const uint8_t* zh_word_dict_record(__word_dict_cursor_t* cur, uint32_t key_idx) {
+    if (key_idx >= cur->info->key_num) return NULL;
+    if (key_idx < cur->key_idx || key_idx > cur->key_idx + 8 || cur->buf_len == 0) {
+        if (zh_word_dict_seek(cur, key_idx)) return NULL;
+    }
+    /* near records are skipped in buffer instead of re-reading */
+    while (cur->key_idx < key_idx) {
+        if (zh_word_dict_next(cur) == NULL) return NULL;
+    }
+    return zh_word_dict_next(cur);
+}
@@ -0,0 +1,155 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_dict.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-09-28  (last modified)
+ * @brief          : compiled binary word dictionary definition header file
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * the binary word dictionary "zh_word_dict.bin" is compiled from
+ * "zh_word_dict.json" by tools/zh_dict_compile.c, which path is specified
+ * in zh_pinyin_decoder.h. all numbers are stored in little endian.
+ *
+ *   header    : ZH_WORD_DICT_HEADER_SZ bytes (see below)
+ *   index     : key_num * uint32, offset of each record from record area start
+ *   records   : key_len(1) | key | word_num(1) | [word_len(1) | weight(1) | utf-8 word] * word_num
+ *   syllables : syl_num * char[ZH_WORD_DICT_SYL_SZ], sorted syllables used in keys
+ *   trie      : trie_size * int32 base, then trie_size * int32 check
+ *   abbr      : abbr_num * (uint32 code, uint32 start), then abbr_key_num * uint32 key index
+ *   bound     : key_num * uint8, max weight of the words of each key
+ *
+ * records are sorted by key (byte order), so keys with the same initial
+ * letter are continuous, and letter_first[] gives the first key of each letter.
+ *
+ * the trie is a double-array trie over keys as syllable id sequences. id of
+ * a syllable is (its index in sorted syllables + 1), id 0 marks the key end,
+ * and the end node stores -(key index + 1) in base. since syllables are sorted,
+ * walking children by increasing id gives keys in the record order.
+ *
+ * the abbreviation index groups keys by the initial letters of their syllables
+ * ("ni hao shi jie" -> "nhsj", code by zh_word_abbr_code()). groups are sorted
+ * by code, keys of group i are key index [start(i), start(i + 1)) in increasing
+ * order (the last group ends at abbr_key_num). keys with more than
+ * ZH_WORD_DICT_ABBR_MAX_LEN syllables are not in the index.
+ *
+ * weight of a word is its frequency in log scale (zh_word_weight(), 8 steps
+ * each doubling), the frequency is the number after the word in json array
+ * ("a a": ["\u554a\u554a", 12000]), words without it take ZH_WORD_WEIGHT_DEFAULT.
+ * word search keeps the heaviest words, the bounds of keys (and max weight of
+ * dictionary in header) tell when no more key can give a heavier word.
+ *
+ * @warning recompile the .bin file after modifying the json dictionary
+ *****************************************************************************
+ */
+#ifndef __ZH_WORD_DICT_H
+#define __ZH_WORD_DICT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_storage.h"
+
+#define ZH_WORD_DICT_MAGIC          "ZHWD"
+#define ZH_WORD_DICT_VERSION        4
+#define ZH_WORD_DICT_KEY_MAX_LEN    31      /* max length of key string, "zhuang zhuang zhuang zhuang" is 27 */
+#define ZH_WORD_DICT_SYL_SZ         8       /* size of each syllable in syllable table (zero padded) */
+#define ZH_WORD_DICT_ABBR_MAX_LEN   6       /* max syllables of key in abbreviation index (5 bits each in code) */
+#define ZH_WORD_DICT_WINDOW_KEYS    32      /* max records read by each fill of cursor buffer */
+#define ZH_WORD_WEIGHT_DEFAULT      71      /* weight of word without frequency, zh_word_weight(2000) (min frequency of webdict words) */
+
+/** header layout (offset in bytes) */
+#define ZH_WORD_DICT_HDR_MAGIC      0       /* char[4]     magic "ZHWD"              */
+#define ZH_WORD_DICT_HDR_VERSION    4       /* uint16      format version            */
+#define ZH_WORD_DICT_HDR_FLAGS      6       /* uint16      reserved (0)              */
+#define ZH_WORD_DICT_HDR_KEY_NUM    8       /* uint32      number of keys            */
+#define ZH_WORD_DICT_HDR_INDEX      12      /* uint32      offset of index table     */
+#define ZH_WORD_DICT_HDR_RECORD     16      /* uint32      offset of record area     */
+#define ZH_WORD_DICT_HDR_SIZE       20      /* uint32      file size                 */
+#define ZH_WORD_DICT_HDR_LETTER     24      /* uint32[27]  first key of letter a-z, [26] = key_num */
+#define ZH_WORD_DICT_HDR_SYL        132     /* uint32      offset of syllable table  */
+#define ZH_WORD_DICT_HDR_SYL_NUM    136     /* uint32      number of syllables       */
+#define ZH_WORD_DICT_HDR_TRIE       140     /* uint32      offset of trie            */
+#define ZH_WORD_DICT_HDR_TRIE_SIZE  144     /* uint32      number of trie units      */
+#define ZH_WORD_DICT_HDR_ABBR       148     /* uint32      offset of abbreviation index */
+#define ZH_WORD_DICT_HDR_ABBR_NUM   152     /* uint32      number of abbreviation groups */
+#define ZH_WORD_DICT_HDR_ABBR_KEYS  156     /* uint32      number of keys in abbreviation index */
+#define ZH_WORD_DICT_HDR_BOUND      160     /* uint32      offset of key weight bounds */
+#define ZH_WORD_DICT_HDR_MAX_WEIGHT 164     /* uint32      max weight of all words   */
+#define ZH_WORD_DICT_HEADER_SZ      168
+
+typedef struct {
+    uint32_t key_num;           /* number of keys              */
+    uint32_t index_off;         /* offset of index table       */
+    uint32_t record_off;        /* offset of record area       */
+    uint32_t file_size;         /* size of the whole file      */
+    uint32_t letter_first[27];  /* first key index of each letter */
+    uint32_t syl_off;           /* offset of syllable table    */
+    uint32_t syl_num;           /* number of syllables         */
+    uint32_t trie_off;          /* offset of trie              */
+    uint32_t trie_size;         /* number of trie units        */
+    uint32_t abbr_off;          /* offset of abbreviation index */
+    uint32_t abbr_num;          /* number of abbreviation groups */
+    uint32_t abbr_key_num;      /* number of keys in abbreviation index */
+    uint32_t bound_off;         /* offset of key weight bounds */
+    uint32_t max_weight;        /* max weight of all words     */
+}__word_dict_info_t;
+
+/* weight of word frequency : 8 * log2(freq) in integer (monotonic, 0 ~ 239) */
+static inline uint8_t zh_word_weight(uint32_t freq) {
+    if (freq < 8) return (uint8_t)freq;
+    uint8_t msb = 3;
+    while (freq >> (msb + 1)) msb++;
+    return (uint8_t)(8 * (msb - 2) + ((freq >> (msb - 3)) & 7));
+}
+
+/* code of initial letters (n letters, n <= ZH_WORD_DICT_ABBR_MAX_LEN), codes of different length never equal */
+static inline uint32_t zh_word_abbr_code(const char* initials, uint8_t n) {
+    uint32_t code = 0;
+    for (uint8_t i = 0; i < n; i++) code = (code << 5) | (uint32_t)(initials[i] - 'a' + 1);
+    return code;
+}
+
+/* sequential record reader over the dictionary file (uses an external buffer) */
+typedef struct {
+    zh_storage_t* st;
+    const __word_dict_info_t* info;
+    uint8_t* buf;               /* read buffer (must be larger than the longest record) */
+    uint16_t buf_sz;            /* size of read buffer */
+    const uint8_t* view;        /* bytes of records, buf or mapped file (no copy) */
+    uint16_t buf_len;           /* valid bytes in view */
+    uint16_t ptr;               /* location of next record in view */
+    uint32_t buf_pos;           /* file location of view[0] */
+    uint32_t key_idx;           /* index of next record */
+}__word_dict_cursor_t;
+
+uint32_t zh_word_dict_u32(const uint8_t* p);
+
+uint8_t zh_word_dict_info(zh_storage_t* st, __word_dict_info_t* info);
+uint32_t zh_word_dict_lower_bound(zh_storage_t* st, const __word_dict_info_t* info, const char* key, uint8_t len, uint32_t lo, uint32_t hi);
+uint32_t zh_word_dict_upper_bound(zh_storage_t* st, const __word_dict_info_t* info, const char* key, uint8_t len, uint32_t lo, uint32_t hi);
+
+uint8_t zh_word_dict_seek(__word_dict_cursor_t* cur, uint32_t key_idx);
+const uint8_t* zh_word_dict_next(__word_dict_cursor_t* cur);
+const uint8_t* zh_word_dict_record(__word_dict_cursor_t* cur, uint32_t key_idx);
+
+/* record accessors (rec is returned by zh_word_dict_next) */
+#define ZH_WORD_REC_KEY_LEN(rec)    ((rec)[0])
+#define ZH_WORD_REC_KEY(rec)        ((const char*)(rec) + 1)
+#define ZH_WORD_REC_WORD_NUM(rec)   ((rec)[1 + (rec)[0]])
+#define ZH_WORD_REC_WORDS(rec)      ((rec) + 2 + (rec)[0])
+
+/* word accessors (w starts at ZH_WORD_REC_WORDS, next word is at w + ZH_WORD_W_SIZE(w)) */
+#define ZH_WORD_W_LEN(w)            ((w)[0])
+#define ZH_WORD_W_WEIGHT(w)         ((w)[1])
+#define ZH_WORD_W_TEXT(w)           ((const char*)(w) + 2)
+#define ZH_WORD_W_SIZE(w)           (2 + (w)[0])
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_trie.c
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : syllable id double-array trie over word dictionary keys
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * matching a split method costs O(key length) transitions for precise
+ * pieces, and the size of id range for each vague piece, instead of
+ * comparing strings with every key of the dictionary region.
+ *****************************************************************************
+ */
+#include <string.h>
+#include "zh_word_trie.h"
+
+/************************   private functions   *********************************/
+
+/* read int32 array in little endian from file */
+static uint8_t read_i32_array(zh_storage_t* st, uint32_t loc, int32_t* arr, uint32_t num) {
+    uint8_t tmp[256];
+    for (uint32_t i = 0; i < num;) {
+        uint32_t n = num - i > sizeof(tmp) / 4 ? sizeof(tmp) / 4 : num - i;
+        if (zh_storage_read_at(st, loc + 4 * i, tmp, 4 * n) != 4 * n) return 1;
+        for (uint32_t j = 0; j < n; j++, i++) {
+            arr[i] = (int32_t)zh_word_dict_u32(tmp + 4 * j);
+        }
+    }
+    return 0;
+}
+
+/* get child state of s by code, -1 if not exist */
+static int32_t trie_child(const __word_trie_t* trie, int32_t s, uint16_t code) {
+    if (trie->base[s] <= 0) return -1;
+    uint32_t t = (uint32_t)trie->base[s] + code;
+    return (t < trie->size && trie->check[t] == s) ? (int32_t)t : -1;
+}
+
+/************************   public functions   *********************************/
+
+/**
+ * @brief read syllable table and trie of dictionary into RAM
+ * @param st    opened dictionary file
+ * @param info  dictionary information (read by zh_word_dict_info)
+ * @param trie  trie to fill, free it by zh_word_trie_free
+ * @return 0: success, 1: no trie in file or malloc failed
+ */
+uint8_t zh_word_trie_read(zh_storage_t* st, const __word_dict_info_t* info, __word_trie_t* trie) {
+    memset(trie, 0, sizeof(__word_trie_t));
+    if (info->trie_size == 0 || info->syl_num == 0) return 1;
+    trie->syl   = zh_buffer_malloc((size_t)info->syl_num * ZH_WORD_DICT_SYL_SZ);
+    trie->base  = zh_buffer_malloc((size_t)info->trie_size * sizeof(int32_t));
+    trie->check = zh_buffer_malloc((size_t)info->trie_size * sizeof(int32_t));
+    if (trie->syl == NULL || trie->base == NULL || trie->check == NULL) {
+        ZH_LOG_ERROR("zh_buffer_malloc failed");
+        zh_word_trie_free(trie);
+        return 1;
+    }
+    uint32_t syl_sz = info->syl_num * ZH_WORD_DICT_SYL_SZ;
+    if (zh_storage_read_at(st, info->syl_off, trie->syl, syl_sz) != syl_sz ||
+        read_i32_array(st, info->trie_off, trie->base, info->trie_size) ||
+        read_i32_array(st, info->trie_off + 4 * info->trie_size, trie->check, info->trie_size)) {
+        zh_word_trie_free(trie);
+        return 1;
+    }
+    trie->syl_num = info->syl_num;
+    trie->size = info->trie_size;
+    return 0;
+}
+
+/* free the trie read by zh_word_trie_read */
+void zh_word_trie_free(__word_trie_t* trie) {
+    if (trie->syl)   zh_buffer_free(trie->syl);
+    if (trie->base)  zh_buffer_free(trie->base);
+    if (trie->check) zh_buffer_free(trie->check);
+    memset(trie, 0, sizeof(__word_trie_t));
+}
+
+/**
+ * @brief get the syllable id range [lo, hi) of a pinyin piece
+ * @param piece pinyin piece (not need to be terminated)
+ * @param len   length of piece
+ * @param prec  1: the syllable must be the piece, 0: the syllable starts with piece
+ * @return 0: found, 1: no syllable match (lo == hi)
+ */
+uint8_t zh_word_trie_syl_range(const __word_trie_t* trie, const char* piece, uint8_t len, uint8_t prec, uint16_t* lo, uint16_t* hi) {
+    uint32_t l = 0, h = trie->syl_num;
+    while (l < h) {  /* first syllable >= piece */
+        uint32_t mid = (l + h) / 2;
+        if (strncmp(trie->syl[mid], piece, len) < 0) l = mid + 1;
+        else h = mid;
+    }
+    uint32_t e = l;
+    if (prec) {
+        if (e < trie->syl_num && strncmp(trie->syl[e], piece, len) == 0 && (len == ZH_WORD_DICT_SYL_SZ || trie->syl[e][len] == '\0')) e++;
+    }
+    else {
+        while (e < trie->syl_num && strncmp(trie->syl[e], piece, len) == 0) e++;
+    }
+    *lo = (uint16_t)(l + 1);
+    *hi = (uint16_t)(e + 1);
+    return l == e;
+}
+
+/**
+ * @brief start iterating the dictionary keys that match the split method of str
+ * @param it  iterator to fill, keys are got by zh_word_trie_next
+ * @return 0: success, 1: no syllable matches some piece (no key)
+ */
+uint8_t zh_word_trie_iter_init(const __word_trie_t* trie, const char* str, const __split_method_t* m, __word_trie_iter_t* it) {
+    uint8_t loc = 0;
+    it->length = 0;     /* no key until all pieces are found */
+    it->depth = 0;
+    it->state[0] = 0;
+    if (trie->base == NULL || m->length == 0 || m->length > MAX_WORD_LENGTH) return 1;
+    for (uint8_t i = 0; i < m->length; i++) {
+        uint8_t prec = (m->wt >> (MAX_WORD_LENGTH - 1 - i)) & 1;
+        if (zh_word_trie_syl_range(trie, str + loc, m->spm[i] - loc, prec, &it->lo[i], &it->hi[i])) return 1;
+        loc = m->spm[i];
+    }
+    it->length = m->length;
+    it->code[0] = it->lo[0];
+    return 0;
+}
+
+/**
+ * @brief get the next key of iterator (depth first walk, so keys are in increasing order)
+ * @param key  key index found
+ * @return 0: key found, 1: no more key
+ */
+uint8_t zh_word_trie_next(const __word_trie_t* trie, __word_trie_iter_t* it, uint32_t* key) {
+    if (it->length == 0) return 1;
+    for (;;) {
+        uint8_t d = it->depth;
+        if (d == it->length) {  /* all pieces walked, check the end of key */
+            int32_t t = trie_child(trie, it->state[d], 0);
+            it->depth--;
+            if (t >= 0) {
+                *key = (uint32_t)(-trie->base[t] - 1);
+                return 0;
+            }
+            continue;
+        }
+        if (it->code[d] >= it->hi[d]) {
+            if (d == 0) return 1;
+            it->depth--;
+            continue;
+        }
+        int32_t t = trie_child(trie, it->state[d], it->code[d]++);
+        if (t >= 0) {
+            it->depth++;
+            it->state[d + 1] = t;
+            if (d + 1 < it->length) it->code[d + 1] = it->lo[d + 1];
+        }
+    }
+}
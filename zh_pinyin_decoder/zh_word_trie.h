@@ -0,0 +1,62 @@
+/**
+ ***************************** Declaration ********************************
+ * @file           : zh_word_trie.h
+ * @author         : FriedParrot (https://github.com/FriedParrot)
+ * @version        : v1.0
+ * @date           : 2024-10-17  (last modified)
+ * @brief          : syllable id double-array trie over word dictionary keys
+ * @license        : MIT license (https://opensource.org/license/mit)
+ *****************************************************************************
+ * @attention
+ * this file is need when option USE_ZH_WORD_TRIE is set to 1. the trie is
+ * stored in "zh_word_dict.bin" (see zh_word_dict.h), and loaded into RAM
+ * by zh_word_trie_load(), which takes about 440kb RAM for default dictionary.
+ *
+ * a split method is matched by walking the trie : a precise piece is one
+ * syllable id, a vague piece is the id range of syllables with the piece as
+ * prefix (continuous since syllables are sorted). the keys are got one by
+ * one in increasing order by zh_word_trie_next(), so a search can stop at any
+ * key without a buffer of all the keys matched.
+ *****************************************************************************
+ */
+#ifndef __ZH_WORD_TRIE_H
+#define __ZH_WORD_TRIE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+#include "zh_pinyin_decoder.h"
+#include "zh_word_dict.h"
+
+typedef struct {
+    uint32_t syl_num;           /* number of syllables */
+    char     (*syl)[ZH_WORD_DICT_SYL_SZ];    /* sorted syllables */
+    uint32_t size;              /* number of double array units */
+    int32_t* base;              /* base array (end node : -(key index + 1)) */
+    int32_t* check;             /* check array (parent state, -1 if unit is free) */
+}__word_trie_t;
+
+/* keys of a split method, walked depth first */
+typedef struct {
+    uint16_t lo[MAX_WORD_LENGTH];       /* syllable id range of each piece */
+    uint16_t hi[MAX_WORD_LENGTH];
+    uint16_t code[MAX_WORD_LENGTH];     /* next syllable id to try at each depth */
+    int32_t  state[MAX_WORD_LENGTH + 1];  /* trie state at each depth */
+    uint8_t  length;                    /* number of pieces */
+    uint8_t  depth;                     /* current depth */
+}__word_trie_iter_t;
+
+uint8_t zh_word_trie_read(zh_storage_t* st, const __word_dict_info_t* info, __word_trie_t* trie);
+void zh_word_trie_free(__word_trie_t* trie);
+
+uint8_t zh_word_trie_syl_range(const __word_trie_t* trie, const char* piece, uint8_t len, uint8_t prec, uint16_t* lo, uint16_t* hi);
+uint8_t zh_word_trie_iter_init(const __word_trie_t* trie, const char* str, const __split_method_t* m, __word_trie_iter_t* it);
+uint8_t zh_word_trie_next(const __word_trie_t* trie, __word_trie_iter_t* it, uint32_t* key);
+
+#ifdef __cplusplus
+}
+#endif //
+
+#endif